@@ -0,0 +1,858 @@
+/****************************************************/
+/* File: analyze.c                                  */
+/* Semantic analyzer implementation                 */
+/* for the C-MINUS compiler                         */
+/* Compiler Construction: Principles and Practice   */
+/* Kenneth C. Louden                                */
+/****************************************************/
+
+#include <time.h>
+#include "globals.h"
+#include "util.h"
+#include "symtab.h"
+#include "frame.h"
+#include "callgraph.h"
+#include "symfile.h"
+#include "analyze.h"
+
+/* counter for variable memory locations */
+static int location = 0;
+
+/* number of semantic errors reported so far */
+static int errorCount = 0;
+
+/* CACHE_SIZE is the size of the hash table
+ * of top-level declarations kept between analyses
+ */
+#define CACHE_SIZE 4093
+
+/* a reference from a function body to a global
+ * name, with the signature the name had then
+ */
+typedef struct
+{
+    char * name;
+    int lineno;
+    unsigned long sig;
+} RefRec;
+
+/* What is remembered about a top-level declaration
+ * from one analysis to the next. For a function
+ * that is its scopes, the globals and callees it
+ * references, and a hash of its text, so an
+ * unchanged function is not checked again
+ */
+typedef struct DeclInfoRec
+{
+    char * name;
+    TreeNode * node; /* declaration kept across analyses */
+    unsigned long sig; /* hash of the declaration's interface */
+    unsigned long body; /* hash of a function's text */
+    int round; /* last analysis the name was declared in */
+    int dirty; /* function must be checked in this analysis */
+    int errors; /* errors were reported in the function */
+    Scope * scopes;
+    int nScopes, maxScopes;
+    RefRec * refs;
+    int nRefs, maxRefs;
+    struct DeclInfoRec * next;
+} * DeclInfo;
+
+static DeclInfo cache[CACHE_SIZE];
+
+/* number of the current analysis */
+static int analysisRound = 0;
+
+/* file scope of the current analysis */
+static Scope globalScope = NULL;
+
+/* function being analyzed and its cache record */
+static TreeNode * curFunc = NULL;
+static DeclInfo curInfo = NULL;
+
+/* declarations of the predefined functions
+ * int input(void) and void output(int x)
+ */
+static TreeNode * inputDecl = NULL;
+static TreeNode * outputDecl = NULL;
+
+/* Procedure traverse is a generic recursive
+ * syntax tree traversal routine:
+ * it applies preProc in preorder and postProc
+ * in postorder to tree pointed to by t
+ */
+static void traverse(TreeNode * t,
+                     void (* preProc) (TreeNode *),
+                     void (* postProc) (TreeNode *))
+{
+    if (t != NULL){
+        preProc(t);
+        for (int i = 0; i < MAXCHILDREN; i++)
+            traverse(t->child[i], preProc, postProc);
+        postProc(t);
+        traverse(t->sibling, preProc, postProc);
+    }
+}
+
+/* nullProc is a do-nothing procedure to
+ * generate preorder-only or postorder-only
+ * traversals from traverse
+ */
+static void nullProc(TreeNode * t)
+{
+    if (t == NULL) return;
+    else return;
+}
+
+static void semanticError(TreeNode * t, char * message)
+{
+    fprintf(listing, "Semantic error at line %d: %s: %s\n", t->lineno, message, t->attr.name);
+    errorCount++;
+    Error = TRUE;
+}
+
+static void typeError(TreeNode * t, char * message)
+{
+    fprintf(listing, "Type error at line %d: %s\n", t->lineno, message);
+    errorCount++;
+    Error = TRUE;
+}
+
+/* FNV-1a hashing of syntax trees; line numbers
+ * and analysis results are left out so that a
+ * function hashes the same wherever it moves
+ */
+#define FNV_OFFSET 14695981039346656037UL
+#define FNV_PRIME 1099511628211UL
+
+static unsigned long hashInt(unsigned long h, long v)
+{
+    return (h ^ (unsigned long)v) * FNV_PRIME;
+}
+
+static unsigned long hashString(unsigned long h, char * s)
+{
+    while (*s != '\0')
+        h = (h ^ (unsigned char)*s++) * FNV_PRIME;
+    return hashInt(h, 0);
+}
+
+static int isDecl(TreeNode * t)
+{
+    return t->nodekind == ExpK &&
+        (t->kind.exp == VarDeclK || t->kind.exp == ArrayDeclK || t->kind.exp == FuncDeclK);
+}
+
+static int hasName(TreeNode * t)
+{
+    if (t->nodekind == StmtK)
+        return t->kind.stmt == CallK;
+    return isDecl(t) || t->kind.exp == IdK;
+}
+
+static unsigned long hashTree(unsigned long h, TreeNode * t)
+{
+    while (t != NULL){
+        h = hashInt(h, t->nodekind);
+        h = hashInt(h, t->nodekind == StmtK ? t->kind.stmt : t->kind.exp);
+        if (hasName(t))
+            h = hashString(h, t->attr.name);
+        else if (t->nodekind == ExpK && t->kind.exp == OpK)
+            h = hashInt(h, t->attr.op);
+        else if (t->nodekind == ExpK && t->kind.exp == ConstK)
+            h = hashInt(h, t->attr.val);
+        if (isDecl(t)){
+            h = hashInt(h, t->type);
+            h = hashInt(h, t->size);
+            h = hashInt(h, t->isParam);
+        }
+        for (int i = 0; i < MAXCHILDREN; i++)
+            h = hashTree(hashInt(h, 'c' + i), t->child[i]);
+        h = hashInt(h, 's');
+        t = t->sibling;
+    }
+    return h;
+}
+
+static unsigned long functionHash(TreeNode * t)
+{
+    unsigned long h = hashInt(FNV_OFFSET, t->type);
+    h = hashTree(hashInt(h, 'p'), t->child[0]);
+    return hashTree(hashInt(h, 'b'), t->child[1]);
+}
+
+/* Procedure shiftLines moves the line numbers
+ * of a subtree by delta
+ */
+static void shiftLines(TreeNode * t, int delta)
+{
+    while (t != NULL){
+        t->lineno += delta;
+        for (int i = 0; i < MAXCHILDREN; i++)
+            shiftLines(t->child[i], delta);
+        t = t->sibling;
+    }
+}
+
+/* Function signature hashes what users of a
+ * global declaration depend on: its kind and
+ * type, the parameter list of a function and
+ * the size and location of a variable
+ */
+static unsigned long signature(TreeNode * t, int loc)
+{
+    unsigned long h = FNV_OFFSET;
+    h = hashInt(h, t->kind.exp);
+    h = hashInt(h, t->type);
+    if (t->kind.exp == FuncDeclK){
+        for (TreeNode * p = t->child[0]; p != NULL; p = p->sibling){
+            h = hashInt(h, p->kind.exp);
+            h = hashInt(h, p->type);
+        }
+    }
+    else {
+        h = hashInt(h, t->size);
+        h = hashInt(h, loc);
+    }
+    return h;
+}
+
+static int cacheHash(char * key)
+{
+    return (int)(hashString(FNV_OFFSET, key) % CACHE_SIZE);
+}
+
+static DeclInfo lookupInfo(char * name)
+{
+    DeclInfo l = cache[cacheHash(name)];
+    while ((l != NULL) && (strcmp(name, l->name) != 0))
+        l = l->next;
+    return l;
+}
+
+static DeclInfo newInfo(TreeNode * t)
+{
+    int h = cacheHash(t->attr.name);
+    DeclInfo l = (DeclInfo)calloc(1, sizeof(struct DeclInfoRec));
+    if (l == NULL){
+        fprintf(listing, "Out of memory error at line %d\n", lineno);
+        exit(-1);
+    }
+    l->name = copyString(t->attr.name);
+    l->node = t;
+    l->next = cache[h];
+    cache[h] = l;
+    return l;
+}
+
+/* Function infoOf returns the cache record of a
+ * top-level declaration, NULL for a duplicate
+ */
+static DeclInfo infoOf(TreeNode * t)
+{
+    DeclInfo l = lookupInfo(t->attr.name);
+    if (l != NULL && l->node == t)
+        return l;
+    return NULL;
+}
+
+/* Procedure forget releases what was learned
+ * about a function's body
+ */
+static void forget(DeclInfo l)
+{
+    for (int i = 0; i < l->nScopes; i++)
+        sc_free(l->scopes[i]);
+    l->nScopes = 0;
+    l->nRefs = 0;
+    l->errors = FALSE;
+}
+
+static void dropInfo(DeclInfo l)
+{
+    forget(l);
+    free(l->scopes);
+    free(l->refs);
+    free(l->name);
+    free(l);
+}
+
+static void addScope(DeclInfo l, Scope s)
+{
+    if (l->nScopes == l->maxScopes){
+        l->maxScopes = (l->maxScopes == 0) ? 4 : l->maxScopes * 2;
+        l->scopes = (Scope *)realloc(l->scopes, l->maxScopes * sizeof(Scope));
+    }
+    l->scopes[l->nScopes++] = s;
+}
+
+static void addRef(DeclInfo l, char * name, int lineno, unsigned long sig)
+{
+    if (l->nRefs == l->maxRefs){
+        l->maxRefs = (l->maxRefs == 0) ? 8 : l->maxRefs * 2;
+        l->refs = (RefRec *)realloc(l->refs, l->maxRefs * sizeof(RefRec));
+    }
+    l->refs[l->nRefs].name = name;
+    l->refs[l->nRefs].lineno = lineno;
+    l->refs[l->nRefs].sig = sig;
+    l->nRefs++;
+}
+
+static TreeNode * builtin(char * name, ExpType type, TreeNode * param)
+{
+    TreeNode * t = newExpNode(FuncDeclK);
+    t->attr.name = copyString(name);
+    t->type = type;
+    t->lineno = 0;
+    t->child[0] = param;
+    t->bind.storage = BuiltinK;
+    return t;
+}
+
+/* Procedure initBuiltins declares input and
+ * output, which live as long as the compiler
+ */
+static void initBuiltins(void)
+{
+    if (inputDecl == NULL){
+        TreeNode * x = newExpNode(VarDeclK);
+        x->attr.name = copyString("x");
+        x->type = Integer;
+        x->isParam = TRUE;
+        inputDecl = builtin("input", Integer, NULL);
+        outputDecl = builtin("output", Void, x);
+        newInfo(inputDecl)->sig = signature(inputDecl, -1);
+        newInfo(outputDecl)->sig = signature(outputDecl, -1);
+    }
+    infoOf(inputDecl)->round = analysisRound;
+    infoOf(outputDecl)->round = analysisRound;
+    st_insert(inputDecl->attr.name, 0, -1, inputDecl);
+    st_insert(outputDecl->attr.name, 0, -1, outputDecl);
+}
+
+static int isBuiltin(DeclInfo l)
+{
+    return l->node == inputDecl || l->node == outputDecl;
+}
+
+/* Procedure bindStorage records where the variable
+ * declared by t is stored
+ */
+static void bindStorage(TreeNode * t, StorageKind storage, int offset)
+{
+    t->bind.storage = storage;
+    t->bind.offset = offset;
+    t->bind.isArray = (t->kind.exp == ArrayDeclK);
+}
+
+static Scope openScope(void)
+{
+    Scope s = sc_new(curFunc->attr.name, sc_top());
+    addScope(curInfo, s);
+    sc_list(s);
+    sc_push(s);
+    return s;
+}
+
+/* Function importName declares in the file scope
+ * a name exported by an imported module
+ */
+static BucketList importName(char * name)
+{
+    TreeNode * d = sf_lookup(name);
+    Scope s = sc_top();
+    if (d == NULL)
+        return NULL;
+    sc_push(globalScope);
+    st_insert(d->attr.name, 0, (d->bind.storage == GlobalK) ? d->bind.offset : -1, d);
+    sc_push(s);
+    return st_lookup(name);
+}
+
+/* Procedure resolve binds an identifier or call
+ * to its declaration, copies the storage of a
+ * variable into the identifier and notes references
+ * to global names as dependencies of the function
+ */
+static void resolve(TreeNode * t)
+{
+    BucketList l = st_lookup(t->attr.name);
+    int isCall = (t->nodekind == StmtK);
+    t->decl = NULL;
+    t->bind.storage = UnboundK;
+    if (l == NULL)
+        l = importName(t->attr.name);
+    if (l == NULL)
+        semanticError(t, isCall ? "undeclared function" : "undeclared variable");
+    else if (isCall && l->node->kind.exp != FuncDeclK)
+        semanticError(t, "called object is not a function");
+    else if (!isCall && l->node->kind.exp == FuncDeclK)
+        semanticError(t, "function used as a variable");
+    /* the code of an imported function is in the
+     * library's program, not in this one
+     */
+    else if (isCall && l->node->lineno == 0 && l->node->bind.storage != BuiltinK)
+        semanticError(t, "imported function cannot be called");
+    else {
+        t->decl = l->node;
+        if (!isCall)
+            t->bind = l->node->bind;
+        st_add_lineno(l, t->lineno);
+        if (l->scope == globalScope){
+            DeclInfo g = lookupInfo(t->attr.name);
+            addRef(curInfo, t->attr.name, t->lineno, g == NULL ? 0 : g->sig);
+        }
+    }
+}
+
+/* Procedure insertNode inserts
+ * identifiers stored in t into
+ * the symbol table
+ */
+static void insertNode(TreeNode * t)
+{
+    switch (t->nodekind){
+        case StmtK:
+            switch (t->kind.stmt){
+                case CompoundStmtK:
+                    /* the body shares the scope of the parameters */
+                    if (t != curFunc->child[1])
+                        openScope();
+                    break;
+                case CallK:
+                    resolve(t);
+                    break;
+                default:
+                    break;
+            }
+            break;
+        case ExpK:
+            switch (t->kind.exp){
+                case VarDeclK:
+                case ArrayDeclK:
+                    if (t->type == Void)
+                        semanticError(t, "variable declared void");
+                    if (st_lookup_top(t->attr.name) != NULL)
+                        semanticError(t, "redefinition");
+                    else if (t->kind.exp == ArrayDeclK && !t->isParam){
+                        /* element i is at fp-memloc+i */
+                        st_insert(t->attr.name, t->lineno, location + t->size - 1, t);
+                        bindStorage(t, LocalK, -(location + t->size - 1));
+                        location += t->size;
+                    }
+                    else {
+                        st_insert(t->attr.name, t->lineno, location, t);
+                        bindStorage(t, t->isParam ? ParamK : LocalK, -location);
+                        location++;
+                    }
+                    break;
+                case IdK:
+                    resolve(t);
+                    break;
+                default:
+                    break;
+            }
+            break;
+        default:
+            break;
+    }
+}
+
+static void afterInsertNode(TreeNode * t)
+{
+    if (t->nodekind == StmtK && t->kind.stmt == CompoundStmtK && t != curFunc->child[1])
+        sc_pop();
+}
+
+/* Procedure buildFunction enters the parameters
+ * and locals of a function into new scopes and
+ * resolves every name used in its body
+ */
+static void buildFunction(TreeNode * t, DeclInfo info)
+{
+    int errorsBefore = errorCount;
+    forget(info);
+    curFunc = t;
+    curInfo = info;
+    openScope();
+    location = FRAME_HEADER;
+    traverse(t->child[0], insertNode, nullProc);
+    traverse(t->child[1], insertNode, afterInsertNode);
+    sc_pop();
+    /* slots are shared once the live ranges are known */
+    t->size = layoutFrame(t);
+    for (int i = 0; i < info->nScopes; i++)
+        sc_relocate(info->scopes[i]);
+    info->errors = (errorCount != errorsBefore);
+}
+
+/* Function depsValid tells whether every global
+ * a cached function referenced is still declared
+ * before it with the same signature
+ */
+static int depsValid(DeclInfo info)
+{
+    if (info->errors)
+        return FALSE;
+    for (int i = 0; i < info->nRefs; i++){
+        BucketList l = st_lookup(info->refs[i].name);
+        DeclInfo g;
+        if (l == NULL)
+            return FALSE;
+        g = lookupInfo(info->refs[i].name);
+        if (g == NULL || g->node != l->node || g->sig != info->refs[i].sig)
+            return FALSE;
+    }
+    return TRUE;
+}
+
+/* Procedure globalPass builds the file scope in
+ * declaration order, analyzing each function when
+ * it is reached so it sees only earlier globals
+ */
+static void globalPass(TreeNode * syntaxTree)
+{
+    sc_clear();
+    if (globalScope == NULL)
+        globalScope = sc_new("global", NULL);
+    else
+        sc_empty(globalScope);
+    sc_list(globalScope);
+    sc_push(globalScope);
+    initBuiltins();
+    /* globals follow those of imported modules */
+    location = sf_dataEnd();
+    for (TreeNode * t = syntaxTree; t != NULL; t = t->sibling){
+        DeclInfo info = infoOf(t);
+        if (st_lookup_top(t->attr.name) != NULL){
+            semanticError(t, "redefinition");
+            continue;
+        }
+        if (t->kind.exp == FuncDeclK){
+            st_insert(t->attr.name, t->lineno, -1, t);
+            t->bind.storage = FuncK;
+            if (info == NULL)
+                continue;
+            info->sig = signature(t, -1);
+            if (!info->dirty && depsValid(info)){
+                /* reuse the cached analysis */
+                for (int i = 0; i < info->nRefs; i++)
+                    st_add_lineno(st_lookup(info->refs[i].name), info->refs[i].lineno);
+                info->scopes[0]->parent = globalScope;
+                for (int i = 0; i < info->nScopes; i++)
+                    sc_list(info->scopes[i]);
+            }
+            else {
+                info->dirty = TRUE;
+                buildFunction(t, info);
+            }
+        }
+        else {
+            if (t->type == Void)
+                semanticError(t, "variable declared void");
+            st_insert(t->attr.name, t->lineno, location, t);
+            bindStorage(t, GlobalK, location);
+            if (info != NULL)
+                info->sig = signature(t, location);
+            location += (t->kind.exp == ArrayDeclK) ? t->size : 1;
+        }
+    }
+}
+
+/* Function merge matches a declaration of a new
+ * parse with what the cache knows about its name
+ * and returns the node to keep in the tree
+ */
+static TreeNode * merge(TreeNode * t)
+{
+    DeclInfo info = lookupInfo(t->attr.name);
+    TreeNode * old;
+    if (info == NULL){
+        info = newInfo(t);
+        info->round = analysisRound;
+        info->dirty = TRUE;
+        if (t->kind.exp == FuncDeclK)
+            info->body = functionHash(t);
+        return t;
+    }
+    if (info->round == analysisRound || isBuiltin(info))
+        return t; /* redefinition, reported by globalPass */
+    info->round = analysisRound;
+    old = info->node;
+    if (old->kind.exp != t->kind.exp){
+        forget(info);
+        old->sibling = NULL;
+        freeTree(old);
+        info->node = t;
+        info->dirty = TRUE;
+        if (t->kind.exp == FuncDeclK)
+            info->body = functionHash(t);
+        return t;
+    }
+    if (t->kind.exp == FuncDeclK){
+        unsigned long body = functionHash(t);
+        if (body == info->body && !info->errors){
+            int delta = t->lineno - old->lineno;
+            if (delta != 0){
+                shiftLines(old->child[0], delta);
+                shiftLines(old->child[1], delta);
+                for (int i = 0; i < info->nRefs; i++)
+                    info->refs[i].lineno += delta;
+                for (int i = 0; i < info->nScopes; i++)
+                    sc_shift_lines(info->scopes[i], delta);
+            }
+            info->dirty = FALSE;
+        }
+        else {
+            /* keep the node, callers point at it */
+            forget(info);
+            for (int i = 0; i < MAXCHILDREN; i++){
+                freeTree(old->child[i]);
+                old->child[i] = t->child[i];
+                t->child[i] = NULL;
+            }
+            old->type = t->type;
+            info->body = body;
+            info->dirty = TRUE;
+        }
+    }
+    else {
+        old->type = t->type;
+        old->size = t->size;
+    }
+    old->lineno = t->lineno;
+    freeTree(t);
+    return old;
+}
+
+/* Procedure dropStale forgets declarations that
+ * are gone from the program, with their trees
+ */
+static void dropStale(void)
+{
+    for (int i = 0; i < CACHE_SIZE; i++){
+        DeclInfo * p = &cache[i];
+        while (*p != NULL){
+            DeclInfo l = *p;
+            if (l->round != analysisRound && !isBuiltin(l)){
+                *p = l->next;
+                l->node->sibling = NULL;
+                freeTree(l->node);
+                dropInfo(l);
+            }
+            else
+                p = &l->next;
+        }
+    }
+}
+
+/* Procedure clearCache forgets the previous
+ * program; its tree belongs to the caller
+ */
+static void clearCache(void)
+{
+    for (int i = 0; i < CACHE_SIZE; i++){
+        DeclInfo * p = &cache[i];
+        while (*p != NULL){
+            DeclInfo l = *p;
+            if (!isBuiltin(l)){
+                *p = l->next;
+                dropInfo(l);
+            }
+            else
+                p = &l->next;
+        }
+    }
+}
+
+/* Function buildSymtab constructs the symbol
+ * table by preorder traversal of the syntax tree
+ */
+void buildSymtab(TreeNode * syntaxTree)
+{
+    clearCache();
+    analysisRound++;
+    for (TreeNode * t = syntaxTree; t != NULL; t = t->sibling)
+        merge(t);
+    globalPass(syntaxTree);
+    if (TraceAnalyze){
+        fprintf(listing, "\nSymbol table:\n");
+        printSymTab(listing);
+    }
+}
+
+/* Procedure checkNode performs
+ * type checking at a single tree node
+ */
+static void checkNode(TreeNode * t)
+{
+    switch (t->nodekind){
+        case StmtK:
+            switch (t->kind.stmt){
+                case SelectionStmtK:
+                    if (t->child[0]->type != Integer)
+                        typeError(t->child[0], "if test is not integer");
+                    break;
+                case IterationStmtK:
+                    if (t->child[0]->type != Integer)
+                        typeError(t->child[0], "while test is not integer");
+                    break;
+                case ReturnStmtK:
+                    if (curFunc->type == Void && t->child[0] != NULL)
+                        typeError(t, "return with a value in void function");
+                    else if (curFunc->type == Integer && t->child[0] == NULL)
+                        typeError(t, "return without a value in int function");
+                    else if (t->child[0] != NULL && t->child[0]->type != Integer)
+                        typeError(t->child[0], "return of non-integer value");
+                    break;
+                case SimpleStmtK:
+                case AdditiveStmtK:
+                case TermK:
+                    if ((t->child[0]->type != Integer) ||
+                        (t->child[2]->type != Integer))
+                        typeError(t, "Op applied to non-integer");
+                    t->type = Integer;
+                    break;
+                case CallK:
+                    if (t->decl != NULL){
+                        TreeNode * p = t->decl->child[0];
+                        TreeNode * a = t->child[0];
+                        while (p != NULL && a != NULL){
+                            ExpType expected = (p->kind.exp == ArrayDeclK) ? IntegerArray : Integer;
+                            if (a->type != expected)
+                                typeError(a, "argument type mismatch");
+                            p = p->sibling;
+                            a = a->sibling;
+                        }
+                        if (p != NULL || a != NULL)
+                            typeError(t, "wrong number of arguments");
+                        t->type = t->decl->type;
+                    }
+                    else
+                        t->type = Integer;
+                    break;
+                default:
+                    break;
+            }
+            break;
+        case ExpK:
+            switch (t->kind.exp){
+                case AssignK:
+                    if (t->child[0]->type != Integer)
+                        typeError(t->child[0], "assignment to non-integer variable");
+                    else if (t->child[1]->type != Integer)
+                        typeError(t->child[1], "assignment of non-integer value");
+                    t->type = Integer;
+                    break;
+                case IdK:
+                    if (t->decl == NULL)
+                        t->type = Integer;
+                    else if (t->decl->kind.exp == ArrayDeclK){
+                        if (t->child[0] == NULL)
+                            t->type = IntegerArray;
+                        else {
+                            if (t->child[0]->type != Integer)
+                                typeError(t->child[0], "array index is not integer");
+                            t->type = Integer;
+                        }
+                    }
+                    else {
+                        if (t->child[0] != NULL)
+                            typeError(t, "index applied to non-array");
+                        t->type = t->decl->type;
+                    }
+                    break;
+                case ConstK:
+                    t->type = Integer;
+                    break;
+                default:
+                    break;
+            }
+            break;
+        default:
+            break;
+    }
+}
+
+/* Procedure checkFunction type checks the body
+ * of a function analyzed by buildFunction
+ */
+static void checkFunction(TreeNode * t, DeclInfo info)
+{
+    int errorsBefore = errorCount;
+    curFunc = t;
+    traverse(t->child[1], nullProc, checkNode);
+    if (errorCount != errorsBefore)
+        info->errors = TRUE;
+    info->dirty = FALSE;
+}
+
+/* Procedure typeCheck performs type checking
+ * by a postorder syntax tree traversal
+ */
+void typeCheck(TreeNode * syntaxTree)
+{
+    BucketList l;
+    for (TreeNode * t = syntaxTree; t != NULL; t = t->sibling){
+        DeclInfo info;
+        if (t->kind.exp != FuncDeclK)
+            continue;
+        info = infoOf(t);
+        if (info != NULL && info->dirty)
+            checkFunction(t, info);
+    }
+    buildCallGraph(syntaxTree);
+    l = st_lookup("main");
+    if (!Library && (l == NULL || l->node->kind.exp != FuncDeclK)){
+        fprintf(listing, "Semantic error: main function is not declared\n");
+        errorCount++;
+        Error = TRUE;
+    }
+}
+
+/* Function reanalyze repeats buildSymtab and
+ * typeCheck for a new parse of the program last
+ * analyzed. Only functions whose body changed or
+ * whose globals and callees changed signature are
+ * checked again; declarations that did not change
+ * are carried over from the previous tree, so the
+ * returned tree replaces both trees
+ */
+TreeNode * reanalyze(TreeNode * syntaxTree)
+{
+    clock_t start = clock(), elapsed;
+    TreeNode * head = NULL, * last = NULL;
+    int functions = 0, checked = 0;
+    analysisRound++;
+    while (syntaxTree != NULL){
+        TreeNode * next = syntaxTree->sibling;
+        TreeNode * t;
+        syntaxTree->sibling = NULL;
+        t = merge(syntaxTree);
+        if (head == NULL)
+            head = t;
+        else
+            last->sibling = t;
+        last = t;
+        syntaxTree = next;
+    }
+    dropStale();
+    globalPass(head);
+    for (TreeNode * t = head; t != NULL; t = t->sibling){
+        DeclInfo info = infoOf(t);
+        if (t->kind.exp != FuncDeclK || info == NULL)
+            continue;
+        functions++;
+        if (info->dirty)
+            checked++;
+    }
+    typeCheck(head);
+    elapsed = clock() - start;
+    if (TraceAnalyze){
+        fprintf(listing, "\nSymbol table:\n");
+        printSymTab(listing);
+    }
+    fprintf(listing, "\nRe-analysis: %d of %d functions checked in %.3f ms\n",
+            checked, functions, 1000.0 * elapsed / CLOCKS_PER_SEC);
+    return head;
+}
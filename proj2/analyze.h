@@ -0,0 +1,31 @@
+/****************************************************/
+/* File: analyze.h                                  */
+/* Semantic analyzer interface for C-MINUS compiler */
+/* Compiler Construction: Principles and Practice   */
+/* Kenneth C. Louden                                */
+/****************************************************/
+
+#ifndef _ANALYZE_H_
+#define _ANALYZE_H_
+
+/* Function buildSymtab constructs the symbol
+ * table by preorder traversal of the syntax tree
+ */
+void buildSymtab(TreeNode *);
+
+/* Procedure typeCheck performs type checking
+ * by a postorder syntax tree traversal
+ */
+void typeCheck(TreeNode *);
+
+/* Function reanalyze repeats buildSymtab and
+ * typeCheck for a new parse of the program last
+ * analyzed. Only functions whose body changed or
+ * whose globals and callees changed signature are
+ * checked again; declarations that did not change
+ * are carried over from the previous tree, so the
+ * returned tree replaces both trees
+ */
+TreeNode * reanalyze(TreeNode *);
+
+#endif
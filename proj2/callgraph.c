@@ -0,0 +1,194 @@
+/****************************************************/
+/* File: callgraph.c                                */
+/* Call graph of the C-MINUS compiler               */
+/* Strongly connected components are found by       */
+/* Tarjan's algorithm                               */
+/* Compiler Construction: Principles and Practice   */
+/* Kenneth C. Louden                                */
+/****************************************************/
+
+#include "globals.h"
+#include "callgraph.h"
+
+/* a function of the program and the functions
+ * it calls, as indices into funcs
+ */
+typedef struct
+{
+    TreeNode * node;
+    int * callees;
+    int nCallees, maxCallees;
+    int index, lowlink; /* Tarjan numbering, index < 0 unvisited */
+    int onStack;
+    int dynamic; /* needs a frame on the stack */
+    int callsImported; /* calls an imported function with a stack frame */
+} FuncRec;
+
+static FuncRec * funcs = NULL;
+static int nFuncs = 0;
+static int maxFuncs = 0;
+
+static int * stack = NULL;
+static int sp = 0;
+static int counter = 0;
+
+/* numbers of recursive components and of
+ * functions given static frames, for tracing
+ */
+static int nRecursive = 0;
+static int nStatic = 0;
+
+/* user functions are bound by globalPass of the
+ * analyzer, redefinitions and builtins are not
+ */
+static int isFunction(TreeNode * t)
+{
+    return t != NULL && t->nodekind == ExpK && t->kind.exp == FuncDeclK &&
+        (t->bind.storage == FuncK || t->bind.storage == StaticFuncK);
+}
+
+static void addFunc(TreeNode * t)
+{
+    if (nFuncs == maxFuncs){
+        maxFuncs = (maxFuncs == 0) ? 64 : maxFuncs * 2;
+        funcs = (FuncRec *)realloc(funcs, maxFuncs * sizeof(FuncRec));
+        stack = (int *)realloc(stack, maxFuncs * sizeof(int));
+        if (funcs == NULL || stack == NULL){
+            fprintf(listing, "Out of memory error at line %d\n", lineno);
+            exit(-1);
+        }
+    }
+    /* while the graph is built the offset of a
+     * function holds its index in funcs
+     */
+    t->bind.offset = nFuncs;
+    funcs[nFuncs].node = t;
+    funcs[nFuncs].callees = NULL;
+    funcs[nFuncs].nCallees = 0;
+    funcs[nFuncs].maxCallees = 0;
+    funcs[nFuncs].index = -1;
+    funcs[nFuncs].onStack = FALSE;
+    funcs[nFuncs].dynamic = FALSE;
+    funcs[nFuncs].callsImported = FALSE;
+    nFuncs++;
+}
+
+static void addEdge(FuncRec * f, int callee)
+{
+    if (f->nCallees == f->maxCallees){
+        f->maxCallees = (f->maxCallees == 0) ? 4 : f->maxCallees * 2;
+        f->callees = (int *)realloc(f->callees, f->maxCallees * sizeof(int));
+    }
+    f->callees[f->nCallees++] = callee;
+}
+
+/* Procedure findCalls adds an edge for every
+ * call in a subtree. Functions imported from a
+ * symbol file have no line; they are not in the
+ * graph and cannot call back
+ */
+static void findCalls(FuncRec * f, TreeNode * t)
+{
+    while (t != NULL){
+        if (t->nodekind == StmtK && t->kind.stmt == CallK && isFunction(t->decl)){
+            if (t->decl->lineno > 0)
+                addEdge(f, t->decl->bind.offset);
+            else if (t->decl->bind.storage == FuncK)
+                f->callsImported = TRUE;
+        }
+        for (int i = 0; i < MAXCHILDREN; i++)
+            findCalls(f, t->child[i]);
+        t = t->sibling;
+    }
+}
+
+/* Procedure strongConnect visits function v; a
+ * component is complete when v is its root.
+ * Components are found callees first, so whether
+ * a callee needs a stack frame is already known
+ */
+static void strongConnect(int v)
+{
+    FuncRec * f = &funcs[v];
+    int recursive = FALSE, dynamic = FALSE;
+    f->index = f->lowlink = counter++;
+    stack[sp++] = v;
+    f->onStack = TRUE;
+    for (int i = 0; i < f->nCallees; i++){
+        FuncRec * g = &funcs[f->callees[i]];
+        if (g->index < 0){
+            strongConnect(f->callees[i]);
+            if (g->lowlink < f->lowlink)
+                f->lowlink = g->lowlink;
+        }
+        else if (g->onStack && g->index < f->lowlink)
+            f->lowlink = g->index;
+        if (f->callees[i] == v)
+            recursive = TRUE;
+    }
+    if (f->lowlink == f->index){
+        int first = sp;
+        do
+            first--;
+        while (stack[first] != v);
+        if (sp - first > 1)
+            recursive = TRUE;
+        for (int k = first; k < sp && !recursive && !dynamic; k++){
+            FuncRec * g = &funcs[stack[k]];
+            dynamic = g->callsImported;
+            for (int i = 0; i < g->nCallees; i++)
+                if (funcs[g->callees[i]].dynamic)
+                    dynamic = TRUE;
+        }
+        if (recursive){
+            nRecursive++;
+            if (TraceAnalyze){
+                fprintf(listing, "Recursive:");
+                for (int k = first; k < sp; k++)
+                    fprintf(listing, " %s", funcs[stack[k]].node->attr.name);
+                fprintf(listing, "\n");
+            }
+        }
+        for (int k = first; k < sp; k++){
+            FuncRec * g = &funcs[stack[k]];
+            g->onStack = FALSE;
+            g->dynamic = recursive || dynamic;
+            if (!g->dynamic)
+                nStatic++;
+        }
+        sp = first;
+    }
+}
+
+/* Procedure buildCallGraph finds the strongly
+ * connected components of the call graph of the
+ * program. A function that is not recursive and
+ * calls only such functions is marked StaticFuncK,
+ * every other function FuncK
+ */
+void buildCallGraph(TreeNode * syntaxTree)
+{
+    nFuncs = 0;
+    sp = 0;
+    counter = 0;
+    nRecursive = 0;
+    nStatic = 0;
+    for (TreeNode * t = syntaxTree; t != NULL; t = t->sibling)
+        if (isFunction(t))
+            addFunc(t);
+    for (int v = 0; v < nFuncs; v++)
+        findCalls(&funcs[v], funcs[v].node->child[1]);
+    if (TraceAnalyze)
+        fprintf(listing, "\nCall graph:\n");
+    for (int v = 0; v < nFuncs; v++)
+        if (funcs[v].index < 0)
+            strongConnect(v);
+    for (int v = 0; v < nFuncs; v++){
+        funcs[v].node->bind.storage = funcs[v].dynamic ? FuncK : StaticFuncK;
+        funcs[v].node->bind.offset = 0;
+        free(funcs[v].callees);
+    }
+    if (TraceAnalyze)
+        fprintf(listing, "%d functions, %d recursive components, %d static frames\n",
+                nFuncs, nRecursive, nStatic);
+}
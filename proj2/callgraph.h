@@ -0,0 +1,19 @@
+/****************************************************/
+/* File: callgraph.h                                */
+/* Call graph interface for the C-MINUS compiler    */
+/* Compiler Construction: Principles and Practice   */
+/* Kenneth C. Louden                                */
+/****************************************************/
+
+#ifndef _CALLGRAPH_H_
+#define _CALLGRAPH_H_
+
+/* Procedure buildCallGraph finds the strongly
+ * connected components of the call graph of the
+ * program. A function that is not recursive and
+ * calls only such functions is marked StaticFuncK,
+ * every other function FuncK
+ */
+void buildCallGraph(TreeNode * syntaxTree);
+
+#endif
@@ -0,0 +1,937 @@
+/****************************************************/
+/* File: cgen.c                                     */
+/* The code generator implementation                */
+/* for the C-MINUS compiler                         */
+/* (generates code for the TM machine)              */
+/* Compiler Construction: Principles and Practice   */
+/* Kenneth C. Louden                                */
+/****************************************************/
+
+#include "globals.h"
+#include "symtab.h"
+#include "code.h"
+#include "cgen.h"
+#include "symfile.h"
+#include "irgen.h"
+
+/* tmpOffset is the offset from fp of the next
+ * free temporary; temps live below the locals of
+ * the current frame. It is decremented each time
+ * a temp is stored, and incremented when loaded again
+ */
+static int tmpOffset = 0;
+
+/* frame of the function being generated: slot k
+ * is at frameBias-k from frameReg, which is fp for
+ * a frame on the stack and gp for a static frame
+ */
+static int frameReg = fp;
+static int frameBias = 0;
+
+/* atTail is set while generating statements the
+ * function returns right after
+ */
+static int atTail = FALSE;
+
+/* prototypes for internal recursive code generator */
+static void genNode(TreeNode * tree);
+static void cGen(TreeNode * tree);
+
+/* Function baseReg returns the register the
+ * offset of a binding is relative to
+ */
+static int baseReg(Binding * b)
+{
+    return (b->storage == GlobalK) ? gp : frameReg;
+}
+
+/* Function baseOffset returns the offset of a
+ * binding from baseReg
+ */
+static int baseOffset(Binding * b)
+{
+    return (b->storage == GlobalK) ? b->offset : frameBias + b->offset;
+}
+
+/* Procedures pushTemp and popTemp store ac in a
+ * new temp and load the last temp into register r
+ */
+static void pushTemp(char * c)
+{
+    emitRM("ST", ac, frameBias + tmpOffset--, frameReg, c);
+}
+
+static void popTemp(int r, char * c)
+{
+    emitRM("LD", r, frameBias + ++tmpOffset, frameReg, c);
+}
+
+/* Procedure genArrayBase generates code to put
+ * the address of element 0 of array variable
+ * tree in register r
+ */
+static void genArrayBase(TreeNode * tree, int r)
+{
+    Binding * b = &tree->bind;
+    if (b->storage == ParamK)
+        emitRM("LD", r, baseOffset(b), baseReg(b), "load array param address");
+    else
+        emitRM("LDA", r, baseOffset(b), baseReg(b), "load array address");
+}
+
+/* Procedure genElement generates code to put the
+ * address of the indexed array element tree in ac
+ */
+static void genElement(TreeNode * tree)
+{
+    genNode(tree->child[0]);
+    genArrayBase(tree, ac1);
+    emitRO("ADD", ac, ac1, ac, "element address");
+}
+
+/* Function constIndex tells whether tree is an
+ * array element with a constant index, whose
+ * address is a displacement from the base
+ */
+static int constIndex(TreeNode * tree)
+{
+    TreeNode * i = tree->child[0];
+    return i != NULL && i->nodekind == ExpK && i->kind.exp == ConstK;
+}
+
+/* Function constOperand returns the constant
+ * operand of a + or - the LDA displacement can
+ * add, setting other to the other operand, or
+ * NULL if there is none
+ */
+static TreeNode * constOperand(TreeNode * tree, TreeNode ** other)
+{
+    TreeNode * l = tree->child[0], * r = tree->child[2];
+    TokenType op = tree->child[1]->attr.op;
+    if (op != PLUS && op != MINUS)
+        return NULL;
+    if (r->nodekind == ExpK && r->kind.exp == ConstK){
+        *other = l;
+        return r;
+    }
+    if (op == PLUS && l->nodekind == ExpK && l->kind.exp == ConstK){
+        *other = r;
+        return l;
+    }
+    return NULL;
+}
+
+/* Function reducedOperand returns the constant
+ * operand of a * or / done by shifts and adds,
+ * setting other to the other operand, or NULL if
+ * there is none
+ */
+static TreeNode * reducedOperand(TreeNode * tree, TreeNode ** other)
+{
+    TreeNode * l = tree->child[0], * r = tree->child[2];
+    TokenType op = tree->child[1]->attr.op;
+    if (r->nodekind == ExpK && r->kind.exp == ConstK && reducible(op, r->attr.val)){
+        *other = l;
+        return r;
+    }
+    if (op == TIMES && l->nodekind == ExpK && l->kind.exp == ConstK &&
+        reducible(op, l->attr.val)){
+        *other = r;
+        return l;
+    }
+    return NULL;
+}
+
+/* Procedure genReturn generates code to leave
+ * the current function, value in ac
+ */
+static void genReturn(void)
+{
+    if (frameReg == gp){
+        emitRM("LD", pc, frameBias - RET_SLOT, gp, "return");
+        return;
+    }
+    emitRM("LD", ac1, -RET_SLOT, fp, "load return address");
+    emitRM("LD", fp, -OFP_SLOT, fp, "restore caller fp");
+    emitRM("LDA", pc, 0, ac1, "return");
+}
+
+/* Function hasCall tells whether a subtree
+ * contains a call of a user function
+ */
+static int hasCall(TreeNode * tree)
+{
+    while (tree != NULL){
+        if (tree->nodekind == StmtK && tree->kind.stmt == CallK &&
+            tree->decl->bind.storage != BuiltinK)
+            return TRUE;
+        for (int i = 0; i < MAXCHILDREN; i++)
+            if (hasCall(tree->child[i]))
+                return TRUE;
+        tree = tree->sibling;
+    }
+    return FALSE;
+}
+
+/* Procedure genStaticArgs stores the arguments of
+ * a call of a function with a static frame. They
+ * go straight into its frame unless evaluating
+ * them calls functions, whose frames may overlap it
+ */
+static void genStaticArgs(TreeNode * tree)
+{
+    TreeNode * f = tree->decl;
+    TreeNode * a;
+    int top = f->bind.frame;
+    int n = 0;
+    if (hasCall(tree->child[0])){
+        for (a = tree->child[0]; a != NULL; a = a->sibling){
+            genNode(a);
+            pushTemp("call: push argument");
+            n++;
+        }
+        while (n-- > 0){
+            popTemp(ac, "call: pop argument");
+            emitRM("ST", ac, top - FRAME_HEADER - n, gp, "call: store argument");
+        }
+    }
+    else {
+        for (a = tree->child[0]; a != NULL; a = a->sibling){
+            genNode(a);
+            emitRM("ST", ac, top - FRAME_HEADER - n, gp, "call: store argument");
+            n++;
+        }
+    }
+}
+
+/* Procedure genStaticCall generates a call of a
+ * function with a static frame
+ */
+static void genStaticCall(TreeNode * tree)
+{
+    TreeNode * f = tree->decl;
+    int top = f->bind.frame;
+    genStaticArgs(tree);
+    emitRM("LDA", ac, 2, pc, "call: return address");
+    emitRM("ST", ac, top - RET_SLOT, gp, "call: store return address");
+    emitCallNote(emitSkip(0), tree->lineno, tree->site, f->attr.name);
+    emitRM("LDC", pc, f->bind.offset, 0, "call: jump to function");
+}
+
+/* Procedure genVector generates code for a call
+ * of a vector op: the arguments are the arrays
+ * and values it works on, then the first and the
+ * end of the range of elements. The address of
+ * the first element written goes into ac1, the
+ * other operands into registers 2 and 3, which
+ * are otherwise unused; values are computed first
+ */
+static void genVector(TreeNode * tree)
+{
+    static int regs[] = { ac1, 2, 3 };
+    TreeNode * p, * a, * from, * to;
+    int r[3] = { 0, 0, 0 }, k;
+    for (p = tree->decl->child[0], a = tree->child[0], k = 0; p->sibling->sibling != NULL;
+         p = p->sibling, a = a->sibling, k++){
+        r[k] = regs[k];
+        if (p->kind.exp != ArrayDeclK){
+            genNode(a);
+            emitRM("LDA", r[k], 0, ac, "vector: value");
+        }
+    }
+    from = a;
+    to = a->sibling;
+    genNode(to);
+    pushTemp("vector: save end");
+    genNode(from);
+    popTemp(ac1, "vector: load end");
+    emitRO("SUB", ac1, ac1, ac, "vector: length");
+    emitRO("VSET", ac1, 0, 0, "vector: set length");
+    for (p = tree->decl->child[0], a = tree->child[0], k = 0; a != from;
+         p = p->sibling, a = a->sibling, k++)
+        if (p->kind.exp == ArrayDeclK){
+            genArrayBase(a, r[k]);
+            emitRO("ADD", r[k], r[k], ac, "vector: first element");
+        }
+    emitRO(tree->decl->attr.name, r[0], r[1], r[2], "vector op");
+}
+
+/* Procedure genCall generates code for a call,
+ * leaving the returned value in ac. The frame of
+ * a recursive callee starts at the first free
+ * temp, its arguments are stored straight into
+ * its parameter slots
+ */
+static void genCall(TreeNode * tree)
+{
+    TreeNode * f = tree->decl;
+    TreeNode * a;
+    int base = tmpOffset;
+    int n = 0;
+    if (f->bind.storage == BuiltinK){
+        if (tree->child[0] == NULL)
+            emitRO("IN", ac, 0, 0, "input integer value");
+        else {
+            genNode(tree->child[0]);
+            emitRO("OUT", ac, 0, 0, "output ac");
+        }
+        return;
+    }
+    if (f->bind.storage == StaticFuncK){
+        genStaticCall(tree);
+        return;
+    }
+    if (f->bind.storage == VectorK){
+        genVector(tree);
+        return;
+    }
+    /* only functions with a frame on the stack
+     * call these, so frameReg is fp
+     */
+    for (a = tree->child[0]; a != NULL; a = a->sibling)
+        n++;
+    tmpOffset = base - FRAME_HEADER - n;
+    n = 0;
+    for (a = tree->child[0]; a != NULL; a = a->sibling){
+        genNode(a);
+        emitRM("ST", ac, base - FRAME_HEADER - n, fp, "call: store argument");
+        n++;
+    }
+    tmpOffset = base;
+    emitRM("ST", fp, base - OFP_SLOT, fp, "call: store caller fp");
+    emitRM("LDA", fp, base, fp, "call: push frame");
+    emitRM("LDA", ac, 2, pc, "call: return address");
+    emitRM("ST", ac, -RET_SLOT, fp, "call: store return address");
+    emitCallNote(emitSkip(0), tree->lineno, tree->site, f->attr.name);
+    emitRM("LDC", pc, f->bind.offset, 0, "call: jump to function");
+}
+
+/* Function readsSlots tells whether a subtree
+ * reads a variable of the frame in slots first to
+ * first + n - 1
+ */
+static int readsSlots(TreeNode * tree, int first, int n)
+{
+    while (tree != NULL){
+        if (tree->nodekind == ExpK && tree->kind.exp == IdK &&
+            (tree->bind.storage == LocalK || tree->bind.storage == ParamK)){
+            int high = -tree->bind.offset, low = high;
+            /* element i of a local array is at fp-memloc+i */
+            if (tree->bind.storage == LocalK && tree->bind.isArray)
+                low = high - tree->decl->size + 1;
+            if (low < first + n && high >= first)
+                return TRUE;
+        }
+        for (int i = 0; i < MAXCHILDREN; i++)
+            if (readsSlots(tree->child[i], first, n))
+                return TRUE;
+        tree = tree->sibling;
+    }
+    return FALSE;
+}
+
+/* Function passesLocalArray tells whether an
+ * argument of a call is an array in the frame of
+ * the caller
+ */
+static int passesLocalArray(TreeNode * tree)
+{
+    for (TreeNode * a = tree->child[0]; a != NULL; a = a->sibling)
+        if (a->nodekind == ExpK && a->kind.exp == IdK && a->bind.isArray &&
+            a->child[0] == NULL && a->bind.storage == LocalK)
+            return TRUE;
+    return FALSE;
+}
+
+/* Function isTailCall tells whether tree is a
+ * call that can end the current function by
+ * jumping to the callee: its frame may not live
+ * on once the callee runs, so no local array of
+ * it may be passed
+ */
+static int isTailCall(TreeNode * tree)
+{
+    return tree != NULL && tree->nodekind == StmtK && tree->kind.stmt == CallK &&
+        tree->decl->bind.storage != BuiltinK && tree->decl->bind.storage != VectorK &&
+        !passesLocalArray(tree);
+}
+
+/* Procedure genTailCall generates a call the
+ * current function returns the value of as a
+ * jump, the callee returning to where the current
+ * function would. A callee with its frame on the
+ * stack takes over the frame of the caller, which
+ * then is on the stack too: the arguments are
+ * stored into the parameter slots, through temps
+ * if they read any of them. A callee with a static
+ * frame gets the return address of the caller
+ */
+static void genTailCall(TreeNode * tree)
+{
+    TreeNode * f = tree->decl;
+    TreeNode * a;
+    int n = 0;
+    if (TraceCode) emitComment("-> tail call");
+    if (f->bind.storage == StaticFuncK){
+        genStaticArgs(tree);
+        if (frameReg == gp)
+            emitRM("LD", ac1, frameBias - RET_SLOT, gp, "tail call: load return address");
+        else
+            emitRM("LD", ac1, -RET_SLOT, fp, "tail call: load return address");
+        emitRM("ST", ac1, f->bind.frame - RET_SLOT, gp, "tail call: store return address");
+        if (frameReg == fp)
+            emitRM("LD", fp, -OFP_SLOT, fp, "tail call: restore caller fp");
+    }
+    else {
+        int savedOffset = tmpOffset;
+        for (a = tree->child[0]; a != NULL; a = a->sibling)
+            n++;
+        /* the temps may not overlap the parameters of
+         * a callee with more than the caller has slots
+         */
+        if (tmpOffset > -FRAME_HEADER - n)
+            tmpOffset = -FRAME_HEADER - n;
+        if (readsSlots(tree->child[0], FRAME_HEADER, n)){
+            for (a = tree->child[0]; a != NULL; a = a->sibling){
+                genNode(a);
+                pushTemp("tail call: push argument");
+            }
+            while (n-- > 0){
+                popTemp(ac, "tail call: pop argument");
+                emitRM("ST", ac, -FRAME_HEADER - n, fp, "tail call: store argument");
+            }
+        }
+        else {
+            n = 0;
+            for (a = tree->child[0]; a != NULL; a = a->sibling){
+                genNode(a);
+                emitRM("ST", ac, -FRAME_HEADER - n, fp, "tail call: store argument");
+                n++;
+            }
+        }
+        tmpOffset = savedOffset;
+    }
+    emitCallNote(emitSkip(0), tree->lineno, tree->site, f->attr.name);
+    emitRM("LDC", pc, f->bind.offset, 0, "tail call: jump to function");
+    if (TraceCode) emitComment("<- tail call");
+}
+
+/* Procedure genStmt generates code at a statement node */
+static void genStmt(TreeNode * tree)
+{
+    TreeNode * p1, * p2, * p3;
+    int savedLoc1, savedLoc2, currentLoc;
+    switch (tree->kind.stmt){
+        case CompoundStmtK:
+            if (TraceCode) emitComment("-> compound");
+            cGen(tree->child[1]);
+            if (TraceCode) emitComment("<- compound");
+            break;
+
+        case SelectionStmtK:
+            if (TraceCode) emitComment("-> if");
+            p1 = tree->child[0];
+            p2 = tree->child[1];
+            p3 = tree->child[2];
+            /* generate code for test expression */
+            genNode(p1);
+            savedLoc1 = emitSkip(1);
+            emitBranchNote(savedLoc1, tree->lineno, tree->site, FALSE);
+            emitComment("if: jump to else belongs here");
+            /* recurse on then part */
+            cGen(p2);
+            savedLoc2 = emitSkip(1);
+            emitComment("if: jump to end belongs here");
+            currentLoc = emitSkip(0);
+            emitBackup(savedLoc1);
+            emitRM_Abs("JEQ", ac, currentLoc, "if: jmp to else");
+            emitRestore();
+            /* recurse on else part */
+            cGen(p3);
+            currentLoc = emitSkip(0);
+            emitBackup(savedLoc2);
+            emitRM_Abs("LDA", pc, currentLoc, "jmp to end");
+            emitRestore();
+            if (TraceCode) emitComment("<- if");
+            break;
+
+        case IterationStmtK:
+            if (TraceCode) emitComment("-> while");
+            p1 = tree->child[0];
+            p2 = tree->child[1];
+            savedLoc1 = emitSkip(0);
+            emitComment("while: jump after body comes back here");
+            /* generate code for test */
+            genNode(p1);
+            savedLoc2 = emitSkip(1);
+            emitBranchNote(savedLoc2, tree->lineno, tree->site, FALSE);
+            emitComment("while: jump to end belongs here");
+            /* generate code for body, which the test
+             * follows
+             */
+            atTail = FALSE;
+            cGen(p2);
+            emitRM_Abs("LDA", pc, savedLoc1, "while: jmp back to test");
+            currentLoc = emitSkip(0);
+            emitBackup(savedLoc2);
+            emitRM_Abs("JEQ", ac, currentLoc, "while: jmp to end");
+            emitRestore();
+            if (TraceCode) emitComment("<- while");
+            break;
+
+        case ReturnStmtK:
+            if (TraceCode) emitComment("-> return");
+            if (isTailCall(tree->child[0]))
+                genTailCall(tree->child[0]);
+            else {
+                genNode(tree->child[0]);
+                genReturn();
+            }
+            if (TraceCode) emitComment("<- return");
+            break;
+
+        case SimpleStmtK:
+        case AdditiveStmtK:
+        case TermK:
+            if (TraceCode) emitComment("-> Op");
+            p3 = constOperand(tree, &p1);
+            if (p3 != NULL){
+                /* adding a constant needs no temp */
+                genNode(p1);
+                if (tree->child[1]->attr.op == MINUS)
+                    emitRM("LDA", ac, -p3->attr.val, ac, "op - constant");
+                else
+                    emitRM("LDA", ac, p3->attr.val, ac, "op + constant");
+                if (TraceCode) emitComment("<- Op");
+                break;
+            }
+            p3 = reducedOperand(tree, &p1);
+            if (p3 != NULL){
+                /* register 2 is otherwise unused */
+                genNode(p1);
+                emitReduced(tree->child[1]->attr.op, ac, ac, p3->attr.val, ac1, 2);
+                if (TraceCode) emitComment("<- Op");
+                break;
+            }
+            p1 = tree->child[0];
+            p2 = tree->child[2];
+            /* gen code for ac = left arg */
+            genNode(p1);
+            /* gen code to push left operand */
+            pushTemp("op: push left");
+            /* gen code for ac = right operand */
+            genNode(p2);
+            /* now load left operand */
+            popTemp(ac1, "op: load left");
+            switch (tree->child[1]->attr.op){
+                case PLUS:
+                    emitRO("ADD", ac, ac1, ac, "op +");
+                    break;
+                case MINUS:
+                    emitRO("SUB", ac, ac1, ac, "op -");
+                    break;
+                case TIMES:
+                    emitRO("MUL", ac, ac1, ac, "op *");
+                    break;
+                case OVER:
+                    emitRO("DIV", ac, ac1, ac, "op /");
+                    break;
+                case LT:
+                case LE:
+                case GT:
+                case GE:
+                case EQ:
+                case NE:
+                    emitRO("SUB", ac, ac1, ac, "op relational");
+                    switch (tree->child[1]->attr.op){
+                        case LT: emitRM("JLT", ac, 2, pc, "br if true"); break;
+                        case LE: emitRM("JLE", ac, 2, pc, "br if true"); break;
+                        case GT: emitRM("JGT", ac, 2, pc, "br if true"); break;
+                        case GE: emitRM("JGE", ac, 2, pc, "br if true"); break;
+                        case EQ: emitRM("JEQ", ac, 2, pc, "br if true"); break;
+                        default: emitRM("JNE", ac, 2, pc, "br if true"); break;
+                    }
+                    emitRM("LDC", ac, 0, ac, "false case");
+                    emitRM("LDA", pc, 1, pc, "unconditional jmp");
+                    emitRM("LDC", ac, 1, ac, "true case");
+                    break;
+                default:
+                    emitComment("BUG: Unknown operator");
+                    break;
+            }
+            if (TraceCode) emitComment("<- Op");
+            break;
+
+        case CallK:
+            if (TraceCode) emitComment("-> call");
+            genCall(tree);
+            if (TraceCode) emitComment("<- call");
+            break;
+
+        default:
+            break;
+    }
+} /* genStmt */
+
+/* Procedure genExp generates code at an expression node */
+static void genExp(TreeNode * tree)
+{
+    TreeNode * p1, * p2;
+    switch (tree->kind.exp){
+        case ConstK:
+            if (TraceCode) emitComment("-> Const");
+            /* gen code to load integer constant using LDC */
+            emitRM("LDC", ac, tree->attr.val, 0, "load const");
+            if (TraceCode) emitComment("<- Const");
+            break; /* ConstK */
+
+        case IdK:
+            if (TraceCode) emitComment("-> Id");
+            if (!tree->bind.isArray)
+                emitRM("LD", ac, baseOffset(&tree->bind), baseReg(&tree->bind), "load id value");
+            else if (tree->child[0] == NULL)
+                genArrayBase(tree, ac);
+            else if (constIndex(tree)){
+                int c = tree->child[0]->attr.val;
+                if (tree->bind.storage == ParamK){
+                    genArrayBase(tree, ac);
+                    emitRM("LD", ac, c, ac, "load element value");
+                }
+                else
+                    emitRM("LD", ac, baseOffset(&tree->bind) + c, baseReg(&tree->bind), "load element value");
+            }
+            else {
+                genElement(tree);
+                emitRM("LD", ac, 0, ac, "load element value");
+            }
+            if (TraceCode) emitComment("<- Id");
+            break; /* IdK */
+
+        case AssignK:
+            if (TraceCode) emitComment("-> assign");
+            p1 = tree->child[0];
+            p2 = tree->child[1];
+            if (p1->bind.isArray && constIndex(p1)){
+                /* the address needs no evaluation, so
+                 * the value can come first
+                 */
+                int c = p1->child[0]->attr.val;
+                genNode(p2);
+                if (p1->bind.storage == ParamK){
+                    genArrayBase(p1, ac1);
+                    emitRM("ST", ac, c, ac1, "assign: store value");
+                }
+                else
+                    emitRM("ST", ac, baseOffset(&p1->bind) + c, baseReg(&p1->bind), "assign: store value");
+            }
+            else if (p1->bind.isArray){
+                genElement(p1);
+                pushTemp("assign: push address");
+                genNode(p2);
+                popTemp(ac1, "assign: load address");
+                emitRM("ST", ac, 0, ac1, "assign: store value");
+            }
+            else {
+                /* generate code for rhs */
+                genNode(p2);
+                /* now store value */
+                emitRM("ST", ac, baseOffset(&p1->bind), baseReg(&p1->bind), "assign: store value");
+            }
+            if (TraceCode) emitComment("<- assign");
+            break; /* AssignK */
+
+        case FuncDeclK:
+            if (TraceCode) emitComment("-> function");
+            tree->bind.offset = emitSkip(0);
+            if (tree->bind.storage == StaticFuncK){
+                frameReg = gp;
+                frameBias = tree->bind.frame;
+            }
+            else {
+                frameReg = fp;
+                frameBias = 0;
+            }
+            if (tree->ir != NULL)
+                irGen(tree->ir, frameReg, frameBias);
+            else {
+                tmpOffset = -tree->size;
+                atTail = TRUE;
+                cGen(tree->child[1]);
+                atTail = FALSE;
+                /* falling off the end returns */
+                genReturn();
+            }
+            if (TraceCode) emitComment("<- function");
+            break; /* FuncDeclK */
+
+        default:
+            break;
+    }
+} /* genExp */
+
+/* Procedure genNode generates code for a
+ * single node, ignoring its siblings
+ */
+static void genNode(TreeNode * tree)
+{
+    if (tree != NULL){
+        switch (tree->nodekind){
+            case StmtK:
+                genStmt(tree);
+                break;
+            case ExpK:
+                genExp(tree);
+                break;
+            default:
+                break;
+        }
+    }
+}
+
+/* Procedure cGen recursively generates code by
+ * tree traversal
+ */
+static void cGen(TreeNode * tree)
+{
+    int tail = atTail;
+    while (tree != NULL){
+        /* a call ending the function is a tail call */
+        atTail = tail && tree->sibling == NULL;
+        if (atTail && isTailCall(tree))
+            genTailCall(tree);
+        else
+            genNode(tree);
+        tree = tree->sibling;
+    }
+    atTail = tail;
+}
+
+static int tempDepth(TreeNode * tree);
+
+/* Function nodeDepth returns the number of temps
+ * the code for a single node uses at most
+ */
+static int nodeDepth(TreeNode * tree)
+{
+    TreeNode * a;
+    int depth = 0, d, n = 0;
+    if (tree == NULL)
+        return 0;
+    if (tree->nodekind == StmtK){
+        switch (tree->kind.stmt){
+            case SimpleStmtK:
+            case AdditiveStmtK:
+            case TermK:
+                depth = nodeDepth(tree->child[0]);
+                d = 1 + nodeDepth(tree->child[2]);
+                return (d > depth) ? d : depth;
+            case CallK:
+                for (a = tree->child[0]; a != NULL; a = a->sibling){
+                    d = nodeDepth(a);
+                    if (tree->decl->bind.storage == FuncK)
+                        d += FRAME_HEADER;
+                    else if (tree->decl->bind.storage == StaticFuncK && hasCall(tree->child[0]))
+                        d += n;
+                    if (d > depth)
+                        depth = d;
+                    n++;
+                }
+                if (tree->decl->bind.storage != BuiltinK && n > depth)
+                    depth = n;
+                return depth;
+            default:
+                for (int i = 0; i < MAXCHILDREN; i++){
+                    d = tempDepth(tree->child[i]);
+                    if (d > depth)
+                        depth = d;
+                }
+                return depth;
+        }
+    }
+    switch (tree->kind.exp){
+        case IdK:
+            return nodeDepth(tree->child[0]);
+        case AssignK:
+            if (tree->child[0]->bind.isArray){
+                depth = nodeDepth(tree->child[0]->child[0]);
+                d = 1 + nodeDepth(tree->child[1]);
+                return (d > depth) ? d : depth;
+            }
+            return nodeDepth(tree->child[1]);
+        default:
+            return 0;
+    }
+}
+
+/* Function tempDepth returns the number of temps
+ * the code for a list of nodes uses at most
+ */
+static int tempDepth(TreeNode * tree)
+{
+    int depth = 0;
+    while (tree != NULL){
+        int d = nodeDepth(tree);
+        if (d > depth)
+            depth = d;
+        tree = tree->sibling;
+    }
+    return depth;
+}
+
+/* Procedure raiseCallees moves the static frames
+ * of the functions called in a subtree to start
+ * at or above address start
+ */
+static void raiseCallees(TreeNode * tree, int start)
+{
+    while (tree != NULL){
+        if (tree->nodekind == StmtK && tree->kind.stmt == CallK &&
+            tree->decl->bind.storage == StaticFuncK && tree->decl->bind.frame < start)
+            tree->decl->bind.frame = start;
+        for (int i = 0; i < MAXCHILDREN; i++)
+            raiseCallees(tree->child[i], start);
+        tree = tree->sibling;
+    }
+}
+
+/* Function placeFrames places the static frames
+ * in global data after the global variables and
+ * returns the end of global data. A frame holds
+ * the slots of its function followed by its temps,
+ * slot 0 at the highest address. Frames of
+ * functions that may be active together do not
+ * overlap: a callee's frame comes after those of
+ * all its callers. As names are declared before
+ * use, walking the functions from last to first
+ * visits the callers of a function before it
+ */
+static int placeFrames(TreeNode * syntaxTree)
+{
+    TreeNode ** funcs;
+    int n = 0, end = sf_dataEnd();
+    for (TreeNode * t = syntaxTree; t != NULL; t = t->sibling){
+        if (t->kind.exp == FuncDeclK)
+            n++;
+        else {
+            int width = (t->kind.exp == ArrayDeclK) ? t->size : 1;
+            if (end < t->bind.offset + width)
+                end = t->bind.offset + width;
+        }
+    }
+    funcs = (TreeNode **)malloc((n + 1) * sizeof(TreeNode *));
+    n = 0;
+    for (TreeNode * t = syntaxTree; t != NULL; t = t->sibling)
+        if (t->kind.exp == FuncDeclK){
+            funcs[n++] = t;
+            t->bind.frame = end;
+        }
+    while (n-- > 0){
+        TreeNode * f = funcs[n];
+        int start = f->bind.frame;
+        int total = (f->ir != NULL) ? irAllocate(f->ir) : f->size + tempDepth(f->child[1]);
+        if (f->bind.storage != StaticFuncK)
+            continue;
+        f->bind.frame = start + total - 1;
+        raiseCallees(f->child[1], start + total);
+        if (end < start + total)
+            end = start + total;
+    }
+    free(funcs);
+    return end;
+}
+
+/* Function genData gives the globals computed at
+ * compile time their words when the TM starts a
+ * run, and returns the word at location 0, which
+ * the prelude stores itself
+ */
+static int genData(TreeNode * syntaxTree)
+{
+    int first = 0;
+    for (TreeNode * t = syntaxTree; t != NULL; t = t->sibling){
+        int width = (t->kind.exp == ArrayDeclK) ? t->size : 1;
+        if (t->kind.exp == FuncDeclK || t->init == NULL)
+            continue;
+        for (int k = 0; k < width; k++)
+            if (t->bind.offset + k == 0)
+                first = t->init[k];
+            else if (t->init[k] != 0)
+                emitData(t->bind.offset + k, t->init[k], t->attr.name);
+    }
+    return first;
+}
+
+/**********************************************/
+/* the primary function of the code generator */
+/**********************************************/
+/* Procedure codeGen generates code to a code
+ * file by traversal of the syntax tree. The
+ * second parameter (codefile) is the file name
+ * of the code file, and is used to print the
+ * file name as a comment in the code file
+ */
+void codeGen(TreeNode * syntaxTree, char * codefile)
+{
+    char * s = malloc(strlen(codefile) + 40);
+    TreeNode * main = NULL;
+    int savedLoc, dataEnd, first;
+    strcpy(s, "File: ");
+    strcat(s, codefile);
+    emitComment("C-MINUS Compilation to TM Code");
+    emitComment(s);
+    for (TreeNode * t = syntaxTree; t != NULL; t = t->sibling)
+        if (t->kind.exp == FuncDeclK && strcmp(t->attr.name, "main") == 0)
+            main = t;
+    dataEnd = placeFrames(syntaxTree);
+    sprintf(s, "Global data and static frames: %d", dataEnd);
+    emitComment(s);
+    free(s);
+    first = genData(syntaxTree);
+    /* generate standard prelude */
+    emitComment("Standard prelude:");
+    emitRM("LD", fp, 0, ac, "load maxaddress from location 0");
+    if (first != 0){
+        emitRM("LDC", ac1, first, 0, "load location 0 computed at compile time");
+        emitRM("ST", ac1, 0, ac, "store location 0");
+    }
+    else
+        emitRM("ST", ac, 0, ac, "clear location 0");
+    if (main != NULL){
+        emitComment("call main");
+        emitRM("LDA", ac, 2, pc, "return address");
+        if (main->bind.storage == StaticFuncK)
+            emitRM("ST", ac, main->bind.frame - RET_SLOT, gp, "store return address");
+        else
+            emitRM("ST", ac, -RET_SLOT, fp, "store return address");
+        savedLoc = emitSkip(1);
+    }
+    emitRO("HALT", 0, 0, 0, "");
+    emitComment("End of standard prelude.");
+    /* generate code for C-MINUS program */
+    for (TreeNode * t = syntaxTree; t != NULL; t = t->sibling)
+        if (t->kind.exp == FuncDeclK)
+            genNode(t);
+    if (main != NULL){
+        emitBackup(savedLoc);
+        emitRM("LDC", pc, main->bind.offset, 0, "jump to main");
+        emitRestore();
+    }
+    emitComment("End of execution.");
+}
+
+/* Function codeSize returns the number of TM
+ * instructions codeGen generates for a syntax
+ * tree, writing nothing
+ */
+int codeSize(TreeNode * syntaxTree)
+{
+    FILE * saved = code;
+    int size;
+    code = NULL;
+    emitReset();
+    codeGen(syntaxTree, "");
+    size = emitSize();
+    emitReset();
+    code = saved;
+    return size;
+}
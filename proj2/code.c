@@ -0,0 +1,310 @@
+/****************************************************/
+/* File: code.c                                     */
+/* TM Code emitting utilities                       */
+/* implementation for the TINY compiler             */
+/* Compiler Construction: Principles and Practice   */
+/* Kenneth C. Louden                                */
+/****************************************************/
+
+#include "globals.h"
+#include "code.h"
+
+/* TM location number for current instruction emission */
+static int emitLoc = 0 ;
+
+/* Highest TM location emitted so far
+   For use in conjunction with emitSkip,
+   emitBackup, and emitRestore */
+static int highEmitLoc = 0;
+
+/* TRUE once a program too large for the TM
+   has been reported */
+static int tooLarge = FALSE;
+
+/* Procedure checkSize reports code written past
+ * the instruction memory of the TM; code that is
+ * only counted is left to the passes that count it
+ */
+static void checkSize(void)
+{ if (code != NULL && highEmitLoc > IADDR_SIZE && !tooLarge)
+  { fprintf(listing,"Code error: program needs more than %d instructions\n",
+            IADDR_SIZE);
+    Error = TRUE;
+    tooLarge = TRUE;
+  }
+} /* checkSize */
+
+/* Procedure emitComment prints a comment line 
+ * with comment c in the code file
+ */
+void emitComment( char * c )
+{ if (TraceCode && code != NULL) fprintf(code,"* %s\n",c);}
+
+/* Procedure emitRO emits a register-only
+ * TM instruction
+ * op = the opcode
+ * r = target register
+ * s = 1st source register
+ * t = 2nd source register
+ * c = a comment to be printed if TraceCode is TRUE
+ */
+void emitRO( char *op, int r, int s, int t, char *c)
+{ if (code != NULL)
+  { fprintf(code,"%3d:  %5s  %d,%d,%d ",emitLoc,op,r,s,t);
+    if (TraceCode) fprintf(code,"\t%s",c) ;
+    fprintf(code,"\n") ;
+  }
+  ++emitLoc ;
+  if (highEmitLoc < emitLoc) highEmitLoc = emitLoc ;
+  checkSize() ;
+} /* emitRO */
+
+/* Procedure emitRM emits a register-to-memory
+ * TM instruction
+ * op = the opcode
+ * r = target register
+ * d = the offset
+ * s = the base register
+ * c = a comment to be printed if TraceCode is TRUE
+ */
+void emitRM( char * op, int r, int d, int s, char *c)
+{ if (code != NULL)
+  { fprintf(code,"%3d:  %5s  %d,%d(%d) ",emitLoc,op,r,d,s);
+    if (TraceCode) fprintf(code,"\t%s",c) ;
+    fprintf(code,"\n") ;
+  }
+  ++emitLoc ;
+  if (highEmitLoc < emitLoc)  highEmitLoc = emitLoc ;
+  checkSize() ;
+} /* emitRM */
+
+/* Function emitSkip skips "howMany" code
+ * locations for later backpatch. It also
+ * returns the current code position
+ */
+int emitSkip( int howMany)
+{  int i = emitLoc;
+   emitLoc += howMany ;
+   if (highEmitLoc < emitLoc)  highEmitLoc = emitLoc ;
+   checkSize() ;
+   return i;
+} /* emitSkip */
+
+/* Procedure emitBackup backs up to 
+ * loc = a previously skipped location
+ */
+void emitBackup( int loc)
+{ if (loc > highEmitLoc) emitComment("BUG in emitBackup");
+  emitLoc = loc ;
+} /* emitBackup */
+
+/* Procedure emitRestore restores the current 
+ * code position to the highest previously
+ * unemitted position
+ */
+void emitRestore(void)
+{ emitLoc = highEmitLoc;}
+
+/* Procedure emitRM_Abs converts an absolute reference 
+ * to a pc-relative reference when emitting a
+ * register-to-memory TM instruction
+ * op = the opcode
+ * r = target register
+ * a = the absolute location in memory
+ * c = a comment to be printed if TraceCode is TRUE
+ */
+void emitRM_Abs( char *op, int r, int a, char * c)
+{ if (code != NULL)
+  { fprintf(code,"%3d:  %5s  %d,%d(%d) ",
+                 emitLoc,op,r,a-(emitLoc+1),pc);
+    if (TraceCode) fprintf(code,"\t%s",c) ;
+    fprintf(code,"\n") ;
+  }
+  ++emitLoc ;
+  if (highEmitLoc < emitLoc) highEmitLoc = emitLoc ;
+  checkSize() ;
+} /* emitRM_Abs */
+
+/* Procedure emitBranchNote notes in the code file
+ * that the jump at location loc decides the
+ * condition of branch site of source line lineno,
+ * taken when it is true if sense is TRUE
+ */
+void emitBranchNote(int loc, int lineno, int site, int sense)
+{ if (code != NULL)
+    fprintf(code,"*@ %d branch %d %d %d\n",loc,lineno,site,sense ? 1 : 0);
+} /* emitBranchNote */
+
+/* Procedure emitCallNote notes in the code file
+ * that the jump at location loc calls function
+ * callee at call site of source line lineno
+ */
+void emitCallNote(int loc, int lineno, int site, char * callee)
+{ if (code != NULL)
+    fprintf(code,"*@ %d call %d %d %s\n",loc,lineno,site,callee);
+} /* emitCallNote */
+
+/* Procedure emitData gives the word at data
+ * location loc the value val when the TM starts
+ * a run
+ */
+void emitData(int loc, int val, char * c)
+{ if (code != NULL)
+  { fprintf(code,".DATA %5d %d ",loc,val);
+    if (TraceCode) fprintf(code,"\t%s",c) ;
+    fprintf(code,"\n") ;
+  }
+} /* emitData */
+
+/* Function log2Of returns k for c = 2^k, else -1 */
+static int log2Of(long c)
+{
+    int k = 0;
+    if (c <= 0)
+        return -1;
+    while (c % 2 == 0){
+        c /= 2;
+        k++;
+    }
+    return (c == 1) ? k : -1;
+}
+
+/* Function splitFactor splits c > 0 into 2^b * m
+ * for m = 1 (sign 0), 2^a + 1 (sign 1) or 2^a - 1
+ * (sign -1), and tells whether it could
+ */
+static int splitFactor(int c, int * a, int * b, int * sign)
+{
+    long m = c;
+    if (c <= 0)
+        return FALSE;
+    for (*b = 0; m % 2 == 0; m /= 2)
+        (*b)++;
+    *sign = 0;
+    *a = 0;
+    if (m == 1)
+        return TRUE;
+    if ((*a = log2Of(m - 1)) > 0)
+        *sign = 1;
+    else if ((*a = log2Of(m + 1)) > 1)
+        *sign = -1;
+    return *sign != 0;
+}
+
+/* a shift by 1 is an add, others load the count */
+static int shiftCycles(int k)
+{
+    return (k == 0) ? 0 : (k == 1) ? 1 : 2;
+}
+
+/* Function quotientCycles returns the cycles of
+ * x / 2^a as emitReduced emits it: a copy, or the
+ * sign of x loaded and shifted, shifted again into
+ * the bias for a > 1, added and shifted by a
+ */
+static int quotientCycles(int a)
+{
+    if (a == 0)
+        return 1;
+    return 2 + ((a > 1) ? 2 : 0) + 1 + 2;
+}
+
+/* Function reducible tells whether x op c, for
+ * op TIMES or OVER, takes fewer cycles as shifts
+ * and adds than loading c and multiplying or
+ * dividing: c is 2^b times 1 or 2^a +- 1 for a
+ * product, a power of two for a quotient
+ */
+int reducible(TokenType op, int c)
+{
+    int a, b, sign, cycles;
+    if (op == OVER){
+        if ((a = log2Of(c)) < 0)
+            return FALSE;
+        return quotientCycles(a) < 1 + DIV_CYCLES;
+    }
+    if (op != TIMES || !splitFactor(c, &a, &b, &sign))
+        return FALSE;
+    cycles = (sign != 0) ? shiftCycles(a) + 1 + shiftCycles(b) : shiftCycles(b);
+    return cycles < 1 + MUL_CYCLES;
+}
+
+/* Procedure emitShift emits reg(r) = reg(s) << k,
+ * loading the count into u, which may be r but
+ * not s
+ */
+static void emitShift(int r, int s, int k, int u)
+{
+    if (k == 0){
+        if (r != s)
+            emitRM("LDA", r, 0, s, "op * constant: copy");
+    }
+    else if (k == 1)
+        emitRO("ADD", r, s, s, "op * constant: shift by adding");
+    else {
+        emitRM("LDC", u, k, 0, "op * constant: shift count");
+        emitRO("SHL", r, s, u, "op * constant: shift");
+    }
+}
+
+/* Procedure emitReduced emits reg(r) = reg(s) op c
+ * as shifts and adds for a reducible op and c; a
+ * signed quotient rounds toward zero as DIV does.
+ * u is a scratch register other than r and s, and
+ * for OVER k one other than s and u, which may be r
+ */
+void emitReduced(TokenType op, int r, int s, int c, int u, int k)
+{
+    int a, b, sign;
+    if (op == TIMES){
+        splitFactor(c, &a, &b, &sign);
+        if (sign == 0){
+            emitShift(r, s, b, u);
+            return;
+        }
+        /* x * (2^a +- 1) into u, or r if the last */
+        emitShift(u, s, a, u);
+        emitRO((sign > 0) ? "ADD" : "SUB", (b == 0) ? r : u, u, s, "op * constant");
+        if (b > 0)
+            emitShift(r, u, b, r);
+        return;
+    }
+    a = log2Of(c);
+    if (a == 0){
+        if (r != s)
+            emitRM("LDA", r, 0, s, "op / constant: copy");
+        return;
+    }
+    /* a negative x gets 2^a - 1 added first, so
+     * that shifting rounds toward zero
+     */
+    if (a == 1){
+        emitRM("LDC", u, 31, 0, "op / constant: sign count");
+        emitRO("SHR", u, s, u, "op / constant: 1 if negative");
+    }
+    else {
+        emitRM("LDC", u, 31, 0, "op / constant: sign count");
+        emitRO("SAR", u, s, u, "op / constant: -1 if negative");
+        emitRM("LDC", k, 32 - a, 0, "op / constant: bias count");
+        emitRO("SHR", u, u, k, "op / constant: bias if negative");
+    }
+    emitRO("ADD", u, u, s, "op / constant: add bias");
+    emitRM("LDC", k, a, 0, "op / constant: shift count");
+    emitRO("SAR", r, u, k, "op / constant: shift");
+}
+
+/* Procedure emitReset starts emission over at
+ * location 0; with code == NULL nothing is
+ * written and instructions are only counted
+ */
+void emitReset(void)
+{ emitLoc = 0 ;
+  highEmitLoc = 0 ;
+  tooLarge = FALSE ;
+} /* emitReset */
+
+/* Function emitSize returns the number of
+ * code locations emitted so far
+ */
+int emitSize(void)
+{ return highEmitLoc ; }
@@ -0,0 +1,152 @@
+/****************************************************/
+/* File: code.h                                     */
+/* Code emitting utilities for the TINY compiler    */
+/* and interface to the TM machine                  */
+/* Compiler Construction: Principles and Practice   */
+/* Kenneth C. Louden                                */
+/****************************************************/
+
+#ifndef _CODE_H_
+#define _CODE_H_
+
+/* pc = program counter  */
+#define  pc 7
+
+/* mp = "memory pointer" points
+ * to top of memory (for temp storage)
+ */
+#define  mp 6
+
+/* fp = "frame pointer" points to the
+ * activation record of the current function
+ */
+#define fp 4
+
+/* gp = "global pointer" points
+ * to bottom of memory for (global)
+ * variable storage
+ */
+#define gp 5
+
+/* accumulator */
+#define  ac 0
+
+/* 2nd accumulator */
+#define  ac1 1
+
+/* size of the TM instruction memory, as in tm.c */
+#define IADDR_SIZE 1024
+
+/* cycles of a multiply and a divide, as in tm.c;
+ * other instructions take one
+ */
+#define MUL_CYCLES 4
+#define DIV_CYCLES 20
+
+/* code emitting utilities */
+
+/* Procedure emitComment prints a comment line 
+ * with comment c in the code file
+ */
+void emitComment( char * c );
+
+/* Procedure emitRO emits a register-only
+ * TM instruction
+ * op = the opcode
+ * r = target register
+ * s = 1st source register
+ * t = 2nd source register
+ * c = a comment to be printed if TraceCode is TRUE
+ */
+void emitRO( char *op, int r, int s, int t, char *c);
+
+/* Procedure emitRM emits a register-to-memory
+ * TM instruction
+ * op = the opcode
+ * r = target register
+ * d = the offset
+ * s = the base register
+ * c = a comment to be printed if TraceCode is TRUE
+ */
+void emitRM( char * op, int r, int d, int s, char *c);
+
+/* Function emitSkip skips "howMany" code
+ * locations for later backpatch. It also
+ * returns the current code position
+ */
+int emitSkip( int howMany);
+
+/* Procedure emitBackup backs up to 
+ * loc = a previously skipped location
+ */
+void emitBackup( int loc);
+
+/* Procedure emitRestore restores the current 
+ * code position to the highest previously
+ * unemitted position
+ */
+void emitRestore(void);
+
+/* Procedure emitRM_Abs converts an absolute reference 
+ * to a pc-relative reference when emitting a
+ * register-to-memory TM instruction
+ * op = the opcode
+ * r = target register
+ * a = the absolute location in memory
+ * c = a comment to be printed if TraceCode is TRUE
+ */
+void emitRM_Abs( char *op, int r, int a, char * c);
+
+/* Procedure emitBranchNote notes in the code file
+ * that the jump at location loc decides the
+ * condition of branch site of source line lineno,
+ * taken when it is true if sense is TRUE and when
+ * it is false
+ * otherwise. Notes are comments to the TM, which
+ * counts the jumps they name when it writes an
+ * execution profile
+ */
+void emitBranchNote(int loc, int lineno, int site, int sense);
+
+/* Procedure emitCallNote notes in the code file
+ * that the jump at location loc calls function
+ * callee at call site of source line lineno
+ */
+void emitCallNote(int loc, int lineno, int site, char * callee);
+
+/* Procedure emitData gives the word at data
+ * location loc the value val when the TM starts
+ * a run; loc is not 0, which holds the top of
+ * memory. c = a comment to be printed if
+ * TraceCode is TRUE
+ */
+void emitData(int loc, int val, char * c);
+
+/* Function reducible tells whether x op c, for
+ * op TIMES or OVER, takes fewer cycles as shifts
+ * and adds than loading c and multiplying or
+ * dividing: c is 2^b times 1 or 2^a +- 1 for a
+ * product, a power of two for a quotient
+ */
+int reducible(TokenType op, int c);
+
+/* Procedure emitReduced emits reg(r) = reg(s) op c
+ * as shifts and adds for a reducible op and c; a
+ * signed quotient rounds toward zero as DIV does.
+ * u is a scratch register other than r and s, and
+ * for OVER k one other than s and u, which may be r
+ */
+void emitReduced(TokenType op, int r, int s, int c, int u, int k);
+
+/* Procedure emitReset starts emission over at
+ * location 0; with code == NULL nothing is
+ * written and instructions are only counted
+ */
+void emitReset(void);
+
+/* Function emitSize returns the number of
+ * code locations emitted so far
+ */
+int emitSize(void);
+
+#endif
@@ -0,0 +1,488 @@
+/****************************************************/
+/* File: cse.c                                      */
+/* Local common subexpression elimination for the   */
+/* C-MINUS compiler                                 */
+/* Expressions are value numbered by hash-consing:  */
+/* two expressions get one number when they apply   */
+/* the same operator to operands with the same      */
+/* numbers. A variable gets a new number when it    */
+/* is assigned, and array elements are numbered     */
+/* with a memory version that stores and calls      */
+/* advance, so a number always stands for a single  */
+/* value                                            */
+/* Compiler Construction: Principles and Practice   */
+/* Kenneth C. Louden                                */
+/****************************************************/
+
+#include "globals.h"
+#include "util.h"
+#include "cse.h"
+
+/* SIZE is the size of the hash table */
+#define SIZE 211
+
+/* operators of the values that are not
+ * operations; an operation uses its token
+ */
+#define CONSTV (-1)
+#define ELEMV (-2)
+#define ADDRV (-3)
+
+/* a value of the hash table: op applied to a, b
+ * and c, or to array decl
+ */
+typedef struct ValueRec
+{
+    int op;
+    TreeNode * decl;
+    int a, b, c;
+    int vn;
+    struct ValueRec * next;
+} * Value;
+
+static Value table[SIZE];
+static int nextVN = 0;
+
+/* current number of a scalar variable */
+typedef struct
+{
+    TreeNode * decl;
+    int vn;
+} VarRec;
+
+/* an expression whose value is available; temp
+ * is the declaration of the temp holding it,
+ * NULL until a later expression reuses it
+ */
+typedef struct
+{
+    int vn;
+    TreeNode * node;
+    TreeNode * temp;
+} AvailRec;
+
+/* a temp and the value it holds */
+typedef struct
+{
+    TreeNode * decl;
+    int vn;
+} TempRec;
+
+static VarRec * vars = NULL;
+static int nVars = 0, maxVars = 0;
+static AvailRec * avail = NULL;
+static int nAvail = 0, maxAvail = 0;
+static TempRec * temps = NULL;
+static int nTemps = 0, maxTemps = 0;
+
+/* version of the array elements in memory */
+static int memory = 0;
+static int nextVersion = 0;
+
+/* the function being rewritten; its temps take
+ * frame slots from firstSlot on. Inside the
+ * branches of an if (depth > 0) a temp of the code
+ * before it may still be used, so slots are only
+ * reused in straight-line code at depth 0
+ */
+static TreeNode * func;
+static int firstSlot, nextSlot, endSlot;
+static int depth = 0;
+
+/* Procedure grow makes room for one more
+ * element in a growing array
+ */
+static void * grow(void * array, int n, int * max, int size)
+{
+    if (n < *max)
+        return array;
+    *max = (*max == 0) ? 16 : 2 * *max;
+    array = realloc(array, *max * size);
+    if (array == NULL){
+        fprintf(listing, "Out of memory error at line %d\n", lineno);
+        exit(-1);
+    }
+    return array;
+}
+
+/* Function hashCons returns the number of a
+ * value, numbering it if it is new
+ */
+static int hashCons(int op, TreeNode * decl, int a, int b, int c)
+{
+    unsigned long h = ((((unsigned long)op * 31 + (unsigned long)decl) * 31 +
+        (unsigned)a) * 31 + (unsigned)b) * 31 + (unsigned)c;
+    Value v;
+    h %= SIZE;
+    for (v = table[h]; v != NULL; v = v->next)
+        if (v->op == op && v->decl == decl && v->a == a && v->b == b && v->c == c)
+            return v->vn;
+    v = (Value)malloc(sizeof(struct ValueRec));
+    if (v == NULL){
+        fprintf(listing, "Out of memory error at line %d\n", lineno);
+        exit(-1);
+    }
+    v->op = op;
+    v->decl = decl;
+    v->a = a;
+    v->b = b;
+    v->c = c;
+    v->vn = nextVN++;
+    v->next = table[h];
+    table[h] = v;
+    return v->vn;
+}
+
+static int isTemp(TreeNode * decl)
+{
+    return decl != NULL && decl->attr.name[0] == '$';
+}
+
+/* Function varValue returns the current number
+ * of a scalar variable, a new one if it has
+ * none yet
+ */
+static int varValue(TreeNode * decl)
+{
+    int i;
+    for (i = 0; i < nTemps; i++)
+        if (temps[i].decl == decl)
+            return temps[i].vn;
+    for (i = 0; i < nVars; i++)
+        if (vars[i].decl == decl)
+            return vars[i].vn;
+    vars = grow(vars, nVars, &maxVars, sizeof(VarRec));
+    vars[nVars].decl = decl;
+    vars[nVars].vn = nextVN++;
+    return vars[nVars++].vn;
+}
+
+static void setVar(TreeNode * decl, int vn)
+{
+    for (int i = 0; i < nVars; i++)
+        if (vars[i].decl == decl){
+            vars[i].vn = vn;
+            return;
+        }
+    vars = grow(vars, nVars, &maxVars, sizeof(VarRec));
+    vars[nVars].decl = decl;
+    vars[nVars++].vn = vn;
+}
+
+/* Function isPure tells whether evaluating a
+ * subtree has no effect besides its value and
+ * the temps it sets
+ */
+static int isPure(TreeNode * t)
+{
+    if (t == NULL)
+        return TRUE;
+    if (t->nodekind == StmtK && t->kind.stmt == CallK)
+        return FALSE;
+    if (t->nodekind == ExpK && t->kind.exp == AssignK && !isTemp(t->child[0]->decl))
+        return FALSE;
+    for (int i = 0; i < MAXCHILDREN; i++)
+        if (!isPure(t->child[i]))
+            return FALSE;
+    return TRUE;
+}
+
+static int isBinary(TreeNode * t)
+{
+    return t->nodekind == StmtK && (t->kind.stmt == SimpleStmtK ||
+        t->kind.stmt == AdditiveStmtK || t->kind.stmt == TermK);
+}
+
+/* Function valueOf returns the number of the
+ * value of a pure expression in the current state
+ */
+static int valueOf(TreeNode * t)
+{
+    int a, b;
+    TokenType op;
+    if (isBinary(t)){
+        a = valueOf(t->child[0]);
+        b = valueOf(t->child[2]);
+        op = t->child[1]->attr.op;
+        /* operands of commutative operators in order */
+        if ((op == PLUS || op == TIMES || op == EQ || op == NE) && a > b){
+            int x = a;
+            a = b;
+            b = x;
+        }
+        return hashCons(op, NULL, a, b, 0);
+    }
+    if (t->nodekind == StmtK)
+        return nextVN++;
+    switch (t->kind.exp){
+        case ConstK:
+            return hashCons(CONSTV, NULL, t->attr.val, 0, 0);
+        case IdK:
+            if (!t->bind.isArray)
+                return varValue(t->decl);
+            if (t->child[0] == NULL)
+                return hashCons(ADDRV, t->decl, 0, 0, 0);
+            /* a temp holding an element address may
+             * be stepped; its value is the base
+             */
+            if (!t->decl->bind.isArray)
+                return hashCons(ELEMV, NULL, varValue(t->decl), valueOf(t->child[0]), memory);
+            return hashCons(ELEMV, t->decl, valueOf(t->child[0]), memory, 0);
+        case AssignK:
+            return valueOf(t->child[1]);
+        default:
+            return nextVN++;
+    }
+}
+
+/* Procedure clobber forgets what a call may
+ * change: global variables and array elements
+ */
+static void clobber(void)
+{
+    int i, n = 0;
+    for (i = 0; i < nVars; i++)
+        if (vars[i].decl->bind.storage != GlobalK)
+            vars[n++] = vars[i];
+    nVars = n;
+    memory = ++nextVersion;
+}
+
+/* Procedure clearState forgets everything at the
+ * end of straight-line code; no temp is used
+ * after it
+ */
+static void clearState(void)
+{
+    nVars = 0;
+    nAvail = 0;
+    if (depth == 0)
+        nextSlot = firstSlot;
+    memory = ++nextVersion;
+}
+
+/* Function addTemp declares the next temp of
+ * the current function for value vn
+ */
+static TreeNode * addTemp(int vn, int line)
+{
+    TreeNode * t = newTemp(func, nextSlot++);
+    t->lineno = line;
+    if (endSlot < nextSlot)
+        endSlot = nextSlot;
+    temps = grow(temps, nTemps, &maxTemps, sizeof(TempRec));
+    temps[nTemps].decl = t;
+    temps[nTemps++].vn = vn;
+    return t;
+}
+
+/* Procedure become turns node t into a new node
+ * of the given kind in place, keeping its sibling
+ * and line; t must own nothing
+ */
+static void become(TreeNode * t, ExpKind kind)
+{
+    TreeNode * n = newExpNode(kind);
+    n->sibling = t->sibling;
+    n->lineno = t->lineno;
+    *t = *n;
+    free(n);
+}
+
+/* Procedure reuse replaces expression t by a
+ * load of the temp of available value e, making
+ * the first computation of e store it there
+ */
+static void reuse(TreeNode * t, AvailRec * e)
+{
+    TreeNode * id;
+    if (e->temp == NULL){
+        TreeNode * first = e->node;
+        TreeNode * copy = newExpNode(AssignK);
+        e->temp = addTemp(e->vn, first->lineno);
+        *copy = *first;
+        copy->sibling = NULL;
+        become(first, AssignK);
+        first->type = Integer;
+        first->child[0] = newTempId(e->temp, first->lineno);
+        first->child[1] = copy;
+    }
+    for (int i = 0; i < MAXCHILDREN; i++){
+        freeTree(t->child[i]);
+        t->child[i] = NULL;
+    }
+    if (t->nodekind == ExpK && t->kind.exp == IdK)
+        free(t->attr.name);
+    id = newTempId(e->temp, t->lineno);
+    id->sibling = t->sibling;
+    *t = *id;
+    free(id);
+}
+
+/* Function isCandidate tells whether an
+ * expression is worth keeping in a temp: an
+ * operation or an array element without effects
+ */
+static int isCandidate(TreeNode * t)
+{
+    if (!isBinary(t) && !(t->nodekind == ExpK && t->kind.exp == IdK &&
+        t->bind.isArray && t->child[0] != NULL))
+        return FALSE;
+    return isPure(t);
+}
+
+/* Procedure visit value numbers expression t in
+ * the order the code evaluates it, replacing an
+ * expression whose value is available
+ */
+static void visit(TreeNode * t)
+{
+    TreeNode * lhs;
+    if (t == NULL)
+        return;
+    if (isCandidate(t)){
+        int vn = valueOf(t);
+        for (int i = 0; i < nAvail; i++)
+            if (avail[i].vn == vn){
+                reuse(t, &avail[i]);
+                return;
+            }
+        avail = grow(avail, nAvail, &maxAvail, sizeof(AvailRec));
+        avail[nAvail].vn = vn;
+        avail[nAvail].node = t;
+        avail[nAvail++].temp = NULL;
+    }
+    if (t->nodekind == StmtK){
+        if (t->kind.stmt == CallK){
+            for (TreeNode * a = t->child[0]; a != NULL; a = a->sibling)
+                visit(a);
+            if (t->decl->bind.storage != BuiltinK)
+                clobber();
+        }
+        else if (isBinary(t)){
+            visit(t->child[0]);
+            visit(t->child[2]);
+        }
+        return;
+    }
+    switch (t->kind.exp){
+        case IdK:
+            visit(t->child[0]);
+            break;
+        case AssignK:
+            lhs = t->child[0];
+            if (lhs->bind.isArray){
+                visit(lhs->child[0]);
+                visit(t->child[1]);
+                memory = ++nextVersion;
+            }
+            else {
+                visit(t->child[1]);
+                setVar(lhs->decl, isPure(t->child[1]) ? valueOf(t->child[1]) : nextVN++);
+            }
+            break;
+        default:
+            break;
+    }
+}
+
+static void visitStmts(TreeNode * t);
+
+/* Procedure visitBranch visits a branch of an if
+ * statement, which starts in the current state
+ * and whose values are not available after it
+ */
+static void visitBranch(TreeNode * t)
+{
+    VarRec * saved = (VarRec *)malloc((nVars + 1) * sizeof(VarRec));
+    int savedVars = nVars, savedAvail = nAvail, savedMemory = memory;
+    if (saved == NULL){
+        fprintf(listing, "Out of memory error at line %d\n", lineno);
+        exit(-1);
+    }
+    memcpy(saved, vars, nVars * sizeof(VarRec));
+    depth++;
+    visitStmts(t);
+    depth--;
+    memcpy(vars, saved, savedVars * sizeof(VarRec));
+    nVars = savedVars;
+    nAvail = savedAvail;
+    memory = savedMemory;
+    free(saved);
+}
+
+static void visitStmt(TreeNode * t)
+{
+    if (t->nodekind == StmtK){
+        switch (t->kind.stmt){
+            case CompoundStmtK:
+                visitStmts(t->child[1]);
+                return;
+            case SelectionStmtK:
+                visit(t->child[0]);
+                visitBranch(t->child[1]);
+                visitBranch(t->child[2]);
+                clearState();
+                return;
+            case IterationStmtK:
+                /* the test starts straight-line code
+                 * that the body continues
+                 */
+                clearState();
+                visit(t->child[0]);
+                visitStmts(t->child[1]);
+                clearState();
+                return;
+            case ReturnStmtK:
+                visit(t->child[0]);
+                return;
+            default:
+                break;
+        }
+    }
+    visit(t);
+}
+
+static void visitStmts(TreeNode * t)
+{
+    while (t != NULL){
+        visitStmt(t);
+        t = t->sibling;
+    }
+}
+
+/* Procedure eliminateCommonSubexps rewrites the
+ * bodies of an analyzed program so that an
+ * expression without side effects computed again
+ * in the same straight-line code, with none of its
+ * operands assigned in between, is loaded from a
+ * temp the first computation stored it in. The
+ * temps are locals named $1, $2, ... and enlarge
+ * the frames
+ */
+void eliminateCommonSubexps(TreeNode * syntaxTree)
+{
+    for (TreeNode * t = syntaxTree; t != NULL; t = t->sibling){
+        if (t->kind.exp != FuncDeclK)
+            continue;
+        func = t;
+        firstSlot = endSlot = t->size;
+        nTemps = 0;
+        clearState();
+        visitStmt(t->child[1]);
+        t->size = endSlot;
+    }
+    for (int i = 0; i < SIZE; i++)
+        while (table[i] != NULL){
+            Value v = table[i];
+            table[i] = v->next;
+            free(v);
+        }
+    free(vars);
+    free(avail);
+    free(temps);
+    vars = NULL;
+    avail = NULL;
+    temps = NULL;
+    nVars = maxVars = nAvail = maxAvail = nTemps = maxTemps = 0;
+}
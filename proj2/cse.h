@@ -0,0 +1,23 @@
+/****************************************************/
+/* File: cse.h                                      */
+/* Local common subexpression elimination for the   */
+/* C-MINUS compiler                                 */
+/* Compiler Construction: Principles and Practice   */
+/* Kenneth C. Louden                                */
+/****************************************************/
+
+#ifndef _CSE_H_
+#define _CSE_H_
+
+/* Procedure eliminateCommonSubexps rewrites the
+ * bodies of an analyzed program so that an
+ * expression without side effects computed again
+ * in the same straight-line code, with none of its
+ * operands assigned in between, is loaded from a
+ * temp the first computation stored it in. The
+ * temps are locals named $1, $2, ... and enlarge
+ * the frames
+ */
+void eliminateCommonSubexps(TreeNode * syntaxTree);
+
+#endif
@@ -0,0 +1,140 @@
+/****************************************************/
+/* File: cstab.c                                    */
+/* Concurrent file scope for the C-MINUS compiler   */
+/* Records are published at the head of a bucket    */
+/* with a release store and never change after      */
+/* that except for their line lists, so lookups     */
+/* only follow pointers with acquire loads          */
+/* Compiler Construction: Principles and Practice   */
+/* Kenneth C. Louden                                */
+/****************************************************/
+
+#include <pthread.h>
+#include "globals.h"
+#include "cstab.h"
+
+/* SHIFT is the power of two used as multiplier
+   in hash function, as in symtab.c  */
+#define SHIFT 4
+
+struct ConcurrentScopeRec
+{
+    struct ScopeListRec scope; /* the buckets, as for any scope */
+    pthread_mutex_t locks[NSTRIPES];
+};
+
+/* the hash function of symtab.c */
+static int hash(char * key, int size)
+{
+    int temp = 0;
+    int i = 0;
+    while (key[i] != '\0'){
+        temp = ((temp << SHIFT) + key[i]) % size;
+        ++i;
+    }
+    return temp;
+}
+
+#define LOAD(p) __atomic_load_n(&(p), __ATOMIC_ACQUIRE)
+#define STORE(p, v) __atomic_store_n(&(p), (v), __ATOMIC_RELEASE)
+
+ConcurrentScope cs_new(char * name)
+{
+    ConcurrentScope s = (ConcurrentScope)malloc(sizeof(struct ConcurrentScopeRec));
+    if (s != NULL){
+        s->scope.size = GLOBAL_SIZE;
+        s->scope.hashTable = (BucketList *)calloc(GLOBAL_SIZE, sizeof(BucketList));
+    }
+    if (s == NULL || s->scope.hashTable == NULL){
+        fprintf(listing, "Out of memory error at line %d\n", lineno);
+        exit(-1);
+    }
+    s->scope.name = name;
+    s->scope.parent = NULL;
+    s->scope.nestedLevel = 0;
+    for (int i = 0; i < NSTRIPES; i++)
+        pthread_mutex_init(&s->locks[i], NULL);
+    return s;
+}
+
+void cs_free(ConcurrentScope scope)
+{
+    if (scope == NULL)
+        return;
+    for (int i = 0; i < NSTRIPES; i++)
+        pthread_mutex_destroy(&scope->locks[i]);
+    sc_empty(&scope->scope);
+    free(scope->scope.hashTable);
+    free(scope);
+}
+
+static BucketList find(BucketList l, char * name)
+{
+    while ((l != NULL) && (strcmp(name, l->name) != 0))
+        l = LOAD(l->next);
+    return l;
+}
+
+/* Procedure addLine appends a line number; the
+ * caller holds the lock of the record's stripe
+ */
+static void addLine(BucketList l, int lineno)
+{
+    LineList t = (LineList)malloc(sizeof(struct LineListRec));
+    if (t == NULL){
+        fprintf(listing, "Out of memory error at line %d\n", lineno);
+        exit(-1);
+    }
+    t->lineno = lineno;
+    t->next = NULL;
+    STORE(l->lastLine->next, t);
+    l->lastLine = t;
+}
+
+/* Procedure cst_insert is st_insert for a
+ * concurrent scope: the first insert of a name
+ * creates its record with location loc, later
+ * ones add the line number. Inserts of names in
+ * different stripes do not wait for each other
+ */
+void cst_insert(ConcurrentScope scope, char * name, int lineno, int loc, TreeNode * node)
+{
+    int h = hash(name, scope->scope.size);
+    pthread_mutex_t * lock = &scope->locks[h % NSTRIPES];
+    BucketList * head = &scope->scope.hashTable[h];
+    BucketList l;
+    pthread_mutex_lock(lock);
+    /* no other insert into this bucket can run now */
+    l = find(*head, name);
+    if (l == NULL){ /* variable not yet in table */
+        l = (BucketList)malloc(sizeof(struct BucketListRec));
+        if (l == NULL){
+            fprintf(listing, "Out of memory error at line %d\n", lineno);
+            exit(-1);
+        }
+        l->name = name;
+        l->lines = (LineList)malloc(sizeof(struct LineListRec));
+        l->lines->lineno = lineno;
+        l->lines->next = NULL;
+        l->lastLine = l->lines;
+        l->memloc = loc;
+        l->node = node;
+        l->scope = &scope->scope;
+        l->next = *head;
+        STORE(*head, l);
+    }
+    else /* found in table, so just add line number */
+        addLine(l, lineno);
+    pthread_mutex_unlock(lock);
+} /* cst_insert */
+
+/* Function cst_lookup is st_lookup_top for a
+ * concurrent scope. It takes no lock; a record
+ * it returns is complete and stays valid, and
+ * its line list may grow while it is read
+ */
+BucketList cst_lookup(ConcurrentScope scope, char * name)
+{
+    int h = hash(name, scope->scope.size);
+    return find(LOAD(scope->scope.hashTable[h]), name);
+}
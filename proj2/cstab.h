@@ -0,0 +1,47 @@
+/****************************************************/
+/* File: cstab.h                                    */
+/* Concurrent file scope for the C-MINUS compiler,  */
+/* shared by threads that analyze different         */
+/* functions or files at once                       */
+/* Compiler Construction: Principles and Practice   */
+/* Kenneth C. Louden                                */
+/****************************************************/
+
+#ifndef _CSTAB_H_
+#define _CSTAB_H_
+
+#include "symtab.h"
+
+/* NSTRIPES is the number of locks serializing
+ * inserts; bucket i is guarded by lock i % NSTRIPES
+ */
+#define NSTRIPES 64
+
+typedef struct ConcurrentScopeRec * ConcurrentScope;
+
+/* Function cs_new allocates an empty concurrent
+ * scope of GLOBAL_SIZE buckets
+ */
+ConcurrentScope cs_new(char * name);
+
+/* Procedure cs_free releases a concurrent scope
+ * and its records; no thread may still use it
+ */
+void cs_free(ConcurrentScope scope);
+
+/* Procedure cst_insert is st_insert for a
+ * concurrent scope: the first insert of a name
+ * creates its record with location loc, later
+ * ones add the line number. Inserts of names in
+ * different stripes do not wait for each other
+ */
+void cst_insert(ConcurrentScope scope, char * name, int lineno, int loc, TreeNode * node);
+
+/* Function cst_lookup is st_lookup_top for a
+ * concurrent scope. It takes no lock; a record
+ * it returns is complete and stays valid, and
+ * its line list may grow while it is read
+ */
+BucketList cst_lookup(ConcurrentScope scope, char * name);
+
+#endif
@@ -0,0 +1,391 @@
+/****************************************************/
+/* File: dce.c                                      */
+/* Dead code elimination for the C-MINUS compiler   */
+/* A node of the control flow graph evaluates one   */
+/* expression: an expression statement, the value   */
+/* of a return or the test of an if or while.       */
+/* Liveness is solved over it with one bit per      */
+/* scalar local; arrays and globals are never dead  */
+/* Compiler Construction: Principles and Practice   */
+/* Kenneth C. Louden                                */
+/****************************************************/
+
+#include "globals.h"
+#include "util.h"
+#include "dce.h"
+
+/* the node every return and the end of the
+ * function body lead to
+ */
+#define EXIT 0
+
+typedef struct
+{
+    TreeNode * stmt;    /* statement the node belongs to */
+    TreeNode * exp;     /* expression it evaluates */
+    int succ[2];
+    int nSucc;
+    int reached;
+    unsigned * use, * def, * in, * out;
+} CfgNode;
+
+static CfgNode * nodes = NULL;
+static int nNodes = 0, maxNodes = 0;
+
+/* the scalar locals and parameters of the
+ * function, one bit each
+ */
+static TreeNode ** vars = NULL;
+static int nVars = 0, maxVars = 0;
+static int nWords;
+
+static void * grow(void * array, int n, int * max, int size)
+{
+    if (n < *max)
+        return array;
+    *max = (*max == 0) ? 64 : 2 * *max;
+    array = realloc(array, *max * size);
+    if (array == NULL){
+        fprintf(listing, "Out of memory error at line %d\n", lineno);
+        exit(-1);
+    }
+    return array;
+}
+
+static int newNode(TreeNode * stmt, TreeNode * exp)
+{
+    nodes = grow(nodes, nNodes, &maxNodes, sizeof(CfgNode));
+    nodes[nNodes].stmt = stmt;
+    nodes[nNodes].exp = exp;
+    nodes[nNodes].nSucc = 0;
+    nodes[nNodes].reached = FALSE;
+    nodes[nNodes].use = nodes[nNodes].def = NULL;
+    nodes[nNodes].in = nodes[nNodes].out = NULL;
+    return nNodes++;
+}
+
+static void addSucc(int n, int s)
+{
+    nodes[n].succ[nodes[n].nSucc++] = s;
+}
+
+static int buildStmts(TreeNode * t, int next);
+
+/* Function buildStmt adds the nodes of statement
+ * t, which continues at node next, and returns
+ * the node t starts at
+ */
+static int buildStmt(TreeNode * t, int next)
+{
+    int n, body;
+    if (t->nodekind == StmtK){
+        switch (t->kind.stmt){
+            case CompoundStmtK:
+                return buildStmts(t->child[1], next);
+            case SelectionStmtK:
+                n = newNode(t, t->child[0]);
+                if (!isConst(t->child[0]) || t->child[0]->attr.val != 0)
+                    addSucc(n, buildStmts(t->child[1], next));
+                if (!isConst(t->child[0]) || t->child[0]->attr.val == 0)
+                    addSucc(n, buildStmts(t->child[2], next));
+                return n;
+            case IterationStmtK:
+                n = newNode(t, t->child[0]);
+                body = buildStmts(t->child[1], n);
+                if (!isConst(t->child[0]) || t->child[0]->attr.val != 0)
+                    addSucc(n, body);
+                if (!isConst(t->child[0]) || t->child[0]->attr.val == 0)
+                    addSucc(n, next);
+                return n;
+            case ReturnStmtK:
+                n = newNode(t, t->child[0]);
+                addSucc(n, EXIT);
+                return n;
+            default:
+                break;
+        }
+    }
+    n = newNode(t, t);
+    addSucc(n, next);
+    return n;
+}
+
+/* Function buildStmts adds the nodes of a list
+ * of statements, last to first
+ */
+static int buildStmts(TreeNode * t, int next)
+{
+    if (t == NULL)
+        return next;
+    return buildStmt(t, buildStmts(t->sibling, next));
+}
+
+static void reach(int n)
+{
+    if (nodes[n].reached)
+        return;
+    nodes[n].reached = TRUE;
+    for (int i = 0; i < nodes[n].nSucc; i++)
+        reach(nodes[n].succ[i]);
+}
+
+/* Function varIndex returns the bit of the
+ * variable an identifier names, -1 if it is not
+ * a scalar local or parameter. A temp holding an
+ * element address is a scalar even where it is
+ * indexed like an array
+ */
+static int varIndex(TreeNode * id, int add)
+{
+    Binding * b = &id->decl->bind;
+    int i;
+    if (b->isArray || (b->storage != LocalK && b->storage != ParamK))
+        return -1;
+    for (i = 0; i < nVars; i++)
+        if (vars[i] == id->decl)
+            return i;
+    if (!add)
+        return -1;
+    vars = grow(vars, nVars, &maxVars, sizeof(TreeNode *));
+    vars[nVars] = id->decl;
+    return nVars++;
+}
+
+static void collectVars(TreeNode * t)
+{
+    while (t != NULL){
+        if (t->nodekind == ExpK && t->kind.exp == IdK)
+            varIndex(t, TRUE);
+        for (int i = 0; i < MAXCHILDREN; i++)
+            collectVars(t->child[i]);
+        t = t->sibling;
+    }
+}
+
+static unsigned * newSet(void)
+{
+    unsigned * s = (unsigned *)calloc(nWords, sizeof(unsigned));
+    if (s == NULL){
+        fprintf(listing, "Out of memory error at line %d\n", lineno);
+        exit(-1);
+    }
+    return s;
+}
+
+#define ADD(s, i) ((s)[(i) / 32] |= 1u << ((i) % 32))
+#define HAS(s, i) (((s)[(i) / 32] >> ((i) % 32)) & 1)
+
+/* Procedure useDef adds the variables an
+ * expression reads to use and those it assigns to
+ * def. An expression has no branches, so what it
+ * assigns it always assigns; a variable read in
+ * it is taken as read before it is assigned
+ */
+static void useDef(TreeNode * t, unsigned * use, unsigned * def)
+{
+    int i;
+    if (t == NULL)
+        return;
+    if (t->nodekind == StmtK && t->kind.stmt == CallK){
+        for (TreeNode * a = t->child[0]; a != NULL; a = a->sibling)
+            useDef(a, use, def);
+        return;
+    }
+    if (t->nodekind == ExpK && t->kind.exp == AssignK){
+        TreeNode * lhs = t->child[0];
+        if ((i = varIndex(lhs, FALSE)) >= 0){
+            /* a store through an address temp reads it */
+            if (lhs->bind.isArray)
+                ADD(use, i);
+            else
+                ADD(def, i);
+        }
+        useDef(lhs->child[0], use, def);
+        useDef(t->child[1], use, def);
+        return;
+    }
+    if (t->nodekind == ExpK && t->kind.exp == IdK && (i = varIndex(t, FALSE)) >= 0)
+        ADD(use, i);
+    for (int k = 0; k < MAXCHILDREN; k++)
+        useDef(t->child[k], use, def);
+}
+
+/* Procedure liveness solves in = use + (out - def),
+ * out = union of the ins of the successors, going
+ * over the nodes backwards until nothing changes
+ */
+static void liveness(void)
+{
+    int changed = TRUE;
+    for (int n = 0; n < nNodes; n++){
+        nodes[n].use = newSet();
+        nodes[n].def = newSet();
+        nodes[n].in = newSet();
+        nodes[n].out = newSet();
+        useDef(nodes[n].exp, nodes[n].use, nodes[n].def);
+    }
+    while (changed){
+        changed = FALSE;
+        for (int n = nNodes - 1; n >= 0; n--){
+            CfgNode * p = &nodes[n];
+            if (!p->reached)
+                continue;
+            for (int w = 0; w < nWords; w++){
+                unsigned out = 0, in;
+                for (int i = 0; i < p->nSucc; i++)
+                    out |= nodes[p->succ[i]].in[w];
+                in = p->use[w] | (out & ~p->def[w]);
+                if (in != p->in[w] || out != p->out[w])
+                    changed = TRUE;
+                p->in[w] = in;
+                p->out[w] = out;
+            }
+        }
+    }
+}
+
+static CfgNode * nodeOf(TreeNode * stmt)
+{
+    for (int n = 1; n < nNodes; n++)
+        if (nodes[n].stmt == stmt)
+            return &nodes[n];
+    return NULL;
+}
+
+static int isPure(TreeNode * t)
+{
+    if (t == NULL)
+        return TRUE;
+    if (t->nodekind == StmtK && t->kind.stmt == CallK)
+        return FALSE;
+    if (t->nodekind == ExpK && t->kind.exp == AssignK)
+        return FALSE;
+    for (int i = 0; i < MAXCHILDREN; i++)
+        if (!isPure(t->child[i]))
+            return FALSE;
+    return TRUE;
+}
+
+/* Function deadStore strips the assignments to
+ * variables not live afterwards from expression
+ * statement t and returns what is left
+ */
+static TreeNode * deadStore(TreeNode * t, unsigned * out)
+{
+    int i;
+    while (t != NULL && t->nodekind == ExpK && t->kind.exp == AssignK &&
+        !t->child[0]->bind.isArray &&
+        (i = varIndex(t->child[0], FALSE)) >= 0 && !HAS(out, i)){
+        TreeNode * rhs = t->child[1];
+        t->child[1] = NULL;
+        freeTree(t);
+        t = rhs;
+    }
+    return t;
+}
+
+static int sweepStmts(TreeNode ** loc);
+
+/* Function sweep deletes the dead code inside
+ * statement t and tells whether it changed
+ */
+static int sweep(TreeNode * t)
+{
+    if (t == NULL || t->nodekind != StmtK)
+        return FALSE;
+    switch (t->kind.stmt){
+        case CompoundStmtK:
+            return sweepStmts(&t->child[1]);
+        case SelectionStmtK:
+            return sweepStmts(&t->child[1]) | sweepStmts(&t->child[2]);
+        case IterationStmtK:
+            return sweepStmts(&t->child[1]);
+        default:
+            return FALSE;
+    }
+}
+
+/* Function sweepStmts deletes the unreachable
+ * statements and dead stores of a list
+ */
+static int sweepStmts(TreeNode ** loc)
+{
+    int changed = FALSE;
+    while (*loc != NULL){
+        TreeNode * t = *loc;
+        TreeNode * next = t->sibling;
+        CfgNode * n = nodeOf(t);
+        if (n != NULL && !n->reached){
+            t->sibling = NULL;
+            freeTree(t);
+            *loc = next;
+            changed = TRUE;
+            continue;
+        }
+        if (n != NULL && n->exp == t){
+            TreeNode * r;
+            t->sibling = NULL;
+            r = deadStore(t, n->out);
+            if (isPure(r)){
+                freeTree(r);
+                *loc = next;
+                changed = TRUE;
+                continue;
+            }
+            if (r != t)
+                changed = TRUE;
+            r->sibling = next;
+            *loc = r;
+        }
+        else
+            changed |= sweep(t);
+        loc = &(*loc)->sibling;
+    }
+    return changed;
+}
+
+static void freeGraph(void)
+{
+    for (int n = 0; n < nNodes; n++){
+        free(nodes[n].use);
+        free(nodes[n].def);
+        free(nodes[n].in);
+        free(nodes[n].out);
+    }
+    nNodes = 0;
+    nVars = 0;
+}
+
+/* Procedure eliminateDeadCode builds the control
+ * flow graph of each function of an analyzed
+ * program and the liveness of its scalar locals
+ * and parameters. Statements no path reaches are
+ * deleted, as are assignments to a local that is
+ * not read again; what remains of such an
+ * assignment is kept only for its side effects
+ */
+void eliminateDeadCode(TreeNode * syntaxTree)
+{
+    for (TreeNode * f = syntaxTree; f != NULL; f = f->sibling){
+        int changed = TRUE;
+        if (f->kind.exp != FuncDeclK)
+            continue;
+        /* a deleted store may make more dead */
+        while (changed){
+            int entry;
+            newNode(NULL, NULL);
+            entry = buildStmt(f->child[1], EXIT);
+            reach(entry);
+            collectVars(f->child[1]);
+            nWords = nVars / 32 + 1;
+            liveness();
+            changed = sweep(f->child[1]);
+            freeGraph();
+        }
+    }
+    free(nodes);
+    free(vars);
+    nodes = NULL;
+    vars = NULL;
+    maxNodes = maxVars = 0;
+}
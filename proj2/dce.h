@@ -0,0 +1,21 @@
+/****************************************************/
+/* File: dce.h                                      */
+/* Dead code elimination for the C-MINUS compiler   */
+/* Compiler Construction: Principles and Practice   */
+/* Kenneth C. Louden                                */
+/****************************************************/
+
+#ifndef _DCE_H_
+#define _DCE_H_
+
+/* Procedure eliminateDeadCode builds the control
+ * flow graph of each function of an analyzed
+ * program and the liveness of its scalar locals
+ * and parameters. Statements no path reaches are
+ * deleted, as are assignments to a local that is
+ * not read again; what remains of such an
+ * assignment is kept only for its side effects
+ */
+void eliminateDeadCode(TreeNode * syntaxTree);
+
+#endif
@@ -0,0 +1,333 @@
+/****************************************************/
+/* File: fold.c                                     */
+/* Constant folding for the C-MINUS compiler        */
+/* Subtrees are folded bottom-up; a node that       */
+/* folds is replaced by a constant or by one of     */
+/* its operands and released                        */
+/* Compiler Construction: Principles and Practice   */
+/* Kenneth C. Louden                                */
+/****************************************************/
+
+#include <limits.h>
+#include "globals.h"
+#include "util.h"
+#include "fold.h"
+
+static int isConstVal(TreeNode * t, int val)
+{
+    return isConst(t) && t->attr.val == val;
+}
+
+static int isBinary(TreeNode * t)
+{
+    return t->nodekind == StmtK && (t->kind.stmt == SimpleStmtK ||
+        t->kind.stmt == AdditiveStmtK || t->kind.stmt == TermK);
+}
+
+/* Function isPure tells whether evaluating a
+ * subtree has no effect besides its value
+ */
+static int isPure(TreeNode * t)
+{
+    if (t == NULL)
+        return TRUE;
+    if (t->nodekind == StmtK && t->kind.stmt == CallK)
+        return FALSE;
+    if (t->nodekind == ExpK && t->kind.exp == AssignK)
+        return FALSE;
+    for (int i = 0; i < MAXCHILDREN; i++)
+        if (!isPure(t->child[i]))
+            return FALSE;
+    return TRUE;
+}
+
+/* Function sameExp tells whether two pure
+ * expressions compute the same value
+ */
+static int sameExp(TreeNode * a, TreeNode * b)
+{
+    if (a == NULL || b == NULL)
+        return a == b;
+    if (a->nodekind != b->nodekind)
+        return FALSE;
+    if (a->nodekind == StmtK){
+        if (!isBinary(a) || a->kind.stmt != b->kind.stmt ||
+            a->child[1]->attr.op != b->child[1]->attr.op)
+            return FALSE;
+        return sameExp(a->child[0], b->child[0]) && sameExp(a->child[2], b->child[2]);
+    }
+    if (a->kind.exp != b->kind.exp)
+        return FALSE;
+    switch (a->kind.exp){
+        case ConstK:
+            return a->attr.val == b->attr.val;
+        case IdK:
+            return a->decl == b->decl && sameExp(a->child[0], b->child[0]);
+        default:
+            return FALSE;
+    }
+}
+
+/* Function replaceConst makes a constant node to
+ * replace old
+ */
+static TreeNode * replaceConst(TreeNode * old, int val)
+{
+    TreeNode * t = newConst(val, old->lineno);
+    freeTree(old);
+    return t;
+}
+
+/* Function operand replaces binary node t by its
+ * operand child[i]
+ */
+static TreeNode * operand(TreeNode * t, int i)
+{
+    TreeNode * r = t->child[i];
+    t->child[i] = NULL;
+    freeTree(t);
+    return r;
+}
+
+/* Function evaluateOp computes a constant operation
+ * as the TM would; ok is cleared when the TM would
+ * stop with a division by zero
+ */
+int evaluateOp(TokenType op, int a, int b, int * ok)
+{
+    *ok = TRUE;
+    switch (op){
+        case PLUS: return (int)((unsigned)a + (unsigned)b);
+        case MINUS: return (int)((unsigned)a - (unsigned)b);
+        case TIMES: return (int)((unsigned)a * (unsigned)b);
+        case OVER:
+            if (b == 0 || (a == INT_MIN && b == -1)){
+                *ok = FALSE;
+                return 0;
+            }
+            return a / b;
+        case LT: return a < b;
+        case LE: return a <= b;
+        case GT: return a > b;
+        case GE: return a >= b;
+        case EQ: return a == b;
+        case NE: return a != b;
+        default:
+            *ok = FALSE;
+            return 0;
+    }
+}
+
+static TreeNode * foldExp(TreeNode * t);
+
+/* Function foldBinary folds an operation whose
+ * operands are folded already
+ */
+static TreeNode * foldBinary(TreeNode * t)
+{
+    TreeNode * l = t->child[0];
+    TreeNode * r = t->child[2];
+    TokenType op = t->child[1]->attr.op;
+    int ok, val;
+    if (isConst(l) && isConst(r)){
+        val = evaluateOp(op, l->attr.val, r->attr.val, &ok);
+        if (ok)
+            return replaceConst(t, val);
+    }
+    /* (x + c1) + c2 is x + (c1 + c2) */
+    if ((op == PLUS || op == MINUS) && isConst(r) && l->nodekind == StmtK &&
+        l->kind.stmt == AdditiveStmtK && isConst(l->child[2])){
+        int c1 = l->child[2]->attr.val;
+        if (l->child[1]->attr.op == MINUS)
+            c1 = (int)(0u - (unsigned)c1);
+        val = evaluateOp(op, c1, r->attr.val, &ok);
+        l->child[1]->attr.op = (val < 0 && val != INT_MIN) ? MINUS : PLUS;
+        l->child[2]->attr.val = (val < 0 && val != INT_MIN) ? -val : val;
+        return foldBinary(operand(t, 0));
+    }
+    switch (op){
+        case PLUS:
+            if (isConstVal(r, 0))
+                return operand(t, 0);
+            if (isConstVal(l, 0))
+                return operand(t, 2);
+            break;
+        case MINUS:
+            if (isConstVal(r, 0))
+                return operand(t, 0);
+            if (isPure(l) && sameExp(l, r))
+                return replaceConst(t, 0);
+            break;
+        case TIMES:
+            if (isConstVal(r, 1))
+                return operand(t, 0);
+            if (isConstVal(l, 1))
+                return operand(t, 2);
+            if ((isConstVal(r, 0) && isPure(l)) || (isConstVal(l, 0) && isPure(r)))
+                return replaceConst(t, 0);
+            break;
+        case OVER:
+            if (isConstVal(r, 1))
+                return operand(t, 0);
+            break;
+        default:
+            /* a relation of a value with itself */
+            if (isPure(l) && sameExp(l, r))
+                return replaceConst(t, op == LE || op == GE || op == EQ);
+            break;
+    }
+    return t;
+}
+
+/* Function foldExps folds a list of expressions,
+ * the arguments of a call
+ */
+static TreeNode * foldExps(TreeNode * t)
+{
+    TreeNode * head = NULL, * last = NULL;
+    while (t != NULL){
+        TreeNode * next = t->sibling;
+        t->sibling = NULL;
+        t = foldExp(t);
+        if (last == NULL)
+            head = t;
+        else
+            last->sibling = t;
+        last = t;
+        t = next;
+    }
+    return head;
+}
+
+/* Function foldExp folds an expression and
+ * returns what replaces it
+ */
+static TreeNode * foldExp(TreeNode * t)
+{
+    if (t == NULL)
+        return NULL;
+    if (t->nodekind == StmtK){
+        if (isBinary(t)){
+            t->child[0] = foldExp(t->child[0]);
+            t->child[2] = foldExp(t->child[2]);
+            return foldBinary(t);
+        }
+        if (t->kind.stmt == CallK)
+            t->child[0] = foldExps(t->child[0]);
+        return t;
+    }
+    switch (t->kind.exp){
+        case IdK:
+            t->child[0] = foldExp(t->child[0]);
+            break;
+        case AssignK:
+            t->child[0] = foldExp(t->child[0]);
+            t->child[1] = foldExp(t->child[1]);
+            break;
+        default:
+            break;
+    }
+    return t;
+}
+
+static TreeNode * foldStmts(TreeNode * t);
+
+/* Function branch replaces statement t by its
+ * statement list child[i], NULL if none
+ */
+static TreeNode * branch(TreeNode * t, int i)
+{
+    TreeNode * r = t->child[i];
+    t->child[i] = NULL;
+    freeTree(t);
+    return r;
+}
+
+/* Function foldStmt folds a statement and returns
+ * the statements that replace it, NULL if it has
+ * no effect
+ */
+static TreeNode * foldStmt(TreeNode * t)
+{
+    if (t->nodekind == StmtK){
+        switch (t->kind.stmt){
+            case CompoundStmtK:
+                t->child[1] = foldStmts(t->child[1]);
+                return t;
+            case SelectionStmtK:
+                t->child[0] = foldExp(t->child[0]);
+                t->child[1] = foldStmts(t->child[1]);
+                t->child[2] = foldStmts(t->child[2]);
+                if (isConst(t->child[0]))
+                    return branch(t, (t->child[0]->attr.val != 0) ? 1 : 2);
+                return t;
+            case IterationStmtK:
+                t->child[0] = foldExp(t->child[0]);
+                if (isConstVal(t->child[0], 0)){
+                    freeTree(t);
+                    return NULL;
+                }
+                t->child[1] = foldStmts(t->child[1]);
+                return t;
+            case ReturnStmtK:
+                t->child[0] = foldExp(t->child[0]);
+                return t;
+            default:
+                break;
+        }
+    }
+    t = foldExp(t);
+    if (isPure(t)){
+        freeTree(t);
+        return NULL;
+    }
+    return t;
+}
+
+/* Function foldStmts folds a statement list,
+ * splicing in what replaces each statement
+ */
+static TreeNode * foldStmts(TreeNode * t)
+{
+    TreeNode * head = NULL, * last = NULL;
+    while (t != NULL){
+        TreeNode * next = t->sibling;
+        t->sibling = NULL;
+        t = foldStmt(t);
+        if (t != NULL){
+            if (last == NULL)
+                head = t;
+            else
+                last->sibling = t;
+            last = t;
+            /* a branch may be a list */
+            while (last->sibling != NULL)
+                last = last->sibling;
+        }
+        t = next;
+    }
+    return head;
+}
+
+/* Function foldStatements folds a statement
+ * list of a body and returns what replaces it
+ */
+TreeNode * foldStatements(TreeNode * t)
+{
+    return foldStmts(t);
+}
+
+/* Procedure foldConstants rewrites the bodies of
+ * an analyzed program: constant subexpressions are
+ * evaluated, identities such as x+0, x*1, x*0 and
+ * x-x are applied, (x+c1)+c2 is x+(c1+c2), if
+ * and while statements with a constant test are
+ * reduced to the code that runs and expression
+ * statements without effect are dropped
+ */
+void foldConstants(TreeNode * syntaxTree)
+{
+    for (TreeNode * t = syntaxTree; t != NULL; t = t->sibling)
+        if (t->kind.exp == FuncDeclK)
+            t->child[1] = foldStmts(t->child[1]);
+}
@@ -0,0 +1,32 @@
+/****************************************************/
+/* File: fold.h                                     */
+/* Constant folding for the C-MINUS compiler        */
+/* Compiler Construction: Principles and Practice   */
+/* Kenneth C. Louden                                */
+/****************************************************/
+
+#ifndef _FOLD_H_
+#define _FOLD_H_
+
+/* Procedure foldConstants rewrites the bodies of
+ * an analyzed program: constant subexpressions are
+ * evaluated, identities such as x+0, x*1, x*0 and
+ * x-x are applied, (x+c1)+c2 is x+(c1+c2), if
+ * and while statements with a constant test are
+ * reduced to the code that runs and expression
+ * statements without effect are dropped
+ */
+void foldConstants(TreeNode * syntaxTree);
+
+/* Function foldStatements folds a statement
+ * list of a body and returns what replaces it
+ */
+TreeNode * foldStatements(TreeNode * t);
+
+/* Function evaluateOp computes a constant operation
+ * as the TM would; ok is cleared when the TM would
+ * stop with a division by zero
+ */
+int evaluateOp(TokenType op, int a, int b, int * ok);
+
+#endif
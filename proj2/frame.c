@@ -0,0 +1,232 @@
+/****************************************************/
+/* File: frame.c                                    */
+/* Frame layout for the C-MINUS compiler            */
+/* Live ranges of frame variables are intervals     */
+/* over the evaluation order of the function body;  */
+/* variables with disjoint intervals share slots    */
+/* Compiler Construction: Principles and Practice   */
+/* Kenneth C. Louden                                */
+/****************************************************/
+
+#include "globals.h"
+#include "symtab.h"
+#include "frame.h"
+
+/* the live range of a parameter or local: from the
+ * first to the last reference, counted in
+ * evaluation order, and the slots it is given
+ */
+typedef struct
+{
+    TreeNode * decl;
+    int declPos; /* position of the declaration */
+    int start, end; /* live range, start < 0 if never used */
+    int width; /* number of slots */
+    int slot; /* first slot, -1 until assigned */
+} Interval;
+
+static Interval * vars = NULL;
+static int nVars = 0;
+static int maxVars = 0;
+
+/* position of the next reference */
+static int pos = 0;
+
+/* While a frame is laid out the offset of a frame
+ * variable's binding holds its index in vars
+ */
+static int isFrameVar(TreeNode * decl)
+{
+    return decl != NULL &&
+        (decl->bind.storage == LocalK || decl->bind.storage == ParamK);
+}
+
+static void addVar(TreeNode * decl)
+{
+    if (nVars == maxVars){
+        maxVars = (maxVars == 0) ? 16 : maxVars * 2;
+        vars = (Interval *)realloc(vars, maxVars * sizeof(Interval));
+        if (vars == NULL){
+            fprintf(listing, "Out of memory error at line %d\n", lineno);
+            exit(-1);
+        }
+    }
+    vars[nVars].decl = decl;
+    vars[nVars].declPos = pos++;
+    vars[nVars].start = -1;
+    vars[nVars].end = -1;
+    vars[nVars].width = (decl->bind.isArray && !decl->isParam) ? decl->size : 1;
+    vars[nVars].slot = -1;
+    decl->bind.offset = nVars++;
+}
+
+/* Procedure reference extends the live range of
+ * the variable declared by decl to the current
+ * position
+ */
+static void reference(TreeNode * decl)
+{
+    if (isFrameVar(decl)){
+        Interval * v = &vars[decl->bind.offset];
+        if (v->start < 0)
+            v->start = pos;
+        v->end = pos;
+    }
+    pos++;
+}
+
+/* Procedure spanLoop makes every variable declared
+ * outside a loop and used inside it live across
+ * the whole loop, as its value may flow around
+ * the back edge
+ */
+static void spanLoop(int loopStart, int loopEnd)
+{
+    for (int i = 0; i < nVars; i++){
+        Interval * v = &vars[i];
+        if (v->declPos < loopStart && v->end >= loopStart){
+            if (v->start > loopStart)
+                v->start = loopStart;
+            if (v->end < loopEnd)
+                v->end = loopEnd;
+        }
+    }
+}
+
+/* Procedure number visits the references of a
+ * subtree in the order the code generator
+ * evaluates them
+ */
+static void number(TreeNode * t)
+{
+    int loopStart;
+    while (t != NULL){
+        if (t->nodekind == StmtK){
+            switch (t->kind.stmt){
+                case CompoundStmtK:
+                    for (TreeNode * d = t->child[0]; d != NULL; d = d->sibling)
+                        addVar(d);
+                    number(t->child[1]);
+                    break;
+                case IterationStmtK:
+                    loopStart = pos++;
+                    number(t->child[0]);
+                    number(t->child[1]);
+                    spanLoop(loopStart, pos++);
+                    break;
+                case SimpleStmtK:
+                case AdditiveStmtK:
+                case TermK:
+                    number(t->child[0]);
+                    number(t->child[2]);
+                    break;
+                default:
+                    for (int i = 0; i < MAXCHILDREN; i++)
+                        number(t->child[i]);
+                    break;
+            }
+        }
+        else {
+            switch (t->kind.exp){
+                case IdK:
+                    number(t->child[0]);
+                    reference(t->decl);
+                    break;
+                case AssignK:
+                    /* the store follows the value */
+                    number(t->child[0]->child[0]);
+                    number(t->child[1]);
+                    reference(t->child[0]->decl);
+                    break;
+                default:
+                    break;
+            }
+        }
+        t = t->sibling;
+    }
+}
+
+static int overlaps(Interval * a, Interval * b)
+{
+    return !(a->end < b->start || b->end < a->start) &&
+        !(a->slot + a->width <= b->slot || b->slot + b->width <= a->slot);
+}
+
+static int byStart(const void * a, const void * b)
+{
+    const Interval * x = *(const Interval * const *)a;
+    const Interval * y = *(const Interval * const *)b;
+    if (x->start != y->start)
+        return x->start - y->start;
+    return x->declPos - y->declPos;
+}
+
+/* Procedure rebind copies the new bindings of the
+ * frame variables into the identifiers of a subtree
+ */
+static void rebind(TreeNode * t)
+{
+    while (t != NULL){
+        for (int i = 0; i < MAXCHILDREN; i++)
+            rebind(t->child[i]);
+        if (t->nodekind == ExpK && t->kind.exp == IdK && isFrameVar(t->decl))
+            t->bind = t->decl->bind;
+        t = t->sibling;
+    }
+}
+
+/* Function layoutFrame assigns the frame slots of
+ * the parameters and locals of function t, letting
+ * variables whose live ranges do not overlap share
+ * a slot. The bindings of the declarations and of
+ * every identifier in the body are updated; the
+ * frame size is returned. The names of the body
+ * must already be resolved
+ */
+int layoutFrame(TreeNode * t)
+{
+    Interval ** order;
+    int size = FRAME_HEADER;
+    int nParams = 0;
+    nVars = 0;
+    pos = 0;
+    for (TreeNode * p = t->child[0]; p != NULL; p = p->sibling)
+        if (isFrameVar(p)){
+            addVar(p);
+            /* parameters are live from the call */
+            vars[nParams].start = 0;
+            vars[nParams].end = 0;
+            vars[nParams].slot = FRAME_HEADER + nParams;
+            nParams++;
+        }
+    number(t->child[1]);
+    order = (Interval **)malloc((nVars + 1) * sizeof(Interval *));
+    for (int i = 0; i < nVars; i++){
+        if (vars[i].start < 0)
+            vars[i].start = vars[i].end = vars[i].declPos;
+        order[i] = &vars[i];
+    }
+    qsort(order, nVars, sizeof(Interval *), byStart);
+    /* first fit, the parameters are placed already */
+    for (int i = 0; i < nVars; i++){
+        Interval * v = order[i];
+        if (v->slot < 0){
+            v->slot = FRAME_HEADER;
+            for (int j = 0; j < i; j++){
+                if (overlaps(v, order[j])){
+                    v->slot = order[j]->slot + order[j]->width;
+                    j = -1; /* rescan from the start */
+                }
+            }
+        }
+        if (size < v->slot + v->width)
+            size = v->slot + v->width;
+    }
+    free(order);
+    for (int i = 0; i < nVars; i++){
+        /* element i of an array is at fp-memloc+i */
+        vars[i].decl->bind.offset = -(vars[i].slot + vars[i].width - 1);
+    }
+    rebind(t->child[1]);
+    return size;
+}
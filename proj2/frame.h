@@ -0,0 +1,21 @@
+/****************************************************/
+/* File: frame.h                                    */
+/* Frame layout interface for the C-MINUS compiler  */
+/* Compiler Construction: Principles and Practice   */
+/* Kenneth C. Louden                                */
+/****************************************************/
+
+#ifndef _FRAME_H_
+#define _FRAME_H_
+
+/* Function layoutFrame assigns the frame slots of
+ * the parameters and locals of function t, letting
+ * variables whose live ranges do not overlap share
+ * a slot. The bindings of the declarations and of
+ * every identifier in the body are updated; the
+ * frame size is returned. The names of the body
+ * must already be resolved
+ */
+int layoutFrame(TreeNode * t);
+
+#endif
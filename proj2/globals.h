@@ -52,7 +52,38 @@ typedef enum { CompoundStmtK, SelectionStmtK, IterationStmtK, ReturnStmtK, Simpl
 typedef enum { VarDeclK, ArrayDeclK, FuncDeclK, AssignK, OpK, IdK, ConstK } ExpKind;
 
 /* ExpType is used for type checking */
-typedef enum { Void, Integer, Boolean } ExpType;
+typedef enum { Void, Integer, Boolean, IntegerArray } ExpType;
+
+/* StorageKind tells where the storage an
+ * identifier resolves to lives
+ */
+typedef enum { UnboundK, GlobalK, LocalK, ParamK, FuncK, StaticFuncK, BuiltinK, VectorK } StorageKind;
+
+/* Binding is the storage of a declaration, copied
+ * into every identifier resolved to it so that the
+ * code generator need not consult the symbol table.
+ * offset is the displacement of the variable from
+ * gp (GlobalK) or fp (LocalK, ParamK); for a local or
+ * global array it is the address of element 0, for an
+ * array parameter the slot holding that address. A
+ * compiler temp holding an element address is bound
+ * like an array parameter where it is indexed.
+ * A FuncK has its frame on the stack, a StaticFuncK
+ * (never active twice at once) in global data at
+ * gp+frame, with slot k at gp+frame-k. The offset
+ * of a function is its code entry; offset and
+ * frame are set by the code generator. A VectorK
+ * is a vector op of the TM a loop was turned into,
+ * called with the arrays it writes and reads and
+ * the range of their elements it works on
+ */
+typedef struct
+{
+	StorageKind storage;
+	int offset;
+	int isArray;
+	int frame;
+} Binding;
 
 #define MAXCHILDREN 3
 
@@ -62,6 +93,10 @@ typedef struct treeNode
 	struct treeNode * child[MAXCHILDREN];
 	struct treeNode * sibling;
 	int lineno;
+	/* order of a branch or call among those of its
+	 * line; the two name it in a profile
+	 */
+	int site;
 	int isParam;
 	int size;
 	NodeKind nodekind;
@@ -72,6 +107,22 @@ typedef struct treeNode
 		char * name;
 	} attr;
 	ExpType type;
+	/* declaration an IdK or CallK resolves to,
+	 * filled in by semantic analysis
+	 */
+	struct treeNode * decl;
+	/* storage of a declaration or of the variable
+	 * an IdK resolves to, filled in by semantic analysis
+	 */
+	Binding bind;
+	/* SSA form of a function the code generator
+	 * works from instead of its body, or NULL
+	 */
+	struct irFunc * ir;
+	/* words a global starts with, computed at
+	 * compile time, or NULL for zeros
+	 */
+	int * init;
 } TreeNode;
 
 /**************************************************/
@@ -106,6 +157,29 @@ extern int TraceAnalyze;
 */
 extern int TraceCode;
 
+/* Library = TRUE compiles a module without main,
+* to be imported by other compilations
+*/
+extern int Library;
+
+/* UnrollFactor is the number of iterations of a
+* counted loop run by each pass of its unrolled
+* copy; 1 or less turns loop unrolling off
+*/
+extern int UnrollFactor;
+
+/* OptLevel selects the pipeline of optimization
+* passes: 0 runs none, 1 those over the syntax
+* tree, 2 also those over the SSA form, which the
+* code is then generated from
+*/
+extern int OptLevel;
+
+/* Memoize = TRUE makes pure recursive functions
+* keep a table of the values they returned
+*/
+extern int Memoize;
+
 /* Error = TRUE prevents further passes if an error occurs */
 extern int Error;
 #endif
\ No newline at end of file
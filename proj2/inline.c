@@ -0,0 +1,650 @@
+/****************************************************/
+/* File: inline.c                                   */
+/* Function inlining for the C-MINUS compiler       */
+/* A call is inlined by putting before the          */
+/* statement making it the assignments of the       */
+/* arguments to the parameters, now locals of the   */
+/* caller, and a copy of the body of the callee     */
+/* whose returns assign a local holding the value;  */
+/* the call becomes a read of that local. What the  */
+/* statement evaluates before the call must then    */
+/* not depend on the order, so it may only read     */
+/* constants and scalar locals. A body is first     */
+/* rearranged so that every return ends it: the     */
+/* statements after an if one branch of which       */
+/* returns move into the other branch. Callees      */
+/* are inlined into their callers before these are  */
+/* inlined in turn, as functions are declared       */
+/* before use                                       */
+/* Compiler Construction: Principles and Practice   */
+/* Kenneth C. Louden                                */
+/****************************************************/
+
+#include "globals.h"
+#include "util.h"
+#include "code.h"
+#include "cgen.h"
+#include "profile.h"
+#include "inline.h"
+
+/* a callee of at most INLINE_NODES nodes is
+ * inlined, one of LOOP_BONUS more for each loop
+ * around the call up to LOOP_LEVELS, as calls in
+ * loops run more often. Inlining stops once the
+ * program would exceed CODE_BUDGET TM instructions,
+ * leaving part of the IADDR_SIZE of the TM to
+ * later passes
+ */
+#define INLINE_NODES 12
+#define LOOP_BONUS 12
+#define LOOP_LEVELS 2
+#define CODE_BUDGET (IADDR_SIZE * 3 / 4)
+
+/* with an execution profile, a call that never
+ * ran is not inlined, and one run HOT_CALLS times
+ * or more is given the bonus of a call LOOP_LEVELS
+ * loops deep wherever it is
+ */
+#define HOT_CALLS 64
+
+/* the program, the size of its code and whether
+ * the budget is spent
+ */
+static TreeNode * program;
+static int size;
+static int spent;
+
+/* the function calls are inlined into */
+static TreeNode * func;
+
+/* what a callee qualifies as: nodes is -1 when it
+ * can never be inlined
+ */
+typedef struct
+{
+    TreeNode * decl;
+    int nodes;
+} CalleeRec;
+
+static CalleeRec * callees = NULL;
+static int nCallees = 0, maxCallees = 0;
+
+/* what a declaration of the callee becomes in the
+ * caller: a variable of the caller, or an argument
+ * read in its place
+ */
+typedef struct
+{
+    TreeNode * decl;
+    TreeNode * var;
+    TreeNode * arg;
+} MapRec;
+
+static MapRec * map = NULL;
+static int nMap = 0, maxMap = 0;
+
+/* functions visited looking for recursion */
+static TreeNode ** visited = NULL;
+static int nVisited = 0, maxVisited = 0;
+
+static void * grow(void * array, int n, int * max, int size)
+{
+    if (n < *max)
+        return array;
+    *max = (*max == 0) ? 16 : 2 * *max;
+    array = realloc(array, *max * size);
+    if (array == NULL){
+        fprintf(listing, "Out of memory error at line %d\n", lineno);
+        exit(-1);
+    }
+    return array;
+}
+
+static int isBinary(TreeNode * t)
+{
+    return t->nodekind == StmtK && (t->kind.stmt == SimpleStmtK ||
+        t->kind.stmt == AdditiveStmtK || t->kind.stmt == TermK);
+}
+
+/* Function isLocal tells whether t reads a
+ * scalar local or parameter, which no callee
+ * can change
+ */
+static int isLocal(TreeNode * t)
+{
+    return t->nodekind == ExpK && t->kind.exp == IdK && !t->bind.isArray &&
+        t->child[0] == NULL &&
+        (t->bind.storage == LocalK || t->bind.storage == ParamK);
+}
+
+static int countNodes(TreeNode * t)
+{
+    int n = 0;
+    for (; t != NULL; t = t->sibling){
+        n++;
+        for (int i = 0; i < MAXCHILDREN; i++)
+            n += countNodes(t->child[i]);
+    }
+    return n;
+}
+
+/* Function reaches tells whether the code of tree
+ * may call function f, directly or not
+ */
+static int reaches(TreeNode * tree, TreeNode * f)
+{
+    for (; tree != NULL; tree = tree->sibling){
+        if (isStmt(tree, CallK) && tree->decl->bind.storage != BuiltinK){
+            TreeNode * g = tree->decl;
+            int i;
+            if (g == f)
+                return TRUE;
+            for (i = 0; i < nVisited; i++)
+                if (visited[i] == g)
+                    break;
+            if (i == nVisited){
+                visited = grow(visited, nVisited, &maxVisited, sizeof(TreeNode *));
+                visited[nVisited++] = g;
+                if (reaches(g->child[1], f))
+                    return TRUE;
+            }
+        }
+        for (int i = 0; i < MAXCHILDREN; i++)
+            if (reaches(tree->child[i], f))
+                return TRUE;
+    }
+    return FALSE;
+}
+
+static int hasReturn(TreeNode * t)
+{
+    if (t == NULL)
+        return FALSE;
+    if (isStmt(t, ReturnStmtK))
+        return TRUE;
+    for (int i = 0; i < MAXCHILDREN; i++)
+        for (TreeNode * c = t->child[i]; c != NULL; c = c->sibling)
+            if (hasReturn(c))
+                return TRUE;
+    return FALSE;
+}
+
+/* Function alwaysReturns tells whether every path
+ * through a list of statements returns
+ */
+static int alwaysReturns(TreeNode * t)
+{
+    for (; t != NULL; t = t->sibling){
+        if (isStmt(t, ReturnStmtK))
+            return TRUE;
+        if (isStmt(t, SelectionStmtK) &&
+            alwaysReturns(t->child[1]) && alwaysReturns(t->child[2]))
+            return TRUE;
+    }
+    return FALSE;
+}
+
+static void append(TreeNode ** loc, TreeNode * t)
+{
+    while (*loc != NULL)
+        loc = &(*loc)->sibling;
+    *loc = t;
+}
+
+/* Function flatten splices the compound
+ * statements of a list, and of the branches of
+ * its if statements, into them, releasing their
+ * declarations, and returns the list
+ */
+static TreeNode * flatten(TreeNode * t)
+{
+    TreeNode * head = NULL, ** last = &head;
+    while (t != NULL){
+        TreeNode * next = t->sibling;
+        t->sibling = NULL;
+        if (isStmt(t, CompoundStmtK)){
+            TreeNode * stmts = flatten(t->child[1]);
+            t->child[1] = NULL;
+            freeTree(t);
+            t = stmts;
+        }
+        else if (isStmt(t, SelectionStmtK)){
+            t->child[1] = flatten(t->child[1]);
+            t->child[2] = flatten(t->child[2]);
+        }
+        else if (isStmt(t, IterationStmtK) && isStmt(t->child[1], CompoundStmtK))
+            t->child[1]->child[1] = flatten(t->child[1]->child[1]);
+        *last = t;
+        while (*last != NULL)
+            last = &(*last)->sibling;
+        t = next;
+    }
+    return head;
+}
+
+/* Function restructure rearranges a flattened
+ * list of statements so that every return in it
+ * is last on its path, and tells whether it could:
+ * a return inside a loop cannot be moved
+ */
+static int restructure(TreeNode * t)
+{
+    for (; t != NULL; t = t->sibling){
+        if (!hasReturn(t))
+            continue;
+        if (isStmt(t, ReturnStmtK)){
+            /* what follows never runs */
+            freeTree(t->sibling);
+            t->sibling = NULL;
+            return TRUE;
+        }
+        if (!isStmt(t, SelectionStmtK))
+            return FALSE;
+        if (t->sibling != NULL){
+            if (alwaysReturns(t->child[1]))
+                append(&t->child[2], t->sibling);
+            else if (alwaysReturns(t->child[2]))
+                append(&t->child[1], t->sibling);
+            else
+                return FALSE;
+            t->sibling = NULL;
+        }
+        return restructure(t->child[1]) && restructure(t->child[2]);
+    }
+    return TRUE;
+}
+
+/* Function inProgram tells whether f is defined
+ * by the program rather than imported
+ */
+static int inProgram(TreeNode * f)
+{
+    for (TreeNode * t = program; t != NULL; t = t->sibling)
+        if (t == f)
+            return t->child[1] != NULL;
+    return FALSE;
+}
+
+/* Function calleeNodes returns the size of the
+ * body of function f in nodes, -1 if it cannot be
+ * inlined: it is imported, recursive, or returns
+ * from inside a loop
+ */
+static int calleeNodes(TreeNode * f)
+{
+    TreeNode * body;
+    int ok;
+    for (int i = 0; i < nCallees; i++)
+        if (callees[i].decl == f)
+            return callees[i].nodes;
+    callees = grow(callees, nCallees, &maxCallees, sizeof(CalleeRec));
+    callees[nCallees].decl = f;
+    callees[nCallees].nodes = -1;
+    if (inProgram(f)){
+        nVisited = 0;
+        body = copyTree(f->child[1]);
+        body->child[1] = flatten(body->child[1]);
+        ok = !reaches(f->child[1], f) && restructure(body->child[1]);
+        freeTree(body);
+        if (ok)
+            callees[nCallees].nodes = countNodes(f->child[1]);
+    }
+    return callees[nCallees++].nodes;
+}
+
+/* Function wanted tells whether call is worth
+ * inlining depth loops deep
+ */
+static int wanted(TreeNode * call, int depth)
+{
+    int nodes;
+    long runs;
+    if (spent || call->decl->bind.storage == BuiltinK)
+        return FALSE;
+    runs = profileCalls(call->lineno, call->site, call->decl->attr.name);
+    if (runs == 0)
+        return FALSE;
+    if (runs >= HOT_CALLS)
+        depth = LOOP_LEVELS;
+    nodes = calleeNodes(call->decl);
+    if (depth > LOOP_LEVELS)
+        depth = LOOP_LEVELS;
+    return nodes >= 0 && nodes <= INLINE_NODES + depth * LOOP_BONUS;
+}
+
+/* Function findSite returns where in the
+ * expression at loc the first call worth inlining
+ * is, NULL if there is none; safe is cleared once
+ * something was evaluated that must stay after
+ * the calls following it
+ */
+static TreeNode ** findSite(TreeNode ** loc, int depth, int * safe)
+{
+    TreeNode * t = *loc, ** site;
+    if (t == NULL || !*safe)
+        return NULL;
+    if (t->nodekind == StmtK){
+        if (t->kind.stmt == CallK){
+            if (wanted(t, depth))
+                return loc;
+            for (TreeNode ** a = &t->child[0]; *a != NULL; a = &(*a)->sibling)
+                if ((site = findSite(a, depth, safe)) != NULL)
+                    return site;
+            *safe = FALSE;
+            return NULL;
+        }
+        if (isBinary(t)){
+            if ((site = findSite(&t->child[0], depth, safe)) != NULL)
+                return site;
+            return findSite(&t->child[2], depth, safe);
+        }
+        *safe = FALSE;
+        return NULL;
+    }
+    switch (t->kind.exp){
+        case ConstK:
+            return NULL;
+        case IdK:
+            if (isLocal(t) || (t->bind.isArray && t->child[0] == NULL))
+                return NULL;
+            if (t->child[0] != NULL && (site = findSite(&t->child[0], depth, safe)) != NULL)
+                return site;
+            *safe = FALSE;
+            return NULL;
+        case AssignK:
+            if (t->child[0]->child[0] != NULL && !isConst(t->child[0]->child[0]) &&
+                (site = findSite(&t->child[0]->child[0], depth, safe)) != NULL)
+                return site;
+            if ((site = findSite(&t->child[1], depth, safe)) != NULL)
+                return site;
+            *safe = FALSE;
+            return NULL;
+        default:
+            *safe = FALSE;
+            return NULL;
+    }
+}
+
+/* Function newVar declares a local of the caller
+ * standing for declaration decl of callee f, an
+ * element address for an array parameter, and
+ * returns its declaration
+ */
+static TreeNode * newVar(TreeNode * f, TreeNode * decl)
+{
+    TreeNode * v = newExpNode(VarDeclK);
+    TreeNode ** last = &func->child[1]->child[0];
+    v->attr.name = malloc(strlen(f->attr.name) + strlen(decl->attr.name) + 2);
+    if (v->attr.name == NULL){
+        fprintf(listing, "Out of memory error at line %d\n", lineno);
+        exit(-1);
+    }
+    sprintf(v->attr.name, "%s.%s", f->attr.name, decl->attr.name);
+    v->lineno = decl->lineno;
+    v->type = Integer;
+    v->bind.storage = LocalK;
+    if (decl->kind.exp == ArrayDeclK && !decl->isParam){
+        /* element i is at fp-memloc+i */
+        v->kind.exp = ArrayDeclK;
+        v->size = decl->size;
+        v->bind.isArray = TRUE;
+        v->bind.offset = -(func->size + decl->size - 1);
+        func->size += decl->size;
+    }
+    else
+        v->bind.offset = -func->size++;
+    while (*last != NULL)
+        last = &(*last)->sibling;
+    *last = v;
+    return v;
+}
+
+static void addMap(TreeNode * decl, TreeNode * var, TreeNode * arg)
+{
+    map = grow(map, nMap, &maxMap, sizeof(MapRec));
+    map[nMap].decl = decl;
+    map[nMap].var = var;
+    map[nMap++].arg = arg;
+}
+
+/* Procedure mapLocals gives the locals declared
+ * in the compound statements of tree, in the body
+ * of callee f, variables of the caller, releasing
+ * their declarations in copy, the copy of tree.
+ * The identifiers of the copy still name the
+ * declarations of the callee, so these are mapped
+ */
+static void mapLocals(TreeNode * f, TreeNode * tree, TreeNode * copy)
+{
+    for (; tree != NULL && copy != NULL; tree = tree->sibling, copy = copy->sibling){
+        if (isStmt(tree, CompoundStmtK)){
+            for (TreeNode * d = tree->child[0]; d != NULL; d = d->sibling)
+                addMap(d, newVar(f, d), NULL);
+            freeTree(copy->child[0]);
+            copy->child[0] = NULL;
+        }
+        for (int i = 0; i < MAXCHILDREN; i++)
+            mapLocals(f, tree->child[i], copy->child[i]);
+    }
+}
+
+/* Procedure renameIds makes the identifiers of a
+ * copied body at loc name what the declarations
+ * of the callee became
+ */
+static void renameIds(TreeNode ** loc)
+{
+    for (; *loc != NULL; loc = &(*loc)->sibling){
+        TreeNode * t = *loc;
+        for (int i = 0; i < MAXCHILDREN; i++)
+            renameIds(&t->child[i]);
+        if (t->nodekind != ExpK || t->kind.exp != IdK)
+            continue;
+        for (int i = 0; i < nMap; i++){
+            TreeNode * to = (map[i].var != NULL) ? map[i].var : map[i].arg;
+            if (map[i].decl != t->decl)
+                continue;
+            if (to->kind.exp == ConstK || (to->kind.exp == IdK && !to->bind.isArray)){
+                TreeNode * r = copyTree(to);
+                r->lineno = t->lineno;
+                r->sibling = t->sibling;
+                t->sibling = NULL;
+                freeTree(t);
+                *loc = t = r;
+                break;
+            }
+            free(t->attr.name);
+            t->attr.name = copyString(to->attr.name);
+            t->bind = to->bind;
+            t->decl = (to->kind.exp == IdK) ? to->decl : to;
+            /* an array parameter holds an element address */
+            if (map[i].decl->kind.exp == ArrayDeclK && map[i].decl->isParam &&
+                map[i].var != NULL){
+                t->bind.storage = ParamK;
+                t->bind.isArray = TRUE;
+            }
+            break;
+        }
+    }
+}
+
+/* Procedure replaceReturns turns the returns
+ * ending the restructured list at loc into
+ * assignments to result, or into expression
+ * statements when there is none
+ */
+static void replaceReturns(TreeNode ** loc, TreeNode * result)
+{
+    TreeNode * t;
+    if (*loc == NULL)
+        return;
+    while ((*loc)->sibling != NULL)
+        loc = &(*loc)->sibling;
+    t = *loc;
+    if (isStmt(t, SelectionStmtK)){
+        replaceReturns(&t->child[1], result);
+        replaceReturns(&t->child[2], result);
+    }
+    else if (isStmt(t, ReturnStmtK)){
+        TreeNode * value = t->child[0];
+        t->child[0] = NULL;
+        freeTree(t);
+        if (value != NULL && result != NULL)
+            value = newAssign(newTempId(result, value->lineno), value);
+        *loc = value;
+    }
+}
+
+/* Function inlineCall inlines the call at site in
+ * the statement at loc and tells whether the code
+ * still fits; the statements put in its place are
+ * then looked at for calls again, those of the
+ * arguments among them
+ */
+static int inlineCall(TreeNode ** loc, TreeNode ** site)
+{
+    TreeNode * s = *loc, * call = *site, * f = call->decl;
+    TreeNode * next = s->sibling, * backup, * body, * result = NULL;
+    TreeNode * head = NULL, ** last = &head, ** decls, * arg, * p;
+    int savedSize = func->size, after;
+    /* a copy to go back to */
+    s->sibling = NULL;
+    backup = copyTree(s);
+    s->sibling = next;
+    for (decls = &func->child[1]->child[0]; *decls != NULL; decls = &(*decls)->sibling)
+        ;
+    nMap = 0;
+    body = copyTree(f->child[1]);
+    arg = call->child[0];
+    call->child[0] = NULL;
+    for (p = f->child[0]; p != NULL && arg != NULL; p = p->sibling){
+        TreeNode * a = arg;
+        arg = arg->sibling;
+        a->sibling = NULL;
+        /* an argument the body could read in place
+         * of the parameter needs no local
+         */
+        if (!assigns(body, p) && (isConst(a) || isLocal(a) ||
+            (a->kind.exp == IdK && a->bind.isArray && a->child[0] == NULL)))
+            addMap(p, NULL, a);
+        else {
+            TreeNode * v = newVar(f, p);
+            addMap(p, v, NULL);
+            *last = newAssign(newTempId(v, a->lineno), a);
+            last = &(*last)->sibling;
+        }
+    }
+    mapLocals(f, f->child[1], body);
+    renameIds(&body->child[1]);
+    body->child[1] = flatten(body->child[1]);
+    restructure(body->child[1]);
+    if (s != call && f->type != Void)
+        result = newVar(f, f);
+    replaceReturns(&body->child[1], result);
+    *last = body->child[1];
+    body->child[1] = NULL;
+    freeTree(body);
+    while (*last != NULL)
+        last = &(*last)->sibling;
+    for (int i = 0; i < nMap; i++)
+        freeTree(map[i].arg);
+    if (s == call){
+        s->sibling = NULL;
+        freeTree(s);
+    }
+    else {
+        TreeNode * id = newTempId(result, call->lineno);
+        id->sibling = call->sibling;
+        call->sibling = NULL;
+        freeTree(call);
+        *site = id;
+    }
+    *last = (s == call) ? next : s;
+    *loc = head;
+    after = codeSize(program);
+    if (after > CODE_BUDGET){
+        /* put back the statement as it was */
+        for (TreeNode * t = *loc; t != next; ){
+            TreeNode * n = t->sibling;
+            t->sibling = NULL;
+            freeTree(t);
+            t = n;
+        }
+        backup->sibling = next;
+        *loc = backup;
+        freeTree(*decls);
+        *decls = NULL;
+        func->size = savedSize;
+        spent = TRUE;
+        return FALSE;
+    }
+    freeTree(backup);
+    size = after;
+    return TRUE;
+}
+
+/* Procedure inlineStmts inlines the calls of a
+ * list of statements depth loops deep
+ */
+static void inlineStmts(TreeNode ** loc, int depth)
+{
+    while (*loc != NULL){
+        TreeNode * t = *loc;
+        TreeNode ** exp = loc, ** site;
+        int safe = TRUE;
+        if (t->nodekind == StmtK)
+            switch (t->kind.stmt){
+                case CompoundStmtK:
+                    inlineStmts(&t->child[1], depth);
+                    exp = NULL;
+                    break;
+                case SelectionStmtK:
+                    inlineStmts(&t->child[1], depth);
+                    inlineStmts(&t->child[2], depth);
+                    exp = &t->child[0];
+                    break;
+                case IterationStmtK:
+                    inlineStmts(&t->child[1], depth + 1);
+                    exp = NULL;
+                    break;
+                case ReturnStmtK:
+                    exp = &t->child[0];
+                    break;
+                default:
+                    break;
+            }
+        if (exp != NULL && (site = findSite(exp, depth, &safe)) != NULL &&
+            inlineCall(loc, site))
+            continue;
+        loc = &(*loc)->sibling;
+    }
+}
+
+/* Procedure inlineCalls replaces the calls of
+ * small functions that are not recursive by a
+ * copy of their bodies, put before the statement
+ * making the call, with the parameters and locals
+ * of the callee moved into the frame of the
+ * caller. A callee qualifies by its size, more
+ * readily inside loops or at calls an execution
+ * profile finds hot, and only while the code fits
+ * in a budget below the TM instruction memory
+ */
+void inlineCalls(TreeNode * syntaxTree)
+{
+    program = syntaxTree;
+    size = codeSize(syntaxTree);
+    spent = (size > CODE_BUDGET);
+    for (TreeNode * t = syntaxTree; t != NULL; t = t->sibling)
+        if (t->kind.exp == FuncDeclK){
+            func = t;
+            inlineStmts(&t->child[1]->child[1], 0);
+        }
+    free(callees);
+    free(map);
+    free(visited);
+    callees = NULL;
+    map = NULL;
+    visited = NULL;
+    nCallees = maxCallees = maxMap = maxVisited = 0;
+}
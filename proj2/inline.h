@@ -0,0 +1,23 @@
+/****************************************************/
+/* File: inline.h                                   */
+/* Function inlining for the C-MINUS compiler       */
+/* Compiler Construction: Principles and Practice   */
+/* Kenneth C. Louden                                */
+/****************************************************/
+
+#ifndef _INLINE_H_
+#define _INLINE_H_
+
+/* Procedure inlineCalls replaces the calls of
+ * small functions that are not recursive by a
+ * copy of their bodies, put before the statement
+ * making the call, with the parameters and locals
+ * of the callee moved into the frame of the
+ * caller. A callee qualifies by its size, more
+ * readily inside loops or at calls an execution
+ * profile finds hot, and only while the code fits
+ * in a budget below the TM instruction memory
+ */
+void inlineCalls(TreeNode * syntaxTree);
+
+#endif
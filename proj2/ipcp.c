@@ -0,0 +1,484 @@
+/****************************************************/
+/* File: ipcp.c                                     */
+/* Interprocedural constant propagation for the     */
+/* C-MINUS compiler                                 */
+/* A parameter every call of its function passes    */
+/* the same constant is dropped: the calls stop     */
+/* passing it and the body reads the constant,      */
+/* which may make arguments of the calls in the     */
+/* body constant in turn, so this is repeated until */
+/* nothing changes. A call passing constants that   */
+/* the callee tests on then goes to a copy of the   */
+/* callee specialized for them, whose tests the     */
+/* folder can decide. A copy is placed right after  */
+/* the function copied, as names are declared       */
+/* before use                                       */
+/* Compiler Construction: Principles and Practice   */
+/* Kenneth C. Louden                                */
+/****************************************************/
+
+#include "globals.h"
+#include "util.h"
+#include "code.h"
+#include "cgen.h"
+#include "frame.h"
+#include "fold.h"
+#include "ipcp.h"
+
+/* a function gets at most MAX_CLONES copies and
+ * only while the program fits in CODE_BUDGET TM
+ * instructions; only the first MAX_PARAMS
+ * parameters of a function are looked at
+ */
+#define MAX_CLONES 4
+#define CODE_BUDGET (IADDR_SIZE * 3 / 4)
+#define MAX_PARAMS 32
+
+/* what the calls seen pass for a parameter */
+typedef enum { Unknown, Constant, Varying } ArgState;
+
+/* a function of the program: for a copy, the
+ * function copied and the parameters of that one
+ * it fixes, as a mask and their values
+ */
+typedef struct
+{
+    TreeNode * node;
+    TreeNode * orig;
+    unsigned fixed;
+    int vals[MAX_PARAMS];
+    int nClones;
+    ArgState state[MAX_PARAMS];
+    int val[MAX_PARAMS];
+} FuncRec;
+
+static FuncRec * funcs = NULL;
+static int nFuncs = 0, maxFuncs = 0;
+
+/* the declarations of a function and those of
+ * its copy
+ */
+typedef struct
+{
+    TreeNode * from;
+    TreeNode * to;
+} MapRec;
+
+static MapRec * map = NULL;
+static int nMap = 0, maxMap = 0;
+
+static TreeNode * program;
+static int spent;
+
+static void * grow(void * array, int n, int * max, int size)
+{
+    if (n < *max)
+        return array;
+    *max = (*max == 0) ? 16 : 2 * *max;
+    array = realloc(array, *max * size);
+    if (array == NULL){
+        fprintf(listing, "Out of memory error at line %d\n", lineno);
+        exit(-1);
+    }
+    return array;
+}
+
+static int isId(TreeNode * t)
+{
+    return t != NULL && t->nodekind == ExpK && t->kind.exp == IdK;
+}
+
+static void addFunc(TreeNode * t, TreeNode * orig)
+{
+    funcs = grow(funcs, nFuncs, &maxFuncs, sizeof(FuncRec));
+    funcs[nFuncs].node = t;
+    funcs[nFuncs].orig = orig;
+    funcs[nFuncs].fixed = 0;
+    funcs[nFuncs].nClones = 0;
+    nFuncs++;
+}
+
+/* Function findFunc returns the record of
+ * function f, NULL if it is not in the program
+ */
+static FuncRec * findFunc(TreeNode * f)
+{
+    for (int i = 0; i < nFuncs; i++)
+        if (funcs[i].node == f)
+            return &funcs[i];
+    return NULL;
+}
+
+static TreeNode * param(TreeNode * f, int i)
+{
+    TreeNode * p = f->child[0];
+    while (p != NULL && i-- > 0)
+        p = p->sibling;
+    return p;
+}
+
+static int isScalarParam(TreeNode * p)
+{
+    return p != NULL && p->kind.exp == VarDeclK;
+}
+
+/* Procedure meetCalls merges what the calls in
+ * subtree t of function caller pass into the
+ * states of the parameters of their callees. A
+ * recursive call passing a parameter on in its
+ * own place passes nothing new
+ */
+static void meetCalls(TreeNode * t, TreeNode * caller)
+{
+    for (; t != NULL; t = t->sibling){
+        for (int i = 0; i < MAXCHILDREN; i++)
+            meetCalls(t->child[i], caller);
+        if (isStmt(t, CallK)){
+            FuncRec * f = findFunc(t->decl);
+            TreeNode * a = t->child[0];
+            if (f == NULL)
+                continue;
+            for (int i = 0; i < MAX_PARAMS && a != NULL; i++, a = a->sibling){
+                if (isConst(a)){
+                    if (f->state[i] == Unknown){
+                        f->state[i] = Constant;
+                        f->val[i] = a->attr.val;
+                    }
+                    else if (f->state[i] == Constant && f->val[i] != a->attr.val)
+                        f->state[i] = Varying;
+                }
+                else if (!(isId(a) && caller == f->node &&
+                           a->decl == param(f->node, i) && a->child[0] == NULL))
+                    f->state[i] = Varying;
+            }
+        }
+    }
+}
+
+/* Procedure removeArgs drops argument i of the
+ * calls of f in a subtree
+ */
+static void removeArgs(TreeNode * t, TreeNode * f, int i)
+{
+    for (; t != NULL; t = t->sibling){
+        for (int k = 0; k < MAXCHILDREN; k++)
+            removeArgs(t->child[k], f, i);
+        if (isStmt(t, CallK) && t->decl == f){
+            TreeNode ** a = &t->child[0];
+            for (int k = 0; k < i && *a != NULL; k++)
+                a = &(*a)->sibling;
+            if (*a != NULL){
+                TreeNode * arg = *a;
+                *a = arg->sibling;
+                arg->sibling = NULL;
+                freeTree(arg);
+            }
+        }
+    }
+}
+
+/* Procedure replaceReads makes the reads of decl
+ * in the list at loc read the constant val
+ */
+static void replaceReads(TreeNode ** loc, TreeNode * decl, int val)
+{
+    for (; *loc != NULL; loc = &(*loc)->sibling){
+        TreeNode * t = *loc;
+        for (int i = 0; i < MAXCHILDREN; i++)
+            replaceReads(&t->child[i], decl, val);
+        if (isId(t) && t->decl == decl){
+            TreeNode * c = newConst(val, t->lineno);
+            c->sibling = t->sibling;
+            t->sibling = NULL;
+            freeTree(t);
+            *loc = c;
+        }
+    }
+}
+
+/* Procedure dropParam removes parameter i of
+ * function f, which now always has value val. A
+ * parameter the body assigns becomes a local set
+ * to val on entry; the frame is laid out again
+ */
+static void dropParam(TreeNode * f, int i, int val)
+{
+    TreeNode ** loc = &f->child[0];
+    TreeNode * p, * body = f->child[1];
+    for (int k = 0; k < i; k++)
+        loc = &(*loc)->sibling;
+    p = *loc;
+    *loc = p->sibling;
+    p->sibling = NULL;
+    for (TreeNode * t = program; t != NULL; t = t->sibling)
+        if (t->kind.exp == FuncDeclK)
+            removeArgs(t->child[1], f, i);
+    if (assigns(body, p)){
+        TreeNode * s = newAssign(newTempId(p, p->lineno), newConst(val, p->lineno));
+        p->isParam = FALSE;
+        p->bind.storage = LocalK;
+        p->sibling = body->child[0];
+        body->child[0] = p;
+        s->sibling = body->child[1];
+        body->child[1] = s;
+    }
+    else {
+        replaceReads(&body->child[1], p, val);
+        freeTree(p);
+    }
+    f->size = layoutFrame(f);
+}
+
+/* Function propagate drops the parameters every
+ * call passes the same constant, until there are
+ * none left, and tells whether any was dropped
+ */
+static int propagate(void)
+{
+    int changed, any = FALSE;
+    do {
+        changed = FALSE;
+        foldConstants(program);
+        for (int k = 0; k < nFuncs; k++)
+            for (int i = 0; i < MAX_PARAMS; i++)
+                funcs[k].state[i] = Unknown;
+        for (int k = 0; k < nFuncs; k++)
+            meetCalls(funcs[k].node->child[1], funcs[k].node);
+        for (int k = 0; k < nFuncs; k++)
+            for (int i = MAX_PARAMS - 1; i >= 0; i--)
+                if (funcs[k].state[i] == Constant && isScalarParam(param(funcs[k].node, i))){
+                    dropParam(funcs[k].node, i, funcs[k].val[i]);
+                    changed = any = TRUE;
+                }
+    } while (changed);
+    return any;
+}
+
+/* Function tested tells whether the test of an
+ * if or while statement in a subtree reads decl
+ */
+static int tested(TreeNode * t, TreeNode * decl, int inTest)
+{
+    for (; t != NULL; t = t->sibling){
+        if (inTest && isId(t) && t->decl == decl)
+            return TRUE;
+        for (int i = 0; i < MAXCHILDREN; i++){
+            int test = inTest || (i == 0 && (isStmt(t, SelectionStmtK) ||
+                                             isStmt(t, IterationStmtK)));
+            if (tested(t->child[i], decl, test))
+                return TRUE;
+        }
+    }
+    return FALSE;
+}
+
+/* Function precedes tells whether function f
+ * comes before function g in the program
+ */
+static int precedes(TreeNode * f, TreeNode * g)
+{
+    for (TreeNode * t = program; t != NULL; t = t->sibling){
+        if (t == f)
+            return TRUE;
+        if (t == g)
+            return FALSE;
+    }
+    return FALSE;
+}
+
+static void mapDecls(TreeNode * from, TreeNode * to)
+{
+    for (; from != NULL && to != NULL; from = from->sibling, to = to->sibling){
+        if (from->nodekind == ExpK &&
+            (from->kind.exp == VarDeclK || from->kind.exp == ArrayDeclK)){
+            map = grow(map, nMap, &maxMap, sizeof(MapRec));
+            map[nMap].from = from;
+            map[nMap++].to = to;
+        }
+        for (int i = 0; i < MAXCHILDREN; i++)
+            mapDecls(from->child[i], to->child[i]);
+    }
+}
+
+/* Procedure redirect makes the identifiers of a
+ * copied body resolve to the declarations of the
+ * copy
+ */
+static void redirect(TreeNode * t)
+{
+    for (; t != NULL; t = t->sibling){
+        for (int i = 0; i < MAXCHILDREN; i++)
+            redirect(t->child[i]);
+        if (isId(t))
+            for (int i = 0; i < nMap; i++)
+                if (map[i].from == t->decl){
+                    t->decl = map[i].to;
+                    break;
+                }
+    }
+}
+
+static void specializeCalls(TreeNode * t, FuncRec * h);
+
+/* Function newClone places after function f a
+ * copy of it with the parameters in mask fixed to
+ * vals and returns its record, NULL if the code
+ * would no longer fit
+ */
+static FuncRec * newClone(FuncRec * f, unsigned mask, int * vals)
+{
+    TreeNode * orig = f->node, * next = orig->sibling, * copy, * t;
+    char * name;
+    int n = ++f->nClones;
+    orig->sibling = NULL;
+    copy = copyTree(orig);
+    orig->sibling = next;
+    nMap = 0;
+    mapDecls(orig->child[0], copy->child[0]);
+    mapDecls(orig->child[1], copy->child[1]);
+    redirect(copy->child[1]);
+    name = malloc(strlen(orig->attr.name) + 12);
+    if (name == NULL){
+        fprintf(listing, "Out of memory error at line %d\n", lineno);
+        exit(-1);
+    }
+    sprintf(name, "%s.%d", orig->attr.name, n);
+    free(copy->attr.name);
+    copy->attr.name = name;
+    /* after the copies made before */
+    for (t = orig; t->sibling != NULL; t = t->sibling){
+        FuncRec * g = findFunc(t->sibling);
+        if (g == NULL || g->orig != orig)
+            break;
+    }
+    copy->sibling = t->sibling;
+    t->sibling = copy;
+    addFunc(copy, orig);
+    funcs[nFuncs - 1].fixed = mask;
+    for (int i = 0; i < MAX_PARAMS; i++)
+        funcs[nFuncs - 1].vals[i] = vals[i];
+    for (int i = MAX_PARAMS - 1; i >= 0; i--)
+        if (mask & (1u << i))
+            dropParam(copy, i, vals[i]);
+    copy->child[1] = foldStatements(copy->child[1]);
+    /* its recursive calls may call it */
+    specializeCalls(copy->child[1], &funcs[nFuncs - 1]);
+    if (codeSize(program) > CODE_BUDGET){
+        t->sibling = copy->sibling;
+        copy->sibling = NULL;
+        freeTree(copy);
+        nFuncs--;
+        spent = TRUE;
+        return NULL;
+    }
+    return &funcs[nFuncs - 1];
+}
+
+/* Function familyOf tells whether function g is
+ * function f or a copy of it
+ */
+static int familyOf(TreeNode * g, TreeNode * f)
+{
+    FuncRec * r = findFunc(g);
+    return g == f || (r != NULL && r->orig == f);
+}
+
+/* Procedure specializeCalls sends the calls in
+ * subtree t of function h that pass constants
+ * their callee tests on to a copy of the callee
+ * fixing them, made for the first such call. A
+ * copy must come before the caller, so calls in
+ * the callee and its copies only go to copies
+ * made already, or to the copy they are in
+ */
+static void specializeCalls(TreeNode * t, FuncRec * h)
+{
+    for (; t != NULL; t = t->sibling){
+        FuncRec * f, * c = NULL;
+        TreeNode * a, * target;
+        unsigned mask = 0;
+        int vals[MAX_PARAMS];
+        int i, k;
+        for (i = 0; i < MAXCHILDREN; i++)
+            specializeCalls(t->child[i], h);
+        if (!isStmt(t, CallK) || (f = findFunc(t->decl)) == NULL || f->orig != NULL)
+            continue;
+        a = t->child[0];
+        for (i = 0; i < MAX_PARAMS && a != NULL; i++, a = a->sibling){
+            TreeNode * p = param(f->node, i);
+            vals[i] = 0;
+            if (isConst(a) && isScalarParam(p) && tested(f->node->child[1], p, FALSE)){
+                mask |= 1u << i;
+                vals[i] = a->attr.val;
+            }
+        }
+        for (; i < MAX_PARAMS; i++)
+            vals[i] = 0;
+        if (mask == 0)
+            continue;
+        for (k = 0; k < nFuncs && c == NULL; k++)
+            if (funcs[k].orig == f->node && funcs[k].fixed == mask &&
+                memcmp(funcs[k].vals, vals, sizeof(vals)) == 0)
+                c = &funcs[k];
+        if (c == NULL && !spent && f->nClones < MAX_CLONES && !familyOf(h->node, f->node)){
+            /* the records may move */
+            TreeNode * caller = h->node;
+            c = newClone(f, mask, vals);
+            h = findFunc(caller);
+        }
+        if (c == NULL)
+            continue;
+        target = c->node;
+        if (target != h->node && !precedes(target, h->node))
+            continue;
+        for (i = MAX_PARAMS - 1; i >= 0; i--)
+            if (mask & (1u << i)){
+                TreeNode ** arg = &t->child[0];
+                for (k = 0; k < i; k++)
+                    arg = &(*arg)->sibling;
+                a = *arg;
+                *arg = a->sibling;
+                a->sibling = NULL;
+                freeTree(a);
+            }
+        t->decl = target;
+        free(t->attr.name);
+        t->attr.name = copyString(target->attr.name);
+    }
+}
+
+/* Procedure propagateArguments drops the
+ * parameters of the functions of an analyzed
+ * program that every call passes the same
+ * constant, reading the constant in their place,
+ * and sends calls passing constants their callee
+ * tests on to a copy of the callee specialized
+ * for them, while the code fits in a budget below
+ * the TM instruction memory. A library is left
+ * alone, as it is called from outside
+ */
+void propagateArguments(TreeNode * syntaxTree)
+{
+    if (Library)
+        return;
+    program = syntaxTree;
+    spent = FALSE;
+    if (codeSize(program) > CODE_BUDGET)
+        return;
+    nFuncs = 0;
+    for (TreeNode * t = syntaxTree; t != NULL; t = t->sibling)
+        if (t->kind.exp == FuncDeclK && t->child[1] != NULL)
+            addFunc(t, NULL);
+    propagate();
+    /* copies are appended, and visited while made */
+    for (int k = 0; k < nFuncs; k++)
+        if (funcs[k].orig == NULL)
+            specializeCalls(funcs[k].node->child[1], &funcs[k]);
+    /* the copies may fix what their callees get */
+    propagate();
+    free(funcs);
+    free(map);
+    funcs = NULL;
+    map = NULL;
+    nFuncs = maxFuncs = nMap = maxMap = 0;
+}
@@ -0,0 +1,24 @@
+/****************************************************/
+/* File: ipcp.h                                     */
+/* Interprocedural constant propagation for the     */
+/* C-MINUS compiler                                 */
+/* Compiler Construction: Principles and Practice   */
+/* Kenneth C. Louden                                */
+/****************************************************/
+
+#ifndef _IPCP_H_
+#define _IPCP_H_
+
+/* Procedure propagateArguments drops the
+ * parameters of the functions of an analyzed
+ * program that every call passes the same
+ * constant, reading the constant in their place,
+ * and sends calls passing constants their callee
+ * tests on to a copy of the callee specialized
+ * for them, while the code fits in a budget below
+ * the TM instruction memory. A library is left
+ * alone, as it is called from outside
+ */
+void propagateArguments(TreeNode * syntaxTree);
+
+#endif
@@ -0,0 +1,1030 @@
+/****************************************************/
+/* File: ir.c                                       */
+/* SSA intermediate representation for the C-MINUS  */
+/* compiler                                         */
+/* A function is lowered into basic blocks of       */
+/* three-address instructions, in SSA form from     */
+/* the start: its scalar parameters and locals are  */
+/* never stored, each read finds the value last     */
+/* written on the paths to it and phis are placed   */
+/* as the reads need them, as described by Braun et */
+/* al., "Simple and Efficient Construction of       */
+/* Static Single Assignment Form". A block is       */
+/* sealed once all its predecessors are known; the  */
+/* phis a read puts into an unsealed block get      */
+/* their arguments when it is sealed. Dominators    */
+/* are found by the iteration of Cooper, Harvey and */
+/* Kennedy over the reverse postorder               */
+/* Compiler Construction: Principles and Practice   */
+/* Kenneth C. Louden                                */
+/****************************************************/
+
+#include "globals.h"
+#include "util.h"
+#include "symtab.h"
+#include "ir.h"
+
+static void * grow(void * array, int n, int * max, int size)
+{
+    if (n < *max)
+        return array;
+    *max = (*max == 0) ? 8 : 2 * *max;
+    array = realloc(array, *max * size);
+    if (array == NULL){
+        fprintf(listing, "Out of memory error at line %d\n", lineno);
+        exit(-1);
+    }
+    return array;
+}
+
+static void * allocate(int size)
+{
+    void * p = calloc(1, size);
+    if (p == NULL){
+        fprintf(listing, "Out of memory error at line %d\n", lineno);
+        exit(-1);
+    }
+    return p;
+}
+
+/********************************************/
+/* instructions and blocks                  */
+/********************************************/
+
+/* Function irNewInst makes an instruction that is
+ * in no block yet
+ */
+IrInst * irNewInst(IrOp op)
+{
+    IrInst * inst = (IrInst *)allocate(sizeof(IrInst));
+    inst->op = op;
+    inst->dst = -1;
+    return inst;
+}
+
+/* Function irNewValue returns a new value defined
+ * by inst
+ */
+int irNewValue(IrFunc * ir, IrInst * inst)
+{
+    ir->def = grow(ir->def, ir->nValues, &ir->maxValues, sizeof(IrInst *));
+    ir->def[ir->nValues] = inst;
+    inst->dst = ir->nValues;
+    return ir->nValues++;
+}
+
+/* Procedure irAddArg appends value v to the
+ * arguments of inst
+ */
+void irAddArg(IrInst * inst, int v)
+{
+    inst->args = grow(inst->args, inst->nArgs, &inst->maxArgs, sizeof(int));
+    inst->args[inst->nArgs++] = v;
+}
+
+/* Procedures irInsertBefore and irAppend put inst
+ * before instruction at, or at the end of block b
+ */
+void irInsertBefore(IrInst * at, IrInst * inst)
+{
+    IrBlock * b = at->block;
+    inst->block = b;
+    inst->next = at;
+    inst->prev = at->prev;
+    if (at->prev != NULL)
+        at->prev->next = inst;
+    else
+        b->first = inst;
+    at->prev = inst;
+}
+
+void irAppend(IrBlock * b, IrInst * inst)
+{
+    inst->block = b;
+    inst->prev = b->last;
+    inst->next = NULL;
+    if (b->last != NULL)
+        b->last->next = inst;
+    else
+        b->first = inst;
+    b->last = inst;
+}
+
+static void unlink(IrInst * inst)
+{
+    IrBlock * b = inst->block;
+    if (inst->prev != NULL)
+        inst->prev->next = inst->next;
+    else
+        b->first = inst->next;
+    if (inst->next != NULL)
+        inst->next->prev = inst->prev;
+    else
+        b->last = inst->prev;
+    inst->prev = inst->next = NULL;
+}
+
+static void freeInst(IrInst * inst)
+{
+    free(inst->args);
+    free(inst);
+}
+
+/* Procedure irRemove unlinks inst from its block
+ * and releases it
+ */
+void irRemove(IrFunc * ir, IrInst * inst)
+{
+    unlink(inst);
+    if (inst->dst >= 0 && ir->def[inst->dst] == inst)
+        ir->def[inst->dst] = NULL;
+    freeInst(inst);
+}
+
+/* Function irNewBlock adds an empty block */
+IrBlock * irNewBlock(IrFunc * ir)
+{
+    IrBlock * b = (IrBlock *)allocate(sizeof(IrBlock));
+    ir->blocks = grow(ir->blocks, ir->nBlocks, &ir->maxBlocks, sizeof(IrBlock *));
+    b->id = ir->nBlocks;
+    b->rpo = -1;
+    ir->blocks[ir->nBlocks++] = b;
+    return b;
+}
+
+static void addPred(IrBlock * b, IrBlock * p)
+{
+    b->preds = grow(b->preds, b->nPreds, &b->maxPreds, sizeof(IrBlock *));
+    b->preds[b->nPreds++] = p;
+}
+
+/* Procedure irRemoveEdge removes the edge from
+ * block from to block to from the predecessors of
+ * to and the arguments of its phis
+ */
+void irRemoveEdge(IrBlock * from, IrBlock * to)
+{
+    int k = 0;
+    while (k < to->nPreds && to->preds[k] != from)
+        k++;
+    if (k == to->nPreds)
+        return;
+    for (int j = k; j + 1 < to->nPreds; j++)
+        to->preds[j] = to->preds[j + 1];
+    to->nPreds--;
+    for (IrInst * phi = to->first; phi != NULL && phi->op == IR_PHI; phi = phi->next){
+        for (int j = k; j + 1 < phi->nArgs; j++)
+            phi->args[j] = phi->args[j + 1];
+        phi->nArgs--;
+    }
+}
+
+static void freeBlock(IrBlock * b)
+{
+    IrInst * inst = b->first;
+    while (inst != NULL){
+        IrInst * next = inst->next;
+        freeInst(inst);
+        inst = next;
+    }
+    free(b->preds);
+    free(b->kids);
+    free(b->defs);
+    free(b);
+}
+
+/* Procedure irFree releases the IR of a function */
+void irFree(IrFunc * ir)
+{
+    if (ir == NULL)
+        return;
+    for (int i = 0; i < ir->nBlocks; i++)
+        freeBlock(ir->blocks[i]);
+    free(ir->blocks);
+    free(ir->def);
+    free(ir->loc);
+    free(ir);
+}
+
+/* Function irSuccs stores the successors of b in
+ * succ and returns how many there are
+ */
+int irSuccs(IrBlock * b, IrBlock * succ[2])
+{
+    IrInst * t = b->last;
+    if (t == NULL)
+        return 0;
+    if (t->op == IR_JUMP){
+        succ[0] = t->target[0];
+        return 1;
+    }
+    if (t->op == IR_BRANCH){
+        succ[0] = t->target[0];
+        succ[1] = t->target[1];
+        return 2;
+    }
+    return 0;
+}
+
+/* Function irHasEffect tells whether inst must be
+ * kept even if its value is not used
+ */
+int irHasEffect(IrInst * inst)
+{
+    switch (inst->op){
+        case IR_STORE:
+        case IR_GSTORE:
+        case IR_CALL:
+        case IR_JUMP:
+        case IR_BRANCH:
+        case IR_RET:
+            return TRUE;
+        default:
+            return FALSE;
+    }
+}
+
+/* Procedure irReplaceUses makes every instruction
+ * of ir reading value from read value to instead
+ */
+void irReplaceUses(IrFunc * ir, int from, int to)
+{
+    for (int i = 0; i < ir->nBlocks; i++)
+        for (IrInst * inst = ir->blocks[i]->first; inst != NULL; inst = inst->next)
+            for (int k = 0; k < inst->nArgs; k++)
+                if (inst->args[k] == from)
+                    inst->args[k] = to;
+}
+
+/********************************************/
+/* lowering a function into SSA form        */
+/********************************************/
+
+static IrFunc * ir;
+static IrBlock * cur;
+
+/* the scalar parameters and locals, array
+ * parameters among them, whose values are SSA
+ * values
+ */
+static TreeNode ** vars = NULL;
+static int nVars = 0, maxVars = 0;
+
+/* the local arrays and their frame offsets */
+typedef struct
+{
+    TreeNode * decl;
+    int offset;
+} ArrayRec;
+
+static ArrayRec * arrays = NULL;
+static int nArrays = 0, maxArrays = 0;
+
+/* phis put into unsealed blocks, whose arguments
+ * are added when their block is sealed
+ */
+typedef struct
+{
+    IrBlock * block;
+    int var;
+    IrInst * phi;
+} PendingRec;
+
+static PendingRec * pending = NULL;
+static int nPending = 0, maxPending = 0;
+
+/* the value read from a variable never written */
+static int undefined;
+
+/* the value each trivial phi removed stood for,
+ * -1 for the others
+ */
+static int * forward = NULL;
+static int maxForward = 0;
+
+static int resolve(int v)
+{
+    while (v < maxForward && forward[v] >= 0)
+        v = forward[v];
+    return v;
+}
+
+/* Function varOf returns the index of the
+ * variable declared by decl, -1 if its value is
+ * not an SSA value
+ */
+static int varOf(TreeNode * decl)
+{
+    for (int i = 0; i < nVars; i++)
+        if (vars[i] == decl)
+            return i;
+    return -1;
+}
+
+static IrBlock * newBlock(void)
+{
+    IrBlock * b = irNewBlock(ir);
+    b->defs = (int *)allocate((nVars + 1) * sizeof(int));
+    for (int i = 0; i < nVars; i++)
+        b->defs[i] = -1;
+    return b;
+}
+
+static IrInst * emit(IrOp op, int lineno)
+{
+    IrInst * inst = irNewInst(op);
+    inst->lineno = lineno;
+    irAppend(cur, inst);
+    return inst;
+}
+
+static int emitConst(int val, int lineno)
+{
+    IrInst * inst = emit(IR_CONST, lineno);
+    inst->imm = val;
+    return irNewValue(ir, inst);
+}
+
+static int undefinedValue(void)
+{
+    if (undefined < 0){
+        IrInst * inst = irNewInst(IR_CONST);
+        IrBlock * entry = ir->blocks[0];
+        if (entry->first != NULL)
+            irInsertBefore(entry->first, inst);
+        else
+            irAppend(entry, inst);
+        undefined = irNewValue(ir, inst);
+    }
+    return undefined;
+}
+
+static IrInst * newPhi(IrBlock * b)
+{
+    IrInst * phi = irNewInst(IR_PHI);
+    if (b->first != NULL)
+        irInsertBefore(b->first, phi);
+    else
+        irAppend(b, phi);
+    irNewValue(ir, phi);
+    return phi;
+}
+
+static int readVariable(int var, IrBlock * b);
+
+/* Function tryRemoveTrivialPhi replaces a phi
+ * whose arguments are all one value, or itself,
+ * by that value and returns what it stands for;
+ * phis using it may become trivial in turn
+ */
+static int tryRemoveTrivialPhi(IrInst * phi)
+{
+    int same = -1, v = phi->dst;
+    int * users = NULL, nUsers = 0, maxUsers = 0;
+    for (int i = 0; i < phi->nArgs; i++){
+        int a = phi->args[i];
+        if (a == same || a == v)
+            continue;
+        if (same >= 0)
+            return v;
+        same = a;
+    }
+    if (same < 0)
+        same = undefinedValue();
+    for (int i = 0; i < ir->nBlocks; i++){
+        IrBlock * b = ir->blocks[i];
+        for (IrInst * inst = b->first; inst != NULL && inst->op == IR_PHI; inst = inst->next)
+            if (inst != phi)
+                for (int k = 0; k < inst->nArgs; k++)
+                    if (inst->args[k] == v){
+                        users = grow(users, nUsers, &maxUsers, sizeof(int));
+                        users[nUsers++] = inst->dst;
+                        break;
+                    }
+        for (int k = 0; k < nVars; k++)
+            if (b->defs[k] == v)
+                b->defs[k] = same;
+    }
+    irReplaceUses(ir, v, same);
+    irRemove(ir, phi);
+    while (maxForward < ir->nValues){
+        int old = maxForward;
+        forward = grow(forward, maxForward, &maxForward, sizeof(int));
+        for (int i = old; i < maxForward; i++)
+            forward[i] = -1;
+    }
+    forward[v] = same;
+    for (int i = 0; i < nUsers; i++){
+        IrInst * u = ir->def[users[i]];
+        if (u != NULL && u->op == IR_PHI && u->block->sealed &&
+            u->nArgs == u->block->nPreds)
+            tryRemoveTrivialPhi(u);
+    }
+    free(users);
+    /* same may have been a phi removed meanwhile */
+    return resolve(same);
+}
+
+static int addPhiOperands(int var, IrInst * phi)
+{
+    for (int i = 0; i < phi->block->nPreds; i++)
+        irAddArg(phi, readVariable(var, phi->block->preds[i]));
+    return tryRemoveTrivialPhi(phi);
+}
+
+static int readVariable(int var, IrBlock * b)
+{
+    int v;
+    if (b->defs[var] >= 0)
+        return b->defs[var];
+    if (!b->sealed){
+        IrInst * phi = newPhi(b);
+        pending = grow(pending, nPending, &maxPending, sizeof(PendingRec));
+        pending[nPending].block = b;
+        pending[nPending].var = var;
+        pending[nPending++].phi = phi;
+        v = phi->dst;
+    }
+    else if (b->nPreds == 1)
+        v = readVariable(var, b->preds[0]);
+    else if (b->nPreds == 0)
+        v = undefinedValue();
+    else {
+        IrInst * phi = newPhi(b);
+        b->defs[var] = phi->dst;
+        v = addPhiOperands(var, phi);
+    }
+    b->defs[var] = v;
+    return v;
+}
+
+static void sealBlock(IrBlock * b)
+{
+    /* reads while the phis are completed may
+     * put more into b
+     */
+    for (int i = 0; i < nPending; i++)
+        if (pending[i].block == b){
+            IrInst * phi = pending[i].phi;
+            pending[i].block = NULL;
+            addPhiOperands(pending[i].var, phi);
+        }
+    b->sealed = TRUE;
+}
+
+static void jumpTo(IrBlock * target)
+{
+    IrInst * inst = emit(IR_JUMP, 0);
+    inst->target[0] = target;
+    addPred(target, cur);
+}
+
+static void branchTo(int cond, IrBlock * t, IrBlock * f, TreeNode * stmt)
+{
+    IrInst * inst = emit(IR_BRANCH, stmt->lineno);
+    inst->site = stmt->site;
+    irAddArg(inst, cond);
+    inst->target[0] = t;
+    inst->target[1] = f;
+    addPred(t, cur);
+    addPred(f, cur);
+}
+
+/* Function terminated tells whether the current
+ * block already ends in a jump, branch or return
+ */
+static int terminated(void)
+{
+    return cur->last != NULL && (cur->last->op == IR_JUMP ||
+        cur->last->op == IR_BRANCH || cur->last->op == IR_RET);
+}
+
+static int lowerExp(TreeNode * t);
+
+/* Function arrayBase returns the address of
+ * element 0 of the array identifier t reads
+ */
+static int arrayBase(TreeNode * t)
+{
+    IrInst * inst;
+    int var = varOf(t->decl);
+    if (var >= 0)
+        return readVariable(var, cur);
+    inst = emit(IR_ADDR, t->lineno);
+    inst->decl = t->decl;
+    inst->imm = t->decl->bind.offset;
+    for (int i = 0; i < nArrays; i++)
+        if (arrays[i].decl == t->decl)
+            inst->imm = arrays[i].offset;
+    return irNewValue(ir, inst);
+}
+
+/* Function element returns the address of the
+ * array element t, leaving in *disp the constant
+ * index it is displaced by
+ */
+static int element(TreeNode * t, int * disp)
+{
+    IrInst * inst;
+    int index, base;
+    if (isConst(t->child[0])){
+        *disp = t->child[0]->attr.val;
+        return arrayBase(t);
+    }
+    *disp = 0;
+    index = lowerExp(t->child[0]);
+    base = arrayBase(t);
+    inst = emit(IR_BIN, t->lineno);
+    inst->binop = PLUS;
+    irAddArg(inst, base);
+    irAddArg(inst, index);
+    return irNewValue(ir, inst);
+}
+
+static int lowerExp(TreeNode * t)
+{
+    IrInst * inst;
+    TreeNode * lhs;
+    int var, v, addr, disp;
+    if (t->nodekind == StmtK){
+        switch (t->kind.stmt){
+            case SimpleStmtK:
+            case AdditiveStmtK:
+            case TermK:
+            {
+                int l = lowerExp(t->child[0]);
+                int r = lowerExp(t->child[2]);
+                inst = emit(IR_BIN, t->lineno);
+                inst->binop = t->child[1]->attr.op;
+                irAddArg(inst, l);
+                irAddArg(inst, r);
+                return irNewValue(ir, inst);
+            }
+            case CallK:
+                /* the call follows its arguments */
+                inst = irNewInst(IR_CALL);
+                for (TreeNode * a = t->child[0]; a != NULL; a = a->sibling)
+                    irAddArg(inst, lowerExp(a));
+                inst->decl = t->decl;
+                inst->lineno = t->lineno;
+                inst->site = t->site;
+                irAppend(cur, inst);
+                return irNewValue(ir, inst);
+            default:
+                return undefinedValue();
+        }
+    }
+    switch (t->kind.exp){
+        case ConstK:
+            return emitConst(t->attr.val, t->lineno);
+        case IdK:
+            if (t->child[0] == NULL){
+                if ((var = varOf(t->decl)) >= 0)
+                    return readVariable(var, cur);
+                if (t->decl->kind.exp == ArrayDeclK)
+                    return arrayBase(t);
+                if (t->decl->bind.storage != GlobalK){
+                    ir->partial = TRUE;
+                    return undefinedValue();
+                }
+                inst = emit(IR_GLOAD, t->lineno);
+                inst->decl = t->decl;
+                return irNewValue(ir, inst);
+            }
+            addr = element(t, &disp);
+            inst = emit(IR_LOAD, t->lineno);
+            inst->imm = disp;
+            irAddArg(inst, addr);
+            return irNewValue(ir, inst);
+        case AssignK:
+            lhs = t->child[0];
+            if (lhs->child[0] == NULL){
+                v = lowerExp(t->child[1]);
+                if ((var = varOf(lhs->decl)) >= 0){
+                    inst = emit(IR_COPY, t->lineno);
+                    irAddArg(inst, v);
+                    v = irNewValue(ir, inst);
+                    cur->defs[var] = v;
+                }
+                else if (lhs->decl->bind.storage != GlobalK)
+                    ir->partial = TRUE;
+                else {
+                    inst = emit(IR_GSTORE, t->lineno);
+                    inst->decl = lhs->decl;
+                    irAddArg(inst, v);
+                }
+                return v;
+            }
+            /* the address comes before the value */
+            addr = element(lhs, &disp);
+            v = lowerExp(t->child[1]);
+            inst = emit(IR_STORE, t->lineno);
+            inst->imm = disp;
+            irAddArg(inst, addr);
+            irAddArg(inst, v);
+            return v;
+        default:
+            return undefinedValue();
+    }
+}
+
+static void lowerStmts(TreeNode * t);
+
+static void lowerStmt(TreeNode * t)
+{
+    IrBlock * then, * other, * join, * head, * body;
+    IrInst * inst;
+    int cond;
+    if (t->nodekind != StmtK){
+        lowerExp(t);
+        return;
+    }
+    switch (t->kind.stmt){
+        case CompoundStmtK:
+            lowerStmts(t->child[1]);
+            break;
+        case SelectionStmtK:
+            cond = lowerExp(t->child[0]);
+            then = newBlock();
+            join = newBlock();
+            other = (t->child[2] != NULL) ? newBlock() : join;
+            branchTo(cond, then, other, t);
+            sealBlock(then);
+            cur = then;
+            lowerStmts(t->child[1]);
+            if (!terminated())
+                jumpTo(join);
+            if (other != join){
+                sealBlock(other);
+                cur = other;
+                lowerStmts(t->child[2]);
+                if (!terminated())
+                    jumpTo(join);
+            }
+            sealBlock(join);
+            cur = join;
+            break;
+        case IterationStmtK:
+            head = newBlock();
+            body = newBlock();
+            join = newBlock();
+            jumpTo(head);
+            cur = head;
+            cond = lowerExp(t->child[0]);
+            branchTo(cond, body, join, t);
+            sealBlock(body);
+            cur = body;
+            lowerStmts(t->child[1]);
+            if (!terminated())
+                jumpTo(head);
+            sealBlock(head);
+            sealBlock(join);
+            cur = join;
+            break;
+        case ReturnStmtK:
+            inst = irNewInst(IR_RET);
+            inst->lineno = t->lineno;
+            if (t->child[0] != NULL)
+                irAddArg(inst, lowerExp(t->child[0]));
+            irAppend(cur, inst);
+            /* what follows is unreachable */
+            cur = newBlock();
+            sealBlock(cur);
+            break;
+        default:
+            lowerExp(t);
+            break;
+    }
+}
+
+static void lowerStmts(TreeNode * t)
+{
+    for (; t != NULL; t = t->sibling)
+        lowerStmt(t);
+}
+
+/* Procedure collectDecls finds the variables of
+ * the compound statements of a subtree and lays
+ * out its local arrays after the parameters
+ */
+static void collectDecls(TreeNode * t)
+{
+    for (; t != NULL; t = t->sibling){
+        if (t->nodekind == StmtK && t->kind.stmt == CompoundStmtK)
+            for (TreeNode * d = t->child[0]; d != NULL; d = d->sibling){
+                if (d->kind.exp == ArrayDeclK){
+                    arrays = grow(arrays, nArrays, &maxArrays, sizeof(ArrayRec));
+                    arrays[nArrays].decl = d;
+                    /* element i is at fp-memloc+i */
+                    arrays[nArrays++].offset = -(ir->frameSize + d->size - 1);
+                    ir->frameSize += d->size;
+                }
+                else {
+                    vars = grow(vars, nVars, &maxVars, sizeof(TreeNode *));
+                    vars[nVars++] = d;
+                }
+            }
+        for (int i = 0; i < MAXCHILDREN; i++)
+            collectDecls(t->child[i]);
+    }
+}
+
+/* Function irBuild lowers function f of an
+ * analyzed program into SSA form, with its
+ * dominator tree built
+ */
+IrFunc * irBuild(TreeNode * f)
+{
+    IrBlock * entry;
+    int n = 0;
+    ir = (IrFunc *)allocate(sizeof(IrFunc));
+    ir->func = f;
+    nVars = nArrays = nPending = 0;
+    undefined = -1;
+    for (int i = 0; i < maxForward; i++)
+        forward[i] = -1;
+    for (TreeNode * p = f->child[0]; p != NULL; p = p->sibling){
+        vars = grow(vars, nVars, &maxVars, sizeof(TreeNode *));
+        vars[nVars++] = p;
+    }
+    ir->nParams = nVars;
+    ir->frameSize = FRAME_HEADER + nVars;
+    collectDecls(f->child[1]);
+    entry = newBlock();
+    sealBlock(entry);
+    cur = entry;
+    for (TreeNode * p = f->child[0]; p != NULL; p = p->sibling, n++){
+        IrInst * inst = emit(IR_PARAM, p->lineno);
+        inst->imm = n;
+        entry->defs[n] = irNewValue(ir, inst);
+    }
+    lowerStmts(f->child[1]);
+    if (!terminated())
+        emit(IR_RET, 0);
+    for (int i = 0; i < ir->nBlocks; i++){
+        free(ir->blocks[i]->defs);
+        ir->blocks[i]->defs = NULL;
+    }
+    irAnalyze(ir);
+    return ir;
+}
+
+/********************************************/
+/* analysis                                 */
+/********************************************/
+
+static void visit(IrBlock * b, IrBlock ** order, int * n)
+{
+    IrBlock * succ[2];
+    int k = irSuccs(b, succ);
+    b->rpo = 0;
+    for (int i = k - 1; i >= 0; i--)
+        if (succ[i]->rpo < 0)
+            visit(succ[i], order, n);
+    order[(*n)++] = b;
+}
+
+static IrBlock * intersect(IrBlock * a, IrBlock * b)
+{
+    while (a != b){
+        while (a->rpo > b->rpo)
+            a = a->idom;
+        while (b->rpo > a->rpo)
+            b = b->idom;
+    }
+    return a;
+}
+
+/* Procedure irAnalyze orders the blocks of ir in
+ * reverse postorder, dropping those the entry
+ * does not reach, and builds the dominator tree
+ */
+void irAnalyze(IrFunc * ir)
+{
+    IrBlock ** order = (IrBlock **)allocate((ir->nBlocks + 1) * sizeof(IrBlock *));
+    int n = 0, changed;
+    for (int i = 0; i < ir->nBlocks; i++)
+        ir->blocks[i]->rpo = -1;
+    visit(ir->blocks[0], order, &n);
+    /* predecessors not reached go, with the
+     * arguments their phis have for them
+     */
+    for (int i = 0; i < n; i++){
+        IrBlock * b = order[i];
+        int k = 0;
+        for (int p = 0; p < b->nPreds; p++){
+            if (b->preds[p]->rpo < 0)
+                continue;
+            for (IrInst * inst = b->first; inst != NULL && inst->op == IR_PHI; inst = inst->next)
+                inst->args[k] = inst->args[p];
+            b->preds[k++] = b->preds[p];
+        }
+        for (IrInst * inst = b->first; inst != NULL && inst->op == IR_PHI; inst = inst->next)
+            inst->nArgs = k;
+        b->nPreds = k;
+    }
+    for (int i = 0; i < ir->nBlocks; i++){
+        IrBlock * b = ir->blocks[i];
+        if (b->rpo < 0){
+            for (IrInst * inst = b->first; inst != NULL; inst = inst->next)
+                if (inst->dst >= 0 && ir->def[inst->dst] == inst)
+                    ir->def[inst->dst] = NULL;
+            freeBlock(b);
+        }
+    }
+    for (int i = 0; i < n; i++){
+        IrBlock * b = order[n - 1 - i];
+        ir->blocks[i] = b;
+        b->rpo = i;
+        b->idom = NULL;
+        b->nKids = 0;
+    }
+    ir->nBlocks = n;
+    free(order);
+    ir->blocks[0]->idom = ir->blocks[0];
+    do {
+        changed = FALSE;
+        for (int i = 1; i < n; i++){
+            IrBlock * b = ir->blocks[i], * idom = NULL;
+            for (int p = 0; p < b->nPreds; p++){
+                IrBlock * q = b->preds[p];
+                if (q->idom == NULL)
+                    continue;
+                idom = (idom == NULL) ? q : intersect(q, idom);
+            }
+            if (b->idom != idom){
+                b->idom = idom;
+                changed = TRUE;
+            }
+        }
+    } while (changed);
+    ir->blocks[0]->idom = NULL;
+    for (int i = 1; i < n; i++){
+        IrBlock * d = ir->blocks[i]->idom;
+        d->kids = grow(d->kids, d->nKids, &d->maxKids, sizeof(IrBlock *));
+        d->kids[d->nKids++] = ir->blocks[i];
+    }
+}
+
+/* Function irDominates tells whether block a
+ * dominates block b
+ */
+int irDominates(IrBlock * a, IrBlock * b)
+{
+    for (; b != NULL; b = b->idom)
+        if (a == b)
+            return TRUE;
+    return FALSE;
+}
+
+/* Function defines tells whether the definition
+ * of value v is available at instruction use:
+ * before it in its block, or in a dominator
+ */
+static int available(IrFunc * ir, int v, IrBlock * b, IrInst * use)
+{
+    IrInst * d;
+    if (v < 0 || v >= ir->nValues || (d = ir->def[v]) == NULL || d->dst != v)
+        return FALSE;
+    if (d->block != b)
+        return irDominates(d->block, b);
+    for (IrInst * i = b->first; i != NULL && i != use; i = i->next)
+        if (i == d)
+            return TRUE;
+    return use == NULL;
+}
+
+/* Function irVerify tells whether ir is in valid
+ * SSA form: every value is defined once, and its
+ * definition dominates its uses
+ */
+int irVerify(IrFunc * ir)
+{
+    if (ir->partial)
+        return FALSE;
+    for (int i = 0; i < ir->nBlocks; i++){
+        IrBlock * b = ir->blocks[i];
+        int body = FALSE;
+        if (b->last == NULL || (b->last->op != IR_JUMP &&
+            b->last->op != IR_BRANCH && b->last->op != IR_RET))
+            return FALSE;
+        for (IrInst * inst = b->first; inst != NULL; inst = inst->next){
+            if (inst->block != b)
+                return FALSE;
+            if (inst->dst >= 0 && ir->def[inst->dst] != inst)
+                return FALSE;
+            if (inst->op == IR_PHI){
+                if (body || inst->nArgs != b->nPreds)
+                    return FALSE;
+                for (int k = 0; k < inst->nArgs; k++)
+                    if (!available(ir, inst->args[k], b->preds[k], NULL))
+                        return FALSE;
+                continue;
+            }
+            body = TRUE;
+            if (inst != b->last && (inst->op == IR_JUMP ||
+                inst->op == IR_BRANCH || inst->op == IR_RET))
+                return FALSE;
+            for (int k = 0; k < inst->nArgs; k++)
+                if (!available(ir, inst->args[k], b, inst))
+                    return FALSE;
+        }
+    }
+    return TRUE;
+}
+
+static char * opName(TokenType op)
+{
+    switch (op){
+        case PLUS: return "+";
+        case MINUS: return "-";
+        case TIMES: return "*";
+        case OVER: return "/";
+        case LT: return "<";
+        case LE: return "<=";
+        case GT: return ">";
+        case GE: return ">=";
+        case EQ: return "==";
+        case NE: return "!=";
+        default: return "?";
+    }
+}
+
+/* Procedure irPrint lists the IR of a function
+ * in the listing file
+ */
+void irPrint(IrFunc * ir)
+{
+    fprintf(listing, "\nIR of %s:\n", ir->func->attr.name);
+    for (int i = 0; i < ir->nBlocks; i++){
+        IrBlock * b = ir->blocks[i];
+        fprintf(listing, "B%d:", b->id);
+        if (b->nPreds > 0){
+            fprintf(listing, " preds");
+            for (int p = 0; p < b->nPreds; p++)
+                fprintf(listing, " B%d", b->preds[p]->id);
+        }
+        if (b->idom != NULL)
+            fprintf(listing, ", idom B%d", b->idom->id);
+        fprintf(listing, "\n");
+        for (IrInst * inst = b->first; inst != NULL; inst = inst->next){
+            fprintf(listing, "    ");
+            if (inst->dst >= 0)
+                fprintf(listing, "v%d = ", inst->dst);
+            switch (inst->op){
+                case IR_CONST:
+                    fprintf(listing, "%d", inst->imm);
+                    break;
+                case IR_COPY:
+                    fprintf(listing, "v%d", inst->args[0]);
+                    break;
+                case IR_BIN:
+                    fprintf(listing, "v%d %s v%d", inst->args[0], opName(inst->binop), inst->args[1]);
+                    break;
+                case IR_PARAM:
+                    fprintf(listing, "param %d", inst->imm);
+                    break;
+                case IR_ADDR:
+                    fprintf(listing, "&%s", inst->decl->attr.name);
+                    break;
+                case IR_LOAD:
+                    fprintf(listing, "load v%d[%d]", inst->args[0], inst->imm);
+                    break;
+                case IR_STORE:
+                    fprintf(listing, "store v%d[%d] = v%d", inst->args[0], inst->imm, inst->args[1]);
+                    break;
+                case IR_GLOAD:
+                    fprintf(listing, "%s", inst->decl->attr.name);
+                    break;
+                case IR_GSTORE:
+                    fprintf(listing, "%s = v%d", inst->decl->attr.name, inst->args[0]);
+                    break;
+                case IR_CALL:
+                    fprintf(listing, "call %s(", inst->decl->attr.name);
+                    for (int k = 0; k < inst->nArgs; k++)
+                        fprintf(listing, k ? ", v%d" : "v%d", inst->args[k]);
+                    fprintf(listing, ")");
+                    break;
+                case IR_PHI:
+                    fprintf(listing, "phi(");
+                    for (int k = 0; k < inst->nArgs; k++)
+                        fprintf(listing, k ? ", v%d" : "v%d", inst->args[k]);
+                    fprintf(listing, ")");
+                    break;
+                case IR_JUMP:
+                    fprintf(listing, "jump B%d", inst->target[0]->id);
+                    break;
+                case IR_BRANCH:
+                    fprintf(listing, "branch v%d, B%d, B%d", inst->args[0],
+                            inst->target[0]->id, inst->target[1]->id);
+                    break;
+                case IR_RET:
+                    fprintf(listing, "ret");
+                    if (inst->nArgs > 0)
+                        fprintf(listing, " v%d", inst->args[0]);
+                    break;
+            }
+            fprintf(listing, "\n");
+        }
+    }
+}
@@ -0,0 +1,179 @@
+/****************************************************/
+/* File: ir.h                                       */
+/* SSA intermediate representation for the C-MINUS  */
+/* compiler                                         */
+/* Compiler Construction: Principles and Practice   */
+/* Kenneth C. Louden                                */
+/****************************************************/
+
+#ifndef _IR_H_
+#define _IR_H_
+
+/* IrOp is the operation of an instruction. Values
+ * are numbered per function; an instruction
+ * defines at most one, dst, and reads the values
+ * in args:
+ *   CONST   dst = imm
+ *   COPY    dst = args[0]
+ *   BIN     dst = args[0] binop args[1]
+ *   PARAM   dst = parameter imm, on entry
+ *   ADDR    dst = address of element 0 of array
+ *           decl, at frame offset imm if local
+ *   LOAD    dst = mem[args[0] + imm]
+ *   STORE   mem[args[0] + imm] = args[1]
+ *   GLOAD   dst = global decl
+ *   GSTORE  global decl = args[0]
+ *   CALL    dst = decl(args)
+ *   PHI     dst = args[i] coming from preds[i]
+ *   JUMP    to target[0]
+ *   BRANCH  to target[0] if args[0] != 0, else
+ *           to target[1]
+ *   RET     returning args[0], if nArgs is 1
+ * Phis come first in their block, a JUMP, BRANCH
+ * or RET last
+ */
+typedef enum
+{
+    IR_CONST, IR_COPY, IR_BIN, IR_PARAM, IR_ADDR, IR_LOAD, IR_STORE,
+    IR_GLOAD, IR_GSTORE, IR_CALL, IR_PHI, IR_JUMP, IR_BRANCH, IR_RET
+} IrOp;
+
+struct irBlock;
+
+typedef struct irInst
+{
+    IrOp op;
+    int dst; /* -1 if none */
+    int * args;
+    int nArgs, maxArgs;
+    TokenType binop;
+    int imm;
+    TreeNode * decl;
+    struct irBlock * target[2];
+    struct irBlock * block;
+    struct irInst * prev, * next;
+    int lineno;
+    int site; /* of the branch or call it comes from */
+} IrInst;
+
+/* a basic block: preds are its predecessors, in
+ * the order of the arguments of its phis; idom is
+ * its immediate dominator, whose dominator tree
+ * children are listed in kids
+ */
+typedef struct irBlock
+{
+    int id;
+    IrInst * first, * last;
+    struct irBlock ** preds;
+    int nPreds, maxPreds;
+    struct irBlock * idom;
+    struct irBlock ** kids;
+    int nKids, maxKids;
+    int rpo; /* position in blocks, -1 if unreachable */
+    int sealed; /* all predecessors are known */
+    int * defs; /* while built, value of each variable */
+} IrBlock;
+
+/* the IR of a function: its blocks in reverse
+ * postorder, the entry first, and the instruction
+ * defining each value
+ */
+typedef struct irFunc
+{
+    TreeNode * func;
+    IrBlock ** blocks;
+    int nBlocks, maxBlocks;
+    IrInst ** def;
+    int nValues, maxValues;
+    int frameSize; /* header, parameters and local arrays */
+    int nParams;
+    int * loc; /* where each value is kept, set by irAllocate */
+    int size; /* frame size with spill slots, set by irAllocate */
+    int partial; /* a frame variable had no SSA value */
+} IrFunc;
+
+/* Function irBuild lowers function f of an
+ * analyzed program into SSA form, with its
+ * dominator tree built
+ */
+IrFunc * irBuild(TreeNode * f);
+
+/* Procedure irFree releases the IR of a function */
+void irFree(IrFunc * ir);
+
+/* Function irNewValue returns a new value defined
+ * by inst
+ */
+int irNewValue(IrFunc * ir, IrInst * inst);
+
+/* Function irNewInst makes an instruction that is
+ * in no block yet
+ */
+IrInst * irNewInst(IrOp op);
+
+/* Procedure irAddArg appends value v to the
+ * arguments of inst
+ */
+void irAddArg(IrInst * inst, int v);
+
+/* Procedures irInsertBefore and irAppend put inst
+ * before instruction at, or at the end of block b
+ */
+void irInsertBefore(IrInst * at, IrInst * inst);
+void irAppend(IrBlock * b, IrInst * inst);
+
+/* Procedure irRemove unlinks inst from its block
+ * and releases it
+ */
+void irRemove(IrFunc * ir, IrInst * inst);
+
+/* Function irNewBlock adds an empty block */
+IrBlock * irNewBlock(IrFunc * ir);
+
+/* Procedure irRemoveEdge removes the edge from
+ * block from to block to from the predecessors of
+ * to and the arguments of its phis
+ */
+void irRemoveEdge(IrBlock * from, IrBlock * to);
+
+/* Function irSuccs stores the successors of b in
+ * succ and returns how many there are
+ */
+int irSuccs(IrBlock * b, IrBlock * succ[2]);
+
+/* Function irHasEffect tells whether inst must be
+ * kept even if its value is not used
+ */
+int irHasEffect(IrInst * inst);
+
+/* Procedure irReplaceUses makes every instruction
+ * of ir reading value from read value to instead
+ */
+void irReplaceUses(IrFunc * ir, int from, int to);
+
+/* Procedure irAnalyze orders the blocks of ir in
+ * reverse postorder, dropping those the entry
+ * does not reach, and builds the dominator tree
+ */
+void irAnalyze(IrFunc * ir);
+
+/* Function irDominates tells whether block a
+ * dominates block b
+ */
+int irDominates(IrBlock * a, IrBlock * b);
+
+/* Function irVerify tells whether ir is in valid
+ * SSA form: every value is defined once, and its
+ * definition dominates its uses. A function with
+ * a frame variable that could not be lowered is
+ * never valid
+ */
+int irVerify(IrFunc * ir);
+
+/* Procedure irPrint lists the IR of a function
+ * in the listing file
+ */
+void irPrint(IrFunc * ir);
+
+#endif
@@ -0,0 +1,1058 @@
+/****************************************************/
+/* File: irgen.c                                    */
+/* TM code generation from the SSA form for the     */
+/* C-MINUS compiler                                 */
+/* Values are kept in the registers cgen leaves     */
+/* free, given out by a linear scan over live       */
+/* intervals in block order, or in frame slots.     */
+/* Registers do not survive a call, so values live  */
+/* across one are kept in slots; a parameter kept   */
+/* in a slot stays where the caller stored it.      */
+/* Constants and addresses are made again where     */
+/* they are used. Phis become parallel copies on    */
+/* the edges into their block, emitted at the end   */
+/* of the predecessor or, for an edge a branch      */
+/* takes, in a stub the branch jumps to. Given an   */
+/* execution profile, blocks are laid out with the  */
+/* hot path falling through and cold blocks last    */
+/* Compiler Construction: Principles and Practice   */
+/* Kenneth C. Louden                                */
+/****************************************************/
+
+#include "globals.h"
+#include <limits.h>
+#include "symtab.h"
+#include "code.h"
+#include "profile.h"
+#include "irgen.h"
+
+/* where a value is kept: a register, or frame
+ * slot k at SLOT(k)
+ */
+#define NOWHERE (-2) /* never read */
+#define REMAT (-1)   /* made again at each use */
+#define SPILL (-3)   /* in a slot not yet chosen */
+#define SLOT(k) (8 + (k))
+#define isReg(l) ((l) >= 0 && (l) < 8)
+#define isSlot(l) ((l) >= 8)
+#define slotOf(l) ((l) - 8)
+
+/* the registers values are kept in */
+static int regs[] = { 2, 3, mp };
+#define NREGS ((int)(sizeof(regs) / sizeof(regs[0])))
+
+static void * allocate(int n, int size)
+{
+    void * p = calloc(n + 1, size);
+    if (p == NULL){
+        fprintf(listing, "Out of memory error at line %d\n", lineno);
+        exit(-1);
+    }
+    return p;
+}
+
+/********************************************/
+/* register allocation                      */
+/********************************************/
+
+/* the live interval of each value, positions
+ * counted in block order: the uses of an
+ * instruction come at an even position and its
+ * definition right after
+ */
+static int * start, * end;
+
+static void extend(int v, int p)
+{
+    if (start[v] > p)
+        start[v] = p;
+    if (end[v] < p)
+        end[v] = p;
+}
+
+static int byStart(const void * a, const void * b)
+{
+    return start[*(const int *)a] - start[*(const int *)b];
+}
+
+static int isUserCall(IrInst * inst)
+{
+    return inst->op == IR_CALL && inst->decl->bind.storage != BuiltinK;
+}
+
+/* Procedure computeLiveness finds the values
+ * live into and out of each block; the arguments
+ * of a phi are live out of the predecessor they
+ * come from
+ */
+static void computeLiveness(IrFunc * ir, unsigned * in, unsigned * out, int words)
+{
+    unsigned * gen = (unsigned *)allocate(ir->nBlocks * words, sizeof(unsigned));
+    unsigned * kill = (unsigned *)allocate(ir->nBlocks * words, sizeof(unsigned));
+    int changed;
+    for (int i = 0; i < ir->nBlocks; i++){
+        unsigned * g = gen + i * words, * k = kill + i * words;
+        for (IrInst * inst = ir->blocks[i]->first; inst != NULL; inst = inst->next){
+            if (inst->op != IR_PHI)
+                for (int a = 0; a < inst->nArgs; a++){
+                    int v = inst->args[a];
+                    if (!(k[v / 32] & (1u << v % 32)))
+                        g[v / 32] |= 1u << v % 32;
+                }
+            if (inst->dst >= 0)
+                k[inst->dst / 32] |= 1u << inst->dst % 32;
+        }
+    }
+    do {
+        changed = FALSE;
+        for (int i = ir->nBlocks - 1; i >= 0; i--){
+            IrBlock * b = ir->blocks[i], * succ[2];
+            unsigned * o = out + i * words, * n = in + i * words;
+            int ns = irSuccs(b, succ);
+            for (int s = 0; s < ns; s++){
+                unsigned * si = in + succ[s]->rpo * words;
+                for (int w = 0; w < words; w++)
+                    o[w] |= si[w];
+                for (int p = 0; p < succ[s]->nPreds; p++)
+                    if (succ[s]->preds[p] == b)
+                        for (IrInst * phi = succ[s]->first; phi != NULL && phi->op == IR_PHI; phi = phi->next)
+                            o[phi->args[p] / 32] |= 1u << phi->args[p] % 32;
+            }
+            for (int w = 0; w < words; w++){
+                unsigned v = gen[i * words + w] | (o[w] & ~kill[i * words + w]);
+                if (v != n[w]){
+                    n[w] = v;
+                    changed = TRUE;
+                }
+            }
+        }
+    } while (changed);
+    free(gen);
+    free(kill);
+}
+
+/* Function irAllocate gives each value of ir a
+ * register or a frame slot, and returns the size
+ * of the frame of the function
+ */
+int irAllocate(IrFunc * ir)
+{
+    int n = ir->nValues, words = (n + 31) / 32, pos = 0;
+    unsigned * in = (unsigned *)allocate(ir->nBlocks * words, sizeof(unsigned));
+    unsigned * out = (unsigned *)allocate(ir->nBlocks * words, sizeof(unsigned));
+    int * calls = (int *)allocate(n, sizeof(int));
+    int * order = (int *)allocate(n, sizeof(int));
+    int * active = (int *)allocate(n, sizeof(int));
+    int * used = (int *)allocate(n, sizeof(int));
+    int * slotEnd;
+    int nCalls = 0, nOrder = 0, nActive = 0, size = ir->frameSize;
+    start = (int *)allocate(n, sizeof(int));
+    end = (int *)allocate(n, sizeof(int));
+    free(ir->loc);
+    ir->loc = (int *)allocate(n, sizeof(int));
+    for (int v = 0; v < n; v++){
+        start[v] = INT_MAX;
+        end[v] = -1;
+        ir->loc[v] = NOWHERE;
+    }
+    computeLiveness(ir, in, out, words);
+    for (int i = 0; i < ir->nBlocks; i++){
+        IrBlock * b = ir->blocks[i];
+        int entry = pos;
+        pos += 2;
+        for (int v = 0; v < n; v++)
+            if (in[i * words + v / 32] & (1u << v % 32))
+                extend(v, entry);
+        for (IrInst * inst = b->first; inst != NULL; inst = inst->next){
+            if (inst->op == IR_PHI){
+                extend(inst->dst, entry);
+                for (int a = 0; a < inst->nArgs; a++)
+                    used[inst->args[a]] = TRUE;
+                continue;
+            }
+            for (int a = 0; a < inst->nArgs; a++){
+                extend(inst->args[a], pos);
+                used[inst->args[a]] = TRUE;
+            }
+            if (inst->dst >= 0)
+                extend(inst->dst, pos + 1);
+            if (isUserCall(inst))
+                calls[nCalls++] = pos;
+            pos += 2;
+        }
+        for (int v = 0; v < n; v++)
+            if (out[i * words + v / 32] & (1u << v % 32))
+                extend(v, pos);
+        pos += 2;
+    }
+    for (int v = 0; v < n; v++){
+        IrInst * d = ir->def[v];
+        int lo = 0, hi = nCalls;
+        if (d == NULL || !used[v])
+            continue;
+        if (d->op == IR_CONST || d->op == IR_ADDR){
+            ir->loc[v] = REMAT;
+            continue;
+        }
+        /* calls come in order: find the first one
+         * after the start of v
+         */
+        while (lo < hi){
+            int mid = (lo + hi) / 2;
+            if (calls[mid] <= start[v])
+                lo = mid + 1;
+            else
+                hi = mid;
+        }
+        if (lo < nCalls && calls[lo] < end[v])
+            ir->loc[v] = SPILL;
+        else
+            order[nOrder++] = v;
+    }
+    /* linear scan: when no register is free the
+     * interval ending last goes to a slot
+     */
+    qsort(order, nOrder, sizeof(int), byStart);
+    for (int i = 0; i < nOrder; i++){
+        int v = order[i], freeRegs[NREGS], nFree = 0, k = 0;
+        for (int j = 0; j < nActive; j++)
+            if (end[active[j]] >= start[v])
+                active[k++] = active[j];
+        nActive = k;
+        for (int r = 0; r < NREGS; r++){
+            int taken = FALSE;
+            for (int j = 0; j < nActive; j++)
+                if (ir->loc[active[j]] == regs[r])
+                    taken = TRUE;
+            if (!taken)
+                freeRegs[nFree++] = regs[r];
+        }
+        if (nFree > 0){
+            ir->loc[v] = freeRegs[0];
+            active[nActive++] = v;
+            continue;
+        }
+        k = 0;
+        for (int j = 1; j < nActive; j++)
+            if (end[active[j]] > end[active[k]])
+                k = j;
+        if (end[active[k]] > end[v]){
+            ir->loc[v] = ir->loc[active[k]];
+            ir->loc[active[k]] = SPILL;
+            active[k] = v;
+        }
+        else
+            ir->loc[v] = SPILL;
+    }
+    /* the values in slots share them as the
+     * registers are shared; parameters stay in
+     * their own
+     */
+    nOrder = 0;
+    for (int v = 0; v < n; v++)
+        if (ir->loc[v] == SPILL){
+            if (ir->def[v]->op == IR_PARAM)
+                ir->loc[v] = SLOT(FRAME_HEADER + ir->def[v]->imm);
+            else
+                order[nOrder++] = v;
+        }
+    qsort(order, nOrder, sizeof(int), byStart);
+    slotEnd = (int *)allocate(nOrder, sizeof(int));
+    for (int i = 0; i < nOrder; i++){
+        int v = order[i], k = 0;
+        while (k < size - ir->frameSize && slotEnd[k] >= start[v])
+            k++;
+        if (k == size - ir->frameSize)
+            size++;
+        slotEnd[k] = end[v];
+        ir->loc[v] = SLOT(ir->frameSize + k);
+    }
+    ir->size = size;
+    free(slotEnd);
+    free(in);
+    free(out);
+    free(calls);
+    free(order);
+    free(active);
+    free(used);
+    free(start);
+    free(end);
+    return size;
+}
+
+/********************************************/
+/* code generation                          */
+/********************************************/
+
+static IrFunc * ir;
+static int * loc;
+static int frameReg, frameBias;
+
+/* the block emitted after the current one */
+static IrBlock * next;
+
+/* the number of uses of each value */
+static int * uses;
+
+/* the code location of each block */
+static int * blockLoc;
+
+/* jumps emitted before their target: a block, or
+ * the stub at index stub if block is NULL
+ */
+typedef struct
+{
+    int loc;
+    char * op;
+    int r;
+    IrBlock * block;
+    int stub;
+} FixRec;
+
+static FixRec * fixes = NULL;
+static int nFixes = 0, maxFixes = 0;
+
+/* edges a branch takes to a block with phis */
+typedef struct
+{
+    IrBlock * from, * to;
+    int loc;
+} StubRec;
+
+static StubRec * stubs = NULL;
+static int nStubs = 0, maxStubs = 0;
+
+static void * grow(void * array, int n, int * max, int size)
+{
+    if (n < *max)
+        return array;
+    *max = (*max == 0) ? 16 : 2 * *max;
+    array = realloc(array, *max * size);
+    if (array == NULL){
+        fprintf(listing, "Out of memory error at line %d\n", lineno);
+        exit(-1);
+    }
+    return array;
+}
+
+static int slotOffset(int k)
+{
+    return frameBias - k;
+}
+
+/* Functions addrReg and addrOffset return the
+ * base register and displacement of the array an
+ * ADDR makes the address of
+ */
+static int addrReg(IrInst * d)
+{
+    return (d->decl->bind.storage == GlobalK) ? gp : frameReg;
+}
+
+static int addrOffset(IrInst * d)
+{
+    return (d->decl->bind.storage == GlobalK) ? d->decl->bind.offset : frameBias + d->imm;
+}
+
+/* Function fetch returns the register holding
+ * value v, loading it into r if it has none
+ */
+static int fetch(int v, int r)
+{
+    IrInst * d = ir->def[v];
+    if (d->op == IR_CONST)
+        emitRM("LDC", r, d->imm, 0, "load const");
+    else if (d->op == IR_ADDR)
+        emitRM("LDA", r, addrOffset(d), addrReg(d), "load array address");
+    else if (isReg(loc[v]))
+        return loc[v];
+    else
+        emitRM("LD", r, slotOffset(slotOf(loc[v])), frameReg, "reload value");
+    return r;
+}
+
+/* Function target returns the register value v
+ * is computed into
+ */
+static int target(int v)
+{
+    return (v >= 0 && isReg(loc[v])) ? loc[v] : ac;
+}
+
+/* Procedure move copies what location from holds
+ * into location to, through ac from slot to slot
+ */
+static void move(int from, int to)
+{
+    if (from == to)
+        return;
+    if (isReg(from) && isReg(to))
+        emitRM("LDA", to, 0, from, "copy value");
+    else if (isReg(from))
+        emitRM("ST", from, slotOffset(slotOf(to)), frameReg, "spill value");
+    else if (isReg(to))
+        emitRM("LD", to, slotOffset(slotOf(from)), frameReg, "reload value");
+    else {
+        emitRM("LD", ac, slotOffset(slotOf(from)), frameReg, "reload value");
+        emitRM("ST", ac, slotOffset(slotOf(to)), frameReg, "spill value");
+    }
+}
+
+/* Procedure save keeps value v, computed in
+ * register r, where it belongs
+ */
+static void save(int v, int r)
+{
+    if (v >= 0 && (isReg(loc[v]) || isSlot(loc[v])))
+        move(r, loc[v]);
+}
+
+/* Procedure emitJump emits a jump op on register
+ * r to a block or stub, patched once all code of
+ * the function is emitted
+ */
+static void emitJump(char * op, int r, IrBlock * b, int stub)
+{
+    fixes = grow(fixes, nFixes, &maxFixes, sizeof(FixRec));
+    fixes[nFixes].op = op;
+    fixes[nFixes].r = r;
+    fixes[nFixes].block = b;
+    fixes[nFixes].stub = stub;
+    fixes[nFixes++].loc = emitSkip(1);
+}
+
+static int hasPhis(IrBlock * b)
+{
+    return b->first != NULL && b->first->op == IR_PHI;
+}
+
+/* Procedure emitCopies emits the copies the phis
+ * of block to make on the edge from block from.
+ * They are parallel: a copy waits until no other
+ * reads its destination, and a cycle of copies is
+ * broken by moving one source to ac1 first
+ */
+static void emitCopies(IrBlock * from, IrBlock * to)
+{
+    int n = 0, k = 0, nPhis = 0;
+    int * src, * dst, * remat;
+    for (IrInst * phi = to->first; phi != NULL && phi->op == IR_PHI; phi = phi->next)
+        nPhis++;
+    if (nPhis == 0)
+        return;
+    while (to->preds[k] != from)
+        k++;
+    src = (int *)allocate(nPhis, sizeof(int));
+    dst = (int *)allocate(nPhis, sizeof(int));
+    remat = (int *)allocate(2 * nPhis, sizeof(int));
+    nPhis = 0;
+    for (IrInst * phi = to->first; phi != NULL && phi->op == IR_PHI; phi = phi->next){
+        int s = phi->args[k], d = loc[phi->dst];
+        if (d == NOWHERE || d == REMAT)
+            continue;
+        if (loc[s] == REMAT){
+            remat[2 * nPhis] = s;
+            remat[2 * nPhis++ + 1] = d;
+        }
+        else if (loc[s] != d){
+            src[n] = loc[s];
+            dst[n++] = d;
+        }
+    }
+    while (n > 0){
+        int ready = -1;
+        for (int i = 0; i < n && ready < 0; i++){
+            ready = i;
+            for (int j = 0; j < n; j++)
+                if (j != i && src[j] == dst[i])
+                    ready = -1;
+        }
+        if (ready < 0){
+            /* only cycles are left */
+            int s = src[0];
+            move(s, ac1);
+            for (int j = 0; j < n; j++)
+                if (src[j] == s)
+                    src[j] = ac1;
+            continue;
+        }
+        move(src[ready], dst[ready]);
+        src[ready] = src[n - 1];
+        dst[ready] = dst[n - 1];
+        n--;
+    }
+    for (int i = 0; i < nPhis; i++){
+        int d = remat[2 * i + 1];
+        move(fetch(remat[2 * i], isReg(d) ? d : ac), d);
+    }
+    free(src);
+    free(dst);
+    free(remat);
+}
+
+/* Procedure leave ends block from on its edge to
+ * block to
+ */
+static void leave(IrBlock * from, IrBlock * to)
+{
+    emitCopies(from, to);
+    if (to != next)
+        emitJump("LDA", pc, to, -1);
+}
+
+static int isRelational(TokenType op)
+{
+    return op == LT || op == LE || op == GT || op == GE || op == EQ || op == NE;
+}
+
+static char * jumpOp(TokenType op)
+{
+    switch (op){
+        case LT: return "JLT";
+        case LE: return "JLE";
+        case GT: return "JGT";
+        case GE: return "JGE";
+        case EQ: return "JEQ";
+        default: return "JNE";
+    }
+}
+
+static TokenType inverse(TokenType op)
+{
+    switch (op){
+        case LT: return GE;
+        case LE: return GT;
+        case GT: return LE;
+        case GE: return LT;
+        case EQ: return NE;
+        default: return EQ;
+    }
+}
+
+static int isZero(int v)
+{
+    return ir->def[v]->op == IR_CONST && ir->def[v]->imm == 0;
+}
+
+/* Function fused tells whether relational inst
+ * is computed by the branch right after it, its
+ * only use
+ */
+static int fused(IrInst * inst)
+{
+    return inst->op == IR_BIN && isRelational(inst->binop) && inst->next != NULL &&
+        inst->next->op == IR_BRANCH && inst->next->args[0] == inst->dst &&
+        uses[inst->dst] == 1;
+}
+
+/* Function compare emits the subtraction deciding
+ * relational inst and returns the register
+ * holding its result
+ */
+static int compare(IrInst * inst)
+{
+    int a, b;
+    if (isZero(inst->args[1]))
+        return fetch(inst->args[0], ac);
+    a = fetch(inst->args[0], ac1);
+    b = fetch(inst->args[1], ac);
+    emitRO("SUB", ac, a, b, "op relational");
+    return ac;
+}
+
+static void genBranch(IrInst * inst)
+{
+    IrBlock * b = inst->block, * t = inst->target[0], * f = inst->target[1];
+    IrInst * d = ir->def[inst->args[0]];
+    TokenType op = NE;
+    int r;
+    if (d->block == b && d->next == inst && fused(d)){
+        r = compare(d);
+        op = d->binop;
+    }
+    else
+        r = fetch(inst->args[0], ac);
+    if (!hasPhis(f) && (hasPhis(t) || t == next)){
+        emitBranchNote(emitSkip(0), inst->lineno, inst->site, FALSE);
+        emitJump(jumpOp(inverse(op)), r, f, -1);
+        leave(b, t);
+    }
+    else if (!hasPhis(t)){
+        emitBranchNote(emitSkip(0), inst->lineno, inst->site, TRUE);
+        emitJump(jumpOp(op), r, t, -1);
+        leave(b, f);
+    }
+    else {
+        stubs = grow(stubs, nStubs, &maxStubs, sizeof(StubRec));
+        stubs[nStubs].from = b;
+        stubs[nStubs].to = t;
+        emitBranchNote(emitSkip(0), inst->lineno, inst->site, TRUE);
+        emitJump(jumpOp(op), r, NULL, nStubs++);
+        leave(b, f);
+    }
+}
+
+/* Function reduced emits a * or / by a constant
+ * as shifts and adds into register t if that is
+ * cheaper and scratch registers are left, and
+ * tells whether it did. A value in no register is
+ * computed in ac1, where the operand is loaded
+ */
+static int reduced(IrInst * inst, int t)
+{
+    int x = inst->args[0], c = inst->args[1], s, u, k;
+    TokenType op = inst->binop;
+    IrInst * d;
+    if (op == TIMES && ir->def[x]->op == IR_CONST){
+        x = inst->args[1];
+        c = inst->args[0];
+    }
+    if (ir->def[c]->op != IR_CONST || !reducible(op, ir->def[c]->imm))
+        return FALSE;
+    d = ir->def[x];
+    s = (d->op != IR_CONST && d->op != IR_ADDR && isReg(loc[x])) ? loc[x] : ac1;
+    if (t == ac && s == ac1)
+        t = ac1;
+    u = (s != ac && t != ac) ? ac : ac1;
+    k = (t != s) ? t : (u == ac) ? ac1 : ac;
+    if (u == s || u == t || (op == OVER && (k == s || k == u)))
+        return FALSE;
+    emitReduced(op, t, fetch(x, ac1), ir->def[c]->imm, u, k);
+    save(inst->dst, t);
+    return TRUE;
+}
+
+static void genBin(IrInst * inst)
+{
+    int t = target(inst->dst), a, b;
+    int l = inst->args[0], r = inst->args[1];
+    IrInst * lc = ir->def[l], * rc = ir->def[r];
+    TokenType op = inst->binop;
+    if ((op == PLUS || op == MINUS) && rc->op == IR_CONST){
+        a = fetch(l, ac);
+        emitRM("LDA", t, (op == MINUS) ? -rc->imm : rc->imm, a, "op + constant");
+    }
+    else if (op == PLUS && lc->op == IR_CONST){
+        a = fetch(r, ac);
+        emitRM("LDA", t, lc->imm, a, "op + constant");
+    }
+    else if (reduced(inst, t))
+        return;
+    else if (isRelational(op)){
+        a = compare(inst);
+        emitRM(jumpOp(op), a, 2, pc, "br if true");
+        emitRM("LDC", t, 0, 0, "false case");
+        emitRM("LDA", pc, 1, pc, "unconditional jmp");
+        emitRM("LDC", t, 1, 0, "true case");
+    }
+    else {
+        a = fetch(l, ac1);
+        b = fetch(r, ac);
+        switch (op){
+            case PLUS: emitRO("ADD", t, a, b, "op +"); break;
+            case MINUS: emitRO("SUB", t, a, b, "op -"); break;
+            case TIMES: emitRO("MUL", t, a, b, "op *"); break;
+            default: emitRO("DIV", t, a, b, "op /"); break;
+        }
+    }
+    save(inst->dst, t);
+}
+
+/* Function passesLocalArray tells whether a call
+ * passes an array of the frame of the caller
+ */
+static int passesLocalArray(IrInst * inst)
+{
+    for (int a = 0; a < inst->nArgs; a++){
+        IrInst * d = ir->def[inst->args[a]];
+        if (d->op == IR_ADDR && d->decl->bind.storage != GlobalK)
+            return TRUE;
+    }
+    return FALSE;
+}
+
+/* Function isTailCall tells whether call inst
+ * ends the function, which then can jump to the
+ * callee as cgen does: a return of its value or
+ * of nothing follows, or a jump to such a return
+ */
+static int isTailCall(IrInst * inst)
+{
+    IrInst * ret = inst->next;
+    if (!isUserCall(inst) || inst->decl->bind.storage == VectorK || ret == NULL ||
+        passesLocalArray(inst))
+        return FALSE;
+    if (ret->op == IR_JUMP){
+        ret = ret->target[0]->first;
+        return ret->op == IR_RET && ret->nArgs == 0;
+    }
+    return ret->op == IR_RET && (ret->nArgs == 0 || ret->args[0] == inst->dst);
+}
+
+static void genReturn(void)
+{
+    if (frameReg == gp){
+        emitRM("LD", pc, frameBias - RET_SLOT, gp, "return");
+        return;
+    }
+    emitRM("LD", ac1, -RET_SLOT, fp, "load return address");
+    emitRM("LD", fp, -OFP_SLOT, fp, "restore caller fp");
+    emitRM("LDA", pc, 0, ac1, "return");
+}
+
+/* Procedure genTailCall stores the arguments of
+ * a tail call into the frame of the callee and
+ * jumps to it. A callee with its frame on the
+ * stack takes over the frame of the caller; the
+ * arguments go through slots below the frame if a
+ * slot they are read from would be overwritten
+ * first
+ */
+static void genTailCall(IrInst * inst)
+{
+    TreeNode * f = inst->decl;
+    int n = inst->nArgs;
+    if (TraceCode) emitComment("-> tail call");
+    if (f->bind.storage == StaticFuncK){
+        for (int i = 0; i < n; i++)
+            emitRM("ST", fetch(inst->args[i], ac), f->bind.frame - FRAME_HEADER - i, gp,
+                   "tail call: store argument");
+        if (frameReg == gp)
+            emitRM("LD", ac1, frameBias - RET_SLOT, gp, "tail call: load return address");
+        else
+            emitRM("LD", ac1, -RET_SLOT, fp, "tail call: load return address");
+        emitRM("ST", ac1, f->bind.frame - RET_SLOT, gp, "tail call: store return address");
+        if (frameReg == fp)
+            emitRM("LD", fp, -OFP_SLOT, fp, "tail call: restore caller fp");
+    }
+    else {
+        int staged = FALSE;
+        int base = (ir->size > FRAME_HEADER + n) ? ir->size : FRAME_HEADER + n;
+        for (int i = 0; i < n; i++){
+            int l = loc[inst->args[i]];
+            if (isSlot(l) && slotOf(l) >= FRAME_HEADER && slotOf(l) < FRAME_HEADER + i)
+                staged = TRUE;
+        }
+        for (int i = 0; i < n; i++){
+            int v = inst->args[i];
+            if (loc[v] == SLOT(FRAME_HEADER + i) && !staged)
+                continue;
+            emitRM("ST", fetch(v, ac), staged ? -(base + i) : -(FRAME_HEADER + i), fp,
+                   "tail call: store argument");
+        }
+        if (staged)
+            for (int i = 0; i < n; i++){
+                emitRM("LD", ac, -(base + i), fp, "tail call: load argument");
+                emitRM("ST", ac, -(FRAME_HEADER + i), fp, "tail call: store argument");
+            }
+    }
+    emitCallNote(emitSkip(0), inst->lineno, inst->site, f->attr.name);
+    emitRM("LDC", pc, f->bind.offset, 0, "tail call: jump to function");
+    if (TraceCode) emitComment("<- tail call");
+}
+
+/* Procedure genVector emits a call of a vector
+ * op, whose arguments are the arrays and values it
+ * works on, then the first and the end of the
+ * range of elements. Values live across it are
+ * kept in slots, as across a call, so its operands
+ * can go into ac1 and the registers values are
+ * kept in, once the arguments in them are read:
+ * the second operand into one not holding the
+ * third
+ */
+static void genVector(IrInst * inst)
+{
+    TreeNode * p = inst->decl->child[0];
+    int n = inst->nArgs - 2, r[3] = { ac1, regs[0], regs[1] }, i, end;
+    if (n > 2 && loc[inst->args[2]] == regs[0]){
+        r[1] = regs[1];
+        r[2] = regs[0];
+    }
+    end = fetch(inst->args[n + 1], ac1);
+    i = fetch(inst->args[n], ac);
+    emitRO("SUB", ac1, end, i, "vector: length");
+    emitRO("VSET", ac1, 0, 0, "vector: set length");
+    if (i != ac)
+        emitRM("LDA", ac, 0, i, "vector: first index");
+    for (int k = 0; k < n; k++, p = p->sibling){
+        int v = fetch(inst->args[k], r[k]);
+        if (p->kind.exp == ArrayDeclK)
+            emitRO("ADD", r[k], v, ac, "vector: first element");
+        else if (v != r[k])
+            emitRM("LDA", r[k], 0, v, "vector: value");
+    }
+    emitRO(inst->decl->attr.name, r[0], n > 1 ? r[1] : 0, n > 2 ? r[2] : 0, "vector op");
+}
+
+static void genCall(IrInst * inst)
+{
+    TreeNode * f = inst->decl;
+    int n = inst->nArgs;
+    if (f->bind.storage == BuiltinK){
+        int r = target(inst->dst);
+        if (n == 0)
+            emitRO("IN", r, 0, 0, "input integer value");
+        else {
+            r = fetch(inst->args[0], r);
+            emitRO("OUT", r, 0, 0, "output value");
+        }
+        save(inst->dst, r);
+        return;
+    }
+    if (f->bind.storage == VectorK){
+        genVector(inst);
+        return;
+    }
+    if (f->bind.storage == StaticFuncK){
+        int top = f->bind.frame;
+        for (int i = 0; i < n; i++)
+            emitRM("ST", fetch(inst->args[i], ac), top - FRAME_HEADER - i, gp,
+                   "call: store argument");
+        emitRM("LDA", ac, 2, pc, "call: return address");
+        emitRM("ST", ac, top - RET_SLOT, gp, "call: store return address");
+    }
+    else {
+        /* the frame of the callee follows this one */
+        int base = -ir->size;
+        for (int i = 0; i < n; i++)
+            emitRM("ST", fetch(inst->args[i], ac), base - FRAME_HEADER - i, fp,
+                   "call: store argument");
+        emitRM("ST", fp, base - OFP_SLOT, fp, "call: store caller fp");
+        emitRM("LDA", fp, base, fp, "call: push frame");
+        emitRM("LDA", ac, 2, pc, "call: return address");
+        emitRM("ST", ac, -RET_SLOT, fp, "call: store return address");
+    }
+    emitCallNote(emitSkip(0), inst->lineno, inst->site, f->attr.name);
+    emitRM("LDC", pc, f->bind.offset, 0, "call: jump to function");
+    save(inst->dst, ac);
+}
+
+/* Function genInst emits the code of inst and
+ * returns the instruction to go on with
+ */
+static IrInst * genInst(IrInst * inst)
+{
+    int t = target(inst->dst), a, v;
+    IrInst * d;
+    switch (inst->op){
+        case IR_CONST:
+        case IR_ADDR:
+        case IR_PHI:
+            break;
+        case IR_COPY:
+            save(inst->dst, fetch(inst->args[0], t));
+            break;
+        case IR_BIN:
+            if (!fused(inst))
+                genBin(inst);
+            break;
+        case IR_PARAM:
+            if (isReg(loc[inst->dst]))
+                emitRM("LD", t, slotOffset(FRAME_HEADER + inst->imm), frameReg, "load parameter");
+            break;
+        case IR_LOAD:
+            d = ir->def[inst->args[0]];
+            if (d->op == IR_ADDR)
+                emitRM("LD", t, addrOffset(d) + inst->imm, addrReg(d), "load element value");
+            else {
+                a = fetch(inst->args[0], ac1);
+                emitRM("LD", t, inst->imm, a, "load element value");
+            }
+            save(inst->dst, t);
+            break;
+        case IR_STORE:
+            d = ir->def[inst->args[0]];
+            v = fetch(inst->args[1], ac);
+            if (d->op == IR_ADDR)
+                emitRM("ST", v, addrOffset(d) + inst->imm, addrReg(d), "store element value");
+            else {
+                a = fetch(inst->args[0], ac1);
+                emitRM("ST", v, inst->imm, a, "store element value");
+            }
+            break;
+        case IR_GLOAD:
+            emitRM("LD", t, inst->decl->bind.offset, gp, "load global");
+            save(inst->dst, t);
+            break;
+        case IR_GSTORE:
+            emitRM("ST", fetch(inst->args[0], ac), inst->decl->bind.offset, gp, "store global");
+            break;
+        case IR_CALL:
+            if (isTailCall(inst)){
+                genTailCall(inst);
+                return NULL;
+            }
+            genCall(inst);
+            break;
+        case IR_JUMP:
+            leave(inst->block, inst->target[0]);
+            break;
+        case IR_BRANCH:
+            genBranch(inst);
+            break;
+        case IR_RET:
+            if (inst->nArgs > 0){
+                a = fetch(inst->args[0], ac);
+                if (a != ac)
+                    emitRM("LDA", ac, 0, a, "return value");
+            }
+            genReturn();
+            break;
+    }
+    return inst->next;
+}
+
+/********************************************/
+/* block layout                             */
+/********************************************/
+
+/* an edge a branch takes at most once in
+ * COLD_SHARE times it runs is cold
+ */
+#define COLD_SHARE 32
+
+/* Function edgeCount returns how often the
+ * profile found the edge from block b to its
+ * successor k taken, -1 if it does not tell; the
+ * times b branched at all are left in total
+ */
+static long edgeCount(IrBlock * b, int k, long * total)
+{
+    IrInst * t = b->last;
+    long taken, notTaken;
+    if (t == NULL || t->op != IR_BRANCH || !profileBranch(t->lineno, t->site, &taken, &notTaken))
+        return -1;
+    *total = taken + notTaken;
+    return (k == 0) ? taken : notTaken;
+}
+
+static int isCold(IrBlock * b, int k)
+{
+    long total, count = edgeCount(b, k, &total);
+    return count >= 0 && count * COLD_SHARE <= total;
+}
+
+/* Procedure place lists the blocks reached from
+ * b in postorder, visiting the successor taken
+ * more often first: the other then comes right
+ * after b, and the hot one runs on into the block
+ * where the two meet without a jump
+ */
+static void place(IrBlock * b, int * seen, IrBlock ** post, int * n)
+{
+    IrBlock * succ[2];
+    long total;
+    int k = irSuccs(b, succ);
+    seen[b->rpo] = TRUE;
+    if (k == 2 && edgeCount(b, 0, &total) > edgeCount(b, 1, &total)){
+        IrBlock * s = succ[0];
+        succ[0] = succ[1];
+        succ[1] = s;
+    }
+    for (int i = k - 1; i >= 0; i--)
+        if (!seen[succ[i]->rpo])
+            place(succ[i], seen, post, n);
+    post[(*n)++] = b;
+}
+
+/* Function layoutBlocks returns the blocks of ir
+ * in the order they are emitted. Without a profile
+ * they keep their reverse postorder. With one, the
+ * arm of a branch taken more often is laid out so
+ * the hot path needs no jump but the branch, and a
+ * block entered only by cold edges goes out of
+ * line, after the others. The registers are given
+ * out in reverse postorder all the same, so cold
+ * code does not stretch the intervals of the hot
+ */
+static IrBlock ** layoutBlocks(IrFunc * ir)
+{
+    int nb = ir->nBlocks, n = 0, k = 0;
+    int * seen, * pos, * cold;
+    IrBlock ** post, ** order = (IrBlock **)allocate(nb, sizeof(IrBlock *));
+    if (!profileLoaded()){
+        for (int i = 0; i < nb; i++)
+            order[i] = ir->blocks[i];
+        return order;
+    }
+    seen = (int *)allocate(nb, sizeof(int));
+    pos = (int *)allocate(nb, sizeof(int));
+    cold = (int *)allocate(nb, sizeof(int));
+    post = (IrBlock **)allocate(nb, sizeof(IrBlock *));
+    place(ir->blocks[0], seen, post, &n);
+    for (int i = 0; i < n; i++)
+        pos[post[i]->rpo] = n - 1 - i;
+    /* edges coming back from later blocks are
+     * left out: a loop is cold if it is entered
+     * only cold
+     */
+    for (int i = n - 2; i >= 0; i--){
+        IrBlock * b = post[i];
+        cold[b->rpo] = TRUE;
+        for (int p = 0; p < b->nPreds && cold[b->rpo]; p++){
+            IrBlock * q = b->preds[p], * succ[2];
+            int ns = irSuccs(q, succ);
+            if (pos[q->rpo] >= pos[b->rpo] || cold[q->rpo])
+                continue;
+            for (int s = 0; s < ns; s++)
+                if (succ[s] == b && !isCold(q, s))
+                    cold[b->rpo] = FALSE;
+        }
+    }
+    for (int i = n - 1; i >= 0; i--)
+        if (!cold[post[i]->rpo])
+            order[k++] = post[i];
+    for (int i = n - 1; i >= 0; i--)
+        if (cold[post[i]->rpo])
+            order[k++] = post[i];
+    free(seen);
+    free(pos);
+    free(cold);
+    free(post);
+    return order;
+}
+
+/* Procedure irGen generates the TM code of a
+ * function from its allocated SSA form; slot k of
+ * its frame is at bias-k from register reg
+ */
+void irGen(IrFunc * f, int reg, int bias)
+{
+    IrBlock ** order;
+    ir = f;
+    loc = f->loc;
+    frameReg = reg;
+    frameBias = bias;
+    nFixes = nStubs = 0;
+    uses = (int *)allocate(ir->nValues, sizeof(int));
+    blockLoc = (int *)allocate(ir->nBlocks, sizeof(int));
+    order = layoutBlocks(ir);
+    for (int i = 0; i < ir->nBlocks; i++)
+        for (IrInst * inst = ir->blocks[i]->first; inst != NULL; inst = inst->next)
+            for (int a = 0; a < inst->nArgs; a++)
+                uses[inst->args[a]]++;
+    for (int i = 0; i < ir->nBlocks; i++){
+        IrBlock * b = order[i];
+        IrInst * inst = b->first;
+        next = (i + 1 < ir->nBlocks) ? order[i + 1] : NULL;
+        blockLoc[b->rpo] = emitSkip(0);
+        while (inst != NULL)
+            inst = genInst(inst);
+    }
+    next = NULL;
+    for (int i = 0; i < nStubs; i++){
+        stubs[i].loc = emitSkip(0);
+        leave(stubs[i].from, stubs[i].to);
+    }
+    for (int i = 0; i < nFixes; i++){
+        FixRec * x = &fixes[i];
+        emitBackup(x->loc);
+        emitRM_Abs(x->op, x->r, (x->block != NULL) ? blockLoc[x->block->rpo] : stubs[x->stub].loc,
+                   "jump");
+        emitRestore();
+    }
+    free(uses);
+    free(blockLoc);
+    free(order);
+}
@@ -0,0 +1,26 @@
+/****************************************************/
+/* File: irgen.h                                    */
+/* TM code generation from the SSA form for the     */
+/* C-MINUS compiler                                 */
+/* Compiler Construction: Principles and Practice   */
+/* Kenneth C. Louden                                */
+/****************************************************/
+
+#ifndef _IRGEN_H_
+#define _IRGEN_H_
+
+#include "ir.h"
+
+/* Function irAllocate gives each value of ir a
+ * register or a frame slot, and returns the size
+ * of the frame of the function
+ */
+int irAllocate(IrFunc * ir);
+
+/* Procedure irGen generates the TM code of a
+ * function from its allocated SSA form; slot k of
+ * its frame is at bias-k from register reg
+ */
+void irGen(IrFunc * ir, int reg, int bias);
+
+#endif
@@ -0,0 +1,295 @@
+/****************************************************/
+/* File: irpass.c                                   */
+/* Optimization passes over the SSA form for the    */
+/* C-MINUS compiler                                 */
+/* Copy propagation maps each copy, and each phi    */
+/* all of whose arguments are one value, to that    */
+/* value until nothing changes, then rewrites the   */
+/* readers in one sweep. Dead code elimination      */
+/* marks what the stores, calls and terminators     */
+/* read, directly or not, and removes the rest.     */
+/* Load forwarding keeps, through each block, the   */
+/* values globals and array elements are known to   */
+/* hold: a load of one becomes a copy of the value, */
+/* a store changes it and forgets the elements it   */
+/* may overwrite, and a call forgets everything     */
+/* Compiler Construction: Principles and Practice   */
+/* Kenneth C. Louden                                */
+/****************************************************/
+
+#include "globals.h"
+#include "irpass.h"
+
+static int * allocate(int n)
+{
+    int * p = (int *)calloc(n + 1, sizeof(int));
+    if (p == NULL){
+        fprintf(listing, "Out of memory error at line %d\n", lineno);
+        exit(-1);
+    }
+    return p;
+}
+
+/* the value each value stands for */
+static int * repl;
+
+static int find(int v)
+{
+    int r = v;
+    while (repl[r] != r)
+        r = repl[r];
+    while (repl[v] != r){
+        int next = repl[v];
+        repl[v] = r;
+        v = next;
+    }
+    return r;
+}
+
+/* Procedure propagateCopies makes the readers of
+ * a copy, or of a phi whose arguments are all one
+ * value, read that value instead, and removes the
+ * copy or phi
+ */
+void propagateCopies(IrFunc * ir)
+{
+    int changed;
+    repl = allocate(ir->nValues);
+    for (int v = 0; v < ir->nValues; v++)
+        repl[v] = v;
+    do {
+        changed = FALSE;
+        for (int i = 0; i < ir->nBlocks; i++)
+            for (IrInst * inst = ir->blocks[i]->first; inst != NULL; inst = inst->next){
+                int same = -1;
+                if (inst->dst < 0 || repl[inst->dst] != inst->dst)
+                    continue;
+                if (inst->op == IR_COPY)
+                    same = find(inst->args[0]);
+                else if (inst->op == IR_PHI)
+                    for (int k = 0; k < inst->nArgs; k++){
+                        int a = find(inst->args[k]);
+                        if (a == inst->dst || a == same)
+                            continue;
+                        if (same >= 0){
+                            same = -1;
+                            break;
+                        }
+                        same = a;
+                    }
+                if (same >= 0 && same != inst->dst){
+                    repl[inst->dst] = same;
+                    changed = TRUE;
+                }
+            }
+    } while (changed);
+    for (int i = 0; i < ir->nBlocks; i++){
+        IrInst * inst = ir->blocks[i]->first;
+        while (inst != NULL){
+            IrInst * next = inst->next;
+            if (inst->dst >= 0 && repl[inst->dst] != inst->dst)
+                irRemove(ir, inst);
+            else
+                for (int k = 0; k < inst->nArgs; k++)
+                    inst->args[k] = find(inst->args[k]);
+            inst = next;
+        }
+    }
+    free(repl);
+}
+
+/* Procedure removeDeadValues removes the
+ * instructions whose values nothing with an
+ * effect needs, directly or not
+ */
+void removeDeadValues(IrFunc * ir)
+{
+    int * live = allocate(ir->nValues);
+    IrInst ** work = (IrInst **)calloc(ir->nValues + 1, sizeof(IrInst *));
+    int nWork = 0;
+    if (work == NULL){
+        fprintf(listing, "Out of memory error at line %d\n", lineno);
+        exit(-1);
+    }
+    for (int i = 0; i < ir->nBlocks; i++)
+        for (IrInst * inst = ir->blocks[i]->first; inst != NULL; inst = inst->next)
+            if (irHasEffect(inst))
+                for (int k = 0; k < inst->nArgs; k++)
+                    if (!live[inst->args[k]]){
+                        live[inst->args[k]] = TRUE;
+                        work[nWork++] = ir->def[inst->args[k]];
+                    }
+    while (nWork > 0){
+        IrInst * inst = work[--nWork];
+        for (int k = 0; k < inst->nArgs; k++)
+            if (!live[inst->args[k]]){
+                live[inst->args[k]] = TRUE;
+                work[nWork++] = ir->def[inst->args[k]];
+            }
+    }
+    for (int i = 0; i < ir->nBlocks; i++){
+        IrInst * inst = ir->blocks[i]->first;
+        while (inst != NULL){
+            IrInst * next = inst->next;
+            if (inst->dst >= 0 && !live[inst->dst] && !irHasEffect(inst))
+                irRemove(ir, inst);
+            inst = next;
+        }
+    }
+    free(live);
+    free(work);
+}
+
+/* a value memory is known to hold: global decl,
+ * or if decl is NULL the array element imm words
+ * from address base
+ */
+typedef struct
+{
+    TreeNode * decl;
+    int base, imm;
+    int value;
+} AvailRec;
+
+static AvailRec * avail = NULL;
+static int nAvail = 0, maxAvail = 0;
+
+/* Function arrayOf returns the instruction taking
+ * the address of the array address v points into,
+ * NULL if it is not known, as for an array passed
+ * as a parameter
+ */
+static IrInst * arrayOf(IrFunc * ir, int v)
+{
+    IrInst * d = ir->def[v];
+    while (d != NULL && (d->op == IR_COPY ||
+           (d->op == IR_BIN && (d->binop == PLUS || d->binop == MINUS))))
+        d = ir->def[d->args[0]];
+    return (d != NULL && d->op == IR_ADDR) ? d : NULL;
+}
+
+/* Function sameElement tells whether elements
+ * (b1, i1) and (b2, i2) are surely one
+ */
+static int sameElement(IrFunc * ir, int b1, int i1, int b2, int i2)
+{
+    IrInst * d1 = ir->def[b1], * d2 = ir->def[b2];
+    if (i1 != i2)
+        return FALSE;
+    return b1 == b2 || (d1->op == IR_ADDR && d2->op == IR_ADDR && d1->decl == d2->decl);
+}
+
+/* Function mayAlias tells whether elements
+ * (b1, i1) and (b2, i2) may be one: they are not
+ * if they lie in different arrays, or at
+ * different constant offsets in the same one
+ */
+static int mayAlias(IrFunc * ir, int b1, int i1, int b2, int i2)
+{
+    IrInst * r1 = arrayOf(ir, b1), * r2 = arrayOf(ir, b2);
+    if (b1 == b2)
+        return i1 == i2;
+    if (r1 == NULL || r2 == NULL)
+        return TRUE;
+    if (r1->decl != r2->decl)
+        return FALSE;
+    if (ir->def[b1] == r1 && ir->def[b2] == r2)
+        return i1 == i2;
+    return TRUE;
+}
+
+static void remember(TreeNode * decl, int base, int imm, int value)
+{
+    if (nAvail == maxAvail){
+        maxAvail = (maxAvail == 0) ? 16 : 2 * maxAvail;
+        avail = (AvailRec *)realloc(avail, maxAvail * sizeof(AvailRec));
+        if (avail == NULL){
+            fprintf(listing, "Out of memory error at line %d\n", lineno);
+            exit(-1);
+        }
+    }
+    avail[nAvail].decl = decl;
+    avail[nAvail].base = base;
+    avail[nAvail].imm = imm;
+    avail[nAvail++].value = value;
+}
+
+/* Procedure forget drops what is known of global
+ * decl or, with decl NULL, of the elements that
+ * element (base, imm) may be
+ */
+static void forget(IrFunc * ir, TreeNode * decl, int base, int imm)
+{
+    int k = 0;
+    for (int i = 0; i < nAvail; i++){
+        AvailRec * a = &avail[i];
+        if (decl != NULL ? a->decl == decl :
+            a->decl == NULL && mayAlias(ir, a->base, a->imm, base, imm))
+            continue;
+        avail[k++] = *a;
+    }
+    nAvail = k;
+}
+
+/* Procedure reuse makes load inst a copy of
+ * value v
+ */
+static void reuse(IrInst * inst, int v)
+{
+    inst->op = IR_COPY;
+    inst->nArgs = 0;
+    inst->decl = NULL;
+    inst->imm = 0;
+    irAddArg(inst, v);
+}
+
+/* Procedure forwardLoads makes each load of a
+ * global or array element whose value is known
+ * in its block, from a load or store before it,
+ * a copy of that value. A store may change the
+ * elements of its array, a call of a function
+ * any global or element
+ */
+void forwardLoads(IrFunc * ir)
+{
+    for (int i = 0; i < ir->nBlocks; i++){
+        nAvail = 0;
+        for (IrInst * inst = ir->blocks[i]->first; inst != NULL; inst = inst->next){
+            int k;
+            switch (inst->op){
+                case IR_GLOAD:
+                    for (k = 0; k < nAvail && avail[k].decl != inst->decl; k++)
+                        ;
+                    if (k < nAvail)
+                        reuse(inst, avail[k].value);
+                    else
+                        remember(inst->decl, -1, 0, inst->dst);
+                    break;
+                case IR_GSTORE:
+                    forget(ir, inst->decl, -1, 0);
+                    remember(inst->decl, -1, 0, inst->args[0]);
+                    break;
+                case IR_LOAD:
+                    for (k = 0; k < nAvail; k++)
+                        if (avail[k].decl == NULL &&
+                            sameElement(ir, avail[k].base, avail[k].imm, inst->args[0], inst->imm))
+                            break;
+                    if (k < nAvail)
+                        reuse(inst, avail[k].value);
+                    else
+                        remember(NULL, inst->args[0], inst->imm, inst->dst);
+                    break;
+                case IR_STORE:
+                    forget(ir, NULL, inst->args[0], inst->imm);
+                    remember(NULL, inst->args[0], inst->imm, inst->args[1]);
+                    break;
+                case IR_CALL:
+                    if (inst->decl->bind.storage != BuiltinK)
+                        nAvail = 0;
+                    break;
+                default:
+                    break;
+            }
+        }
+    }
+}
@@ -0,0 +1,36 @@
+/****************************************************/
+/* File: irpass.h                                   */
+/* Optimization passes over the SSA form for the    */
+/* C-MINUS compiler                                 */
+/* Compiler Construction: Principles and Practice   */
+/* Kenneth C. Louden                                */
+/****************************************************/
+
+#ifndef _IRPASS_H_
+#define _IRPASS_H_
+
+#include "ir.h"
+
+/* Procedure propagateCopies makes the readers of
+ * a copy, or of a phi whose arguments are all one
+ * value, read that value instead, and removes the
+ * copy or phi
+ */
+void propagateCopies(IrFunc * ir);
+
+/* Procedure removeDeadValues removes the
+ * instructions whose values nothing with an
+ * effect needs, directly or not
+ */
+void removeDeadValues(IrFunc * ir);
+
+/* Procedure forwardLoads makes each load of a
+ * global or array element whose value is known
+ * in its block, from a load or store before it,
+ * a copy of that value. A store may change the
+ * elements of its array, a call of a function
+ * any global or element
+ */
+void forwardLoads(IrFunc * ir);
+
+#endif
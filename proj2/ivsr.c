@@ -0,0 +1,376 @@
+/****************************************************/
+/* File: ivsr.c                                     */
+/* Induction variable strength reduction for the    */
+/* C-MINUS compiler                                 */
+/* A basic induction variable i of a while loop is  */
+/* a local the loop assigns once, by a statement    */
+/* i = i + c of its body run every iteration. For   */
+/* an array a indexed by i, i + k or i - k in the   */
+/* loop, a temp p = a + i is set before the loop    */
+/* and stepped by c right after i, so a[i + k] is   */
+/* p[k]: the element address is a load of p and a   */
+/* displacement instead of an addition per access   */
+/* Compiler Construction: Principles and Practice   */
+/* Kenneth C. Louden                                */
+/****************************************************/
+
+#include "globals.h"
+#include "util.h"
+#include "ivsr.h"
+
+/* costs in TM instructions of the code cgen.c
+ * generates: an access through a temp saves
+ * LOAD_SAVING on a load and STORE_SAVING on a
+ * store, stepping the temp costs STEP_COST every
+ * iteration. Only the accesses made every
+ * iteration count towards the saving
+ */
+#define LOAD_SAVING 2
+#define STORE_SAVING 4
+#define STEP_COST 3
+
+/* the function being optimized */
+static TreeNode * func;
+
+/* the scalars the loop assigns, with the number
+ * of assignments to each
+ */
+typedef struct
+{
+    TreeNode * decl;
+    int count;
+} CountRec;
+
+static CountRec * counts = NULL;
+static int nCounts = 0, maxCounts = 0;
+
+/* an element the induction variable indexes:
+ * node is the identifier, disp is k in a[i + k]
+ */
+typedef struct
+{
+    TreeNode * node;
+    int disp;
+    int isStore;
+    int every;      /* evaluated every iteration */
+} AccessRec;
+
+static AccessRec * accesses = NULL;
+static int nAccesses = 0, maxAccesses = 0;
+
+static void * grow(void * array, int n, int * max, int size)
+{
+    if (n < *max)
+        return array;
+    *max = (*max == 0) ? 16 : 2 * *max;
+    array = realloc(array, *max * size);
+    if (array == NULL){
+        fprintf(listing, "Out of memory error at line %d\n", lineno);
+        exit(-1);
+    }
+    return array;
+}
+
+/* Procedure countAssigns counts the assignments
+ * to scalars in the statements or expressions of
+ * a list
+ */
+static void countAssigns(TreeNode * t)
+{
+    while (t != NULL){
+        if (isAssign(t) && !t->child[0]->bind.isArray){
+            int i;
+            for (i = 0; i < nCounts; i++)
+                if (counts[i].decl == t->child[0]->decl)
+                    break;
+            if (i == nCounts){
+                counts = grow(counts, nCounts, &maxCounts, sizeof(CountRec));
+                counts[nCounts].decl = t->child[0]->decl;
+                counts[nCounts++].count = 0;
+            }
+            counts[i].count++;
+        }
+        for (int i = 0; i < MAXCHILDREN; i++)
+            countAssigns(t->child[i]);
+        t = t->sibling;
+    }
+}
+
+static int assignCount(TreeNode * decl)
+{
+    for (int i = 0; i < nCounts; i++)
+        if (counts[i].decl == decl)
+            return counts[i].count;
+    return 0;
+}
+
+/* Function offsetFrom tells whether expression t
+ * is iv, iv + k, k + iv or iv - k, setting disp
+ * to the constant added
+ */
+static int offsetFrom(TreeNode * t, TreeNode * iv, int * disp)
+{
+    TreeNode * l, * r;
+    if (isScalar(t, iv)){
+        *disp = 0;
+        return TRUE;
+    }
+    if (t->nodekind != StmtK || t->kind.stmt != AdditiveStmtK)
+        return FALSE;
+    l = t->child[0];
+    r = t->child[2];
+    if (t->child[1]->attr.op == PLUS){
+        if (isScalar(l, iv) && isConst(r)){
+            *disp = r->attr.val;
+            return TRUE;
+        }
+        if (isConst(l) && isScalar(r, iv)){
+            *disp = l->attr.val;
+            return TRUE;
+        }
+    }
+    else if (isScalar(l, iv) && isConst(r)){
+        *disp = -r->attr.val;
+        return TRUE;
+    }
+    return FALSE;
+}
+
+/* Function isStep tells whether statement t is
+ * i = i + c, i = c + i or i = i - c for a local i,
+ * setting iv to its declaration and step to c
+ */
+static int isStep(TreeNode * t, TreeNode ** iv, int * step)
+{
+    TreeNode * lhs;
+    if (!isAssign(t))
+        return FALSE;
+    lhs = t->child[0];
+    if (lhs->bind.isArray || (lhs->bind.storage != LocalK && lhs->bind.storage != ParamK))
+        return FALSE;
+    *iv = lhs->decl;
+    return offsetFrom(t->child[1], lhs->decl, step) && !isScalar(t->child[1], lhs->decl);
+}
+
+/* Procedure collect records the elements of
+ * arrays indexed by iv in expression t; every is
+ * set when t is evaluated every iteration
+ */
+static void collect(TreeNode * t, TreeNode * iv, int every)
+{
+    TreeNode * e = NULL;
+    int disp;
+    if (t == NULL)
+        return;
+    if (t->nodekind == StmtK && t->kind.stmt == CallK){
+        for (TreeNode * a = t->child[0]; a != NULL; a = a->sibling)
+            collect(a, iv, every);
+        return;
+    }
+    if (isAssign(t) && t->child[0]->bind.isArray)
+        e = t->child[0];
+    else if (t->nodekind == ExpK && t->kind.exp == IdK && t->bind.isArray && t->child[0] != NULL)
+        e = t;
+    if (e != NULL && e->decl->bind.isArray && offsetFrom(e->child[0], iv, &disp)){
+        accesses = grow(accesses, nAccesses, &maxAccesses, sizeof(AccessRec));
+        accesses[nAccesses].node = e;
+        accesses[nAccesses].disp = disp;
+        accesses[nAccesses].isStore = (e != t);
+        accesses[nAccesses++].every = every;
+        if (e != t)
+            collect(t->child[1], iv, every);
+        return;
+    }
+    for (int i = 0; i < MAXCHILDREN; i++)
+        collect(t->child[i], iv, every);
+}
+
+/* Procedure collectStmts records the elements
+ * indexed by iv in a list of statements
+ */
+static void collectStmts(TreeNode * t, TreeNode * iv, int every)
+{
+    for (; t != NULL; t = t->sibling){
+        if (t->nodekind == StmtK)
+            switch (t->kind.stmt){
+                case CompoundStmtK:
+                    collectStmts(t->child[1], iv, every);
+                    continue;
+                case SelectionStmtK:
+                    collect(t->child[0], iv, every);
+                    collectStmts(t->child[1], iv, FALSE);
+                    collectStmts(t->child[2], iv, FALSE);
+                    continue;
+                case IterationStmtK:
+                    collect(t->child[0], iv, every);
+                    collectStmts(t->child[1], iv, FALSE);
+                    continue;
+                case ReturnStmtK:
+                    collect(t->child[0], iv, every);
+                    continue;
+                default:
+                    break;
+            }
+        collect(t, iv, every);
+    }
+}
+
+/* Function newSum creates the expression l + r,
+ * or l - r for op MINUS
+ */
+static TreeNode * newSum(TreeNode * l, TokenType op, TreeNode * r)
+{
+    TreeNode * t = newStmtNode(AdditiveStmtK);
+    t->lineno = l->lineno;
+    t->type = Integer;
+    t->child[0] = l;
+    t->child[1] = newExpNode(OpK);
+    t->child[1]->attr.op = op;
+    t->child[1]->lineno = l->lineno;
+    t->child[2] = r;
+    return t;
+}
+
+/* Procedure viaTemp makes element e of an array
+ * indexed by an induction variable the element
+ * disp of temp, which holds an element address:
+ * it is bound like an array parameter
+ */
+static void viaTemp(TreeNode * e, TreeNode * temp, int disp)
+{
+    freeTree(e->child[0]);
+    free(e->attr.name);
+    e->attr.name = copyString(temp->attr.name);
+    e->decl = temp;
+    e->bind.storage = ParamK;
+    e->bind.offset = temp->bind.offset;
+    e->bind.isArray = TRUE;
+    e->child[0] = newConst(disp, e->lineno);
+}
+
+/* Function reduceArrays gives the arrays indexed
+ * by the induction variable stepped by statement
+ * step of loop their temps where that pays, and
+ * returns the statements setting the temps
+ */
+static TreeNode * reduceArrays(TreeNode * loop, TreeNode * step, TreeNode * iv, int c)
+{
+    TreeNode * inits = NULL, ** last = &inits;
+    nAccesses = 0;
+    collect(loop->child[0], iv, TRUE);
+    collectStmts(loop->child[1], iv, TRUE);
+    for (int i = 0; i < nAccesses; i++){
+        TreeNode * array, * temp, * s;
+        int saving = 0;
+        if (accesses[i].node == NULL)
+            continue;
+        array = accesses[i].node->decl;
+        for (int j = i; j < nAccesses; j++)
+            if (accesses[j].node != NULL && accesses[j].node->decl == array &&
+                accesses[j].every)
+                saving += accesses[j].isStore ? STORE_SAVING : LOAD_SAVING;
+        if (saving <= STEP_COST)
+            continue;
+        temp = newTemp(func, func->size++);
+        temp->lineno = loop->lineno;
+        /* temp = a + i before the loop */
+        s = newAssign(newTempId(temp, loop->lineno),
+            newSum(newName(accesses[i].node, loop->lineno), PLUS,
+            newName(step->child[0], loop->lineno)));
+        *last = s;
+        last = &s->sibling;
+        /* temp = temp + c after i = i + c */
+        s = newAssign(newTempId(temp, step->lineno),
+            newSum(newTempId(temp, step->lineno), (c < 0) ? MINUS : PLUS,
+            newConst((c < 0) ? -c : c, step->lineno)));
+        s->sibling = step->sibling;
+        step->sibling = s;
+        for (int j = i; j < nAccesses; j++)
+            if (accesses[j].node != NULL && accesses[j].node->decl == array){
+                viaTemp(accesses[j].node, temp, accesses[j].disp);
+                accesses[j].node = NULL;
+            }
+    }
+    return inits;
+}
+
+/* Function reduceLoop reduces the induction
+ * variables of the while statement at loc and
+ * returns where the while statement is then
+ * linked from
+ */
+static TreeNode ** reduceLoop(TreeNode ** loc)
+{
+    TreeNode * loop = *loc;
+    TreeNode * body = loop->child[1];
+    TreeNode * iv;
+    int c;
+    if (body == NULL)
+        return loc;
+    if (body->nodekind == StmtK && body->kind.stmt == CompoundStmtK)
+        body = body->child[1];
+    nCounts = 0;
+    countAssigns(loop->child[0]);
+    countAssigns(loop->child[1]);
+    for (TreeNode * s = body; s != NULL; s = s->sibling)
+        if (isStep(s, &iv, &c) && assignCount(iv) == 1){
+            TreeNode * inits = reduceArrays(loop, s, iv, c);
+            if (inits != NULL){
+                TreeNode * last = inits;
+                while (last->sibling != NULL)
+                    last = last->sibling;
+                last->sibling = loop;
+                *loc = inits;
+                loc = &last->sibling;
+            }
+        }
+    return loc;
+}
+
+/* Procedure reduceStmts reduces the loops of a
+ * list of statements, inner loops first
+ */
+static void reduceStmts(TreeNode ** loc)
+{
+    for (; *loc != NULL; loc = &(*loc)->sibling){
+        TreeNode * t = *loc;
+        if (t->nodekind != StmtK)
+            continue;
+        switch (t->kind.stmt){
+            case CompoundStmtK:
+                reduceStmts(&t->child[1]);
+                break;
+            case SelectionStmtK:
+                reduceStmts(&t->child[1]);
+                reduceStmts(&t->child[2]);
+                break;
+            case IterationStmtK:
+                reduceStmts(&t->child[1]);
+                loc = reduceLoop(loc);
+                break;
+            default:
+                break;
+        }
+    }
+}
+
+/* Procedure reduceInductionVars finds the basic
+ * induction variables of the while loops of an
+ * analyzed program, locals stepped by a constant
+ * once an iteration, and indexes the arrays they
+ * index through temps holding the element address,
+ * stepped along with the variable
+ */
+void reduceInductionVars(TreeNode * syntaxTree)
+{
+    for (TreeNode * t = syntaxTree; t != NULL; t = t->sibling)
+        if (t->kind.exp == FuncDeclK){
+            func = t;
+            reduceStmts(&t->child[1]->child[1]);
+        }
+    free(counts);
+    free(accesses);
+    counts = NULL;
+    accesses = NULL;
+    maxCounts = maxAccesses = 0;
+}
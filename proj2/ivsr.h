@@ -0,0 +1,21 @@
+/****************************************************/
+/* File: ivsr.h                                     */
+/* Induction variable strength reduction for the    */
+/* C-MINUS compiler                                 */
+/* Compiler Construction: Principles and Practice   */
+/* Kenneth C. Louden                                */
+/****************************************************/
+
+#ifndef _IVSR_H_
+#define _IVSR_H_
+
+/* Procedure reduceInductionVars finds the basic
+ * induction variables of the while loops of an
+ * analyzed program, locals stepped by a constant
+ * once an iteration, and indexes the arrays they
+ * index through temps holding the element address,
+ * stepped along with the variable
+ */
+void reduceInductionVars(TreeNode * syntaxTree);
+
+#endif
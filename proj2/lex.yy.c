@@ -341,6 +341,9 @@ void yyfree (void *  );
 
 /* Begin user sect3 */
 
+#define yywrap(n) 1
+#define YY_SKIP_YYWRAP
+
 typedef unsigned char YY_CHAR;
 
 FILE *yyin = (FILE *) 0, *yyout = (FILE *) 0;
@@ -570,6 +573,8 @@ extern int yywrap (void );
 #endif
 #endif
 
+#define YY_NO_UNPUT 1
+
 #ifndef YY_NO_UNPUT
     
     static void yyunput (int c,char *buf_ptr  );
@@ -1975,10 +1980,11 @@ void yyfree (void * ptr )
 
 
 
+static int firstTime = TRUE;
+
 TokenType getToken(void)
 { 
     //printf("tiny.l\n");
-    static int firstTime = TRUE;
   TokenType currentToken;
   if (firstTime)
   { 
@@ -2007,6 +2013,13 @@ TokenType getToken(void)
   return currentToken;
 }
 
+void resetScanner(void)
+{
+    firstTime = TRUE;
+    lineno = 0;
+    yyrestart(source);
+}
+
         //    fprintf(listing, ",%s\n", tokenString);
          //   break;
 
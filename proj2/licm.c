@@ -0,0 +1,315 @@
+/****************************************************/
+/* File: licm.c                                     */
+/* Loop-invariant code motion for the C-MINUS       */
+/* compiler                                         */
+/* An operation is invariant in a while loop when   */
+/* no variable it reads is assigned in the loop; an */
+/* array element also needs a loop that stores no   */
+/* element and calls no function. The value is      */
+/* computed once into a temp before the loop. Code  */
+/* there runs even when the body would not, so from */
+/* the body only operations that cannot stop the TM */
+/* move: no element loads and no division unless by */
+/* a nonzero constant. The test runs at least once, */
+/* so anything invariant moves out of it            */
+/* Compiler Construction: Principles and Practice   */
+/* Kenneth C. Louden                                */
+/****************************************************/
+
+#include "globals.h"
+#include "util.h"
+#include "licm.h"
+
+/* the function being optimized */
+static TreeNode * func;
+
+/* what the loop being optimized may change */
+static TreeNode ** assigned = NULL;
+static int nAssigned = 0, maxAssigned = 0;
+static int storesElement;
+static int callsFunction;
+
+/* the operations moved out of the loop and the
+ * temps holding them
+ */
+typedef struct
+{
+    TreeNode * exp;
+    TreeNode * temp;
+} HoistRec;
+
+static HoistRec * hoisted = NULL;
+static int nHoisted = 0, maxHoisted = 0;
+
+static void * grow(void * array, int n, int * max, int size)
+{
+    if (n < *max)
+        return array;
+    *max = (*max == 0) ? 16 : 2 * *max;
+    array = realloc(array, *max * size);
+    if (array == NULL){
+        fprintf(listing, "Out of memory error at line %d\n", lineno);
+        exit(-1);
+    }
+    return array;
+}
+
+static int isBinary(TreeNode * t)
+{
+    return t->nodekind == StmtK && (t->kind.stmt == SimpleStmtK ||
+        t->kind.stmt == AdditiveStmtK || t->kind.stmt == TermK);
+}
+
+static int isElement(TreeNode * t)
+{
+    return t->nodekind == ExpK && t->kind.exp == IdK &&
+        t->bind.isArray && t->child[0] != NULL;
+}
+
+/* Procedure scanEffects records what the
+ * statements or expressions of a list change
+ */
+static void scanEffects(TreeNode * t)
+{
+    while (t != NULL){
+        if (t->nodekind == StmtK && t->kind.stmt == CallK &&
+            t->decl->bind.storage != BuiltinK)
+            callsFunction = TRUE;
+        if (t->nodekind == ExpK && t->kind.exp == AssignK){
+            if (t->child[0]->bind.isArray)
+                storesElement = TRUE;
+            else {
+                assigned = grow(assigned, nAssigned, &maxAssigned, sizeof(TreeNode *));
+                assigned[nAssigned++] = t->child[0]->decl;
+            }
+        }
+        for (int i = 0; i < MAXCHILDREN; i++)
+            scanEffects(t->child[i]);
+        t = t->sibling;
+    }
+}
+
+static int isAssigned(TreeNode * decl)
+{
+    for (int i = 0; i < nAssigned; i++)
+        if (assigned[i] == decl)
+            return TRUE;
+    return FALSE;
+}
+
+/* Function invariant tells whether expression t
+ * has the same value all through the loop and may
+ * be computed before it; inTest is set for the
+ * test of the loop
+ */
+static int invariant(TreeNode * t, int inTest)
+{
+    if (isBinary(t)){
+        if (!inTest && t->child[1]->attr.op == OVER &&
+            !(isConst(t->child[2]) && t->child[2]->attr.val != 0))
+            return FALSE;
+        return invariant(t->child[0], inTest) && invariant(t->child[2], inTest);
+    }
+    if (t->nodekind != ExpK)
+        return FALSE;
+    switch (t->kind.exp){
+        case ConstK:
+            return TRUE;
+        case IdK:
+            if (!t->bind.isArray){
+                if (t->bind.storage == GlobalK && callsFunction)
+                    return FALSE;
+                return !isAssigned(t->decl);
+            }
+            if (t->child[0] == NULL)
+                return TRUE;
+            return inTest && !storesElement && !callsFunction &&
+                !isAssigned(t->decl) && invariant(t->child[0], inTest);
+        default:
+            return FALSE;
+    }
+}
+
+/* Function sameExp tells whether two invariant
+ * expressions compute the same value
+ */
+static int sameExp(TreeNode * a, TreeNode * b)
+{
+    if (a == NULL || b == NULL)
+        return a == b;
+    if (a->nodekind != b->nodekind)
+        return FALSE;
+    if (a->nodekind == StmtK)
+        return a->kind.stmt == b->kind.stmt &&
+            a->child[1]->attr.op == b->child[1]->attr.op &&
+            sameExp(a->child[0], b->child[0]) && sameExp(a->child[2], b->child[2]);
+    if (a->kind.exp != b->kind.exp)
+        return FALSE;
+    if (a->kind.exp == ConstK)
+        return a->attr.val == b->attr.val;
+    return a->decl == b->decl && sameExp(a->child[0], b->child[0]);
+}
+
+/* Function tempFor returns an identifier naming
+ * the temp invariant t is moved into, keeping t
+ * for the code before the loop unless an equal
+ * expression is there already
+ */
+static TreeNode * tempFor(TreeNode * t)
+{
+    for (int i = 0; i < nHoisted; i++)
+        if (sameExp(hoisted[i].exp, t)){
+            TreeNode * id = newTempId(hoisted[i].temp, t->lineno);
+            freeTree(t);
+            return id;
+        }
+    hoisted = grow(hoisted, nHoisted, &maxHoisted, sizeof(HoistRec));
+    hoisted[nHoisted].exp = t;
+    hoisted[nHoisted].temp = newTemp(func, func->size++);
+    hoisted[nHoisted].temp->lineno = t->lineno;
+    return newTempId(hoisted[nHoisted++].temp, t->lineno);
+}
+
+/* Procedure hoistExp moves the largest invariant
+ * operations and element loads of the expression
+ * at loc out of the loop
+ */
+static void hoistExp(TreeNode ** loc, int inTest)
+{
+    TreeNode * t = *loc;
+    if (t == NULL)
+        return;
+    if ((isBinary(t) || isElement(t)) && invariant(t, inTest)){
+        TreeNode * next = t->sibling;
+        t->sibling = NULL;
+        *loc = tempFor(t);
+        (*loc)->sibling = next;
+        return;
+    }
+    if (t->nodekind == StmtK){
+        if (t->kind.stmt == CallK)
+            for (loc = &t->child[0]; *loc != NULL; loc = &(*loc)->sibling)
+                hoistExp(loc, inTest);
+        else if (isBinary(t)){
+            hoistExp(&t->child[0], inTest);
+            hoistExp(&t->child[2], inTest);
+        }
+        return;
+    }
+    switch (t->kind.exp){
+        case IdK:
+            hoistExp(&t->child[0], inTest);
+            break;
+        case AssignK:
+            hoistExp(&t->child[0]->child[0], inTest);
+            hoistExp(&t->child[1], inTest);
+            break;
+        default:
+            break;
+    }
+}
+
+/* Procedure hoistStmts moves the invariants out
+ * of the statements of a loop body
+ */
+static void hoistStmts(TreeNode ** loc)
+{
+    for (; *loc != NULL; loc = &(*loc)->sibling){
+        TreeNode * t = *loc;
+        if (t->nodekind == StmtK){
+            switch (t->kind.stmt){
+                case CompoundStmtK:
+                    hoistStmts(&t->child[1]);
+                    continue;
+                case SelectionStmtK:
+                    hoistExp(&t->child[0], FALSE);
+                    hoistStmts(&t->child[1]);
+                    hoistStmts(&t->child[2]);
+                    continue;
+                case IterationStmtK:
+                    hoistExp(&t->child[0], FALSE);
+                    hoistStmts(&t->child[1]);
+                    continue;
+                case ReturnStmtK:
+                    hoistExp(&t->child[0], FALSE);
+                    continue;
+                default:
+                    break;
+            }
+        }
+        hoistExp(loc, FALSE);
+    }
+}
+
+/* Function hoistLoop moves the invariants of the
+ * while statement at loc into assignments to temps
+ * put before it, and returns where the while
+ * statement is then linked from
+ */
+static TreeNode ** hoistLoop(TreeNode ** loc)
+{
+    TreeNode * loop = *loc;
+    nAssigned = nHoisted = 0;
+    storesElement = callsFunction = FALSE;
+    scanEffects(loop->child[0]);
+    scanEffects(loop->child[1]);
+    hoistExp(&loop->child[0], TRUE);
+    hoistStmts(&loop->child[1]);
+    for (int i = 0; i < nHoisted; i++){
+        TreeNode * s = newExpNode(AssignK);
+        s->lineno = loop->lineno;
+        s->type = Integer;
+        s->child[0] = newTempId(hoisted[i].temp, loop->lineno);
+        s->child[1] = hoisted[i].exp;
+        *loc = s;
+        loc = &s->sibling;
+    }
+    *loc = loop;
+    return loc;
+}
+
+/* Procedure licmStmts optimizes the loops of a
+ * list of statements, inner loops first
+ */
+static void licmStmts(TreeNode ** loc)
+{
+    for (; *loc != NULL; loc = &(*loc)->sibling){
+        TreeNode * t = *loc;
+        if (t->nodekind != StmtK)
+            continue;
+        switch (t->kind.stmt){
+            case CompoundStmtK:
+                licmStmts(&t->child[1]);
+                break;
+            case SelectionStmtK:
+                licmStmts(&t->child[1]);
+                licmStmts(&t->child[2]);
+                break;
+            case IterationStmtK:
+                licmStmts(&t->child[1]);
+                loc = hoistLoop(loc);
+                break;
+            default:
+                break;
+        }
+    }
+}
+
+/* Procedure hoistInvariants moves the operations
+ * of each while loop of an analyzed program whose
+ * operands the loop does not change into temps
+ * set before the loop, innermost loops first
+ */
+void hoistInvariants(TreeNode * syntaxTree)
+{
+    for (TreeNode * t = syntaxTree; t != NULL; t = t->sibling)
+        if (t->kind.exp == FuncDeclK){
+            func = t;
+            licmStmts(&t->child[1]->child[1]);
+        }
+    free(assigned);
+    free(hoisted);
+    assigned = NULL;
+    hoisted = NULL;
+    maxAssigned = maxHoisted = 0;
+}
@@ -0,0 +1,19 @@
+/****************************************************/
+/* File: licm.h                                     */
+/* Loop-invariant code motion for the C-MINUS       */
+/* compiler                                         */
+/* Compiler Construction: Principles and Practice   */
+/* Kenneth C. Louden                                */
+/****************************************************/
+
+#ifndef _LICM_H_
+#define _LICM_H_
+
+/* Procedure hoistInvariants moves the operations
+ * of each while loop of an analyzed program whose
+ * operands the loop does not change into temps
+ * set before the loop, innermost loops first
+ */
+void hoistInvariants(TreeNode * syntaxTree);
+
+#endif
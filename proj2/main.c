@@ -6,17 +6,19 @@
 /****************************************************/
 
 #include "globals.h"
+#include <sys/stat.h>
+#include <unistd.h>
 
 /* set NO_PARSE to TRUE to get a scanner-only compiler */
 // CHANGED TO 'TRUE'
 #define NO_PARSE FALSE
 /* set NO_ANALYZE to TRUE to get a parser-only compiler */
-#define NO_ANALYZE TRUE
+#define NO_ANALYZE FALSE
 
 /* set NO_CODE to TRUE to get a compiler that does not
 * generate code
 */
-#define NO_CODE TRUE
+#define NO_CODE FALSE
 
 #include "util.h"
 #if NO_PARSE
@@ -24,9 +26,13 @@
 #else
 #include "parse.h"
 #if !NO_ANALYZE
+#include "scan.h"
 #include "analyze.h"
+#include "symfile.h"
 #if !NO_CODE
 #include "cgen.h"
+#include "passes.h"
+#include "profile.h"
 #endif
 #endif
 #endif
@@ -45,18 +51,104 @@ int TraceParse = TRUE;
 int TraceAnalyze = FALSE;
 int TraceCode = FALSE;
 
+int Library = FALSE;
+int UnrollFactor = 4;
+int OptLevel = 2;
+int Memoize = FALSE;
 int Error = FALSE;
 
+#if !NO_ANALYZE
+/* Procedure watchSource recompiles pgm each time
+ * the file changes, analyzing again only the
+ * functions affected by the edit; the analyzer
+ * keeps the tree it last analyzed
+ */
+static void watchSource(char * pgm)
+{
+	struct stat st;
+	time_t mtime = 0;
+	off_t size = 0;
+	if (stat(pgm, &st) == 0) {
+		mtime = st.st_mtime;
+		size = st.st_size;
+	}
+	while (TRUE) {
+		sleep(1);
+		if (stat(pgm, &st) != 0 || (st.st_mtime == mtime && st.st_size == size))
+			continue;
+		mtime = st.st_mtime;
+		size = st.st_size;
+		source = fopen(pgm, "r");
+		if (source == NULL)
+			continue;
+		resetScanner();
+		fprintf(listing, "\nTINY RECOMPILATION: %s\n", pgm);
+		Error = FALSE;
+		TreeNode * newTree = reparse();
+		fclose(source);
+		/* a failed parse leaves the last analysis as it was */
+		if (!Error) {
+			if (TraceParse) {
+				fprintf(listing, "\nSyntax tree:\n");
+				printTree(newTree);
+			}
+			reanalyze(newTree);
+		}
+		fflush(listing);
+		fprintf(stderr, "%s: recompiled%s\n", pgm, Error ? " with errors" : "");
+	}
+}
+#endif
+
 int main(int argc, char * argv[])
 {
 	TreeNode * syntaxTree;
 	char pgm[120]; 
-	if (argc != 2)
+	int watch = FALSE;
+	int arg = 1;
+	while (arg < argc - 1 && argv[arg][0] == '-')
 	{
-		fprintf(stderr, "usage: %s <filename>\n", argv[0]);
+		if (strcmp(argv[arg], "-w") == 0)
+			watch = TRUE;
+		else if (strcmp(argv[arg], "-s") == 0)
+			Library = TRUE;
+		else if (strcmp(argv[arg], "-m") == 0)
+			Memoize = TRUE;
+		else if (strcmp(argv[arg], "-u") == 0 && arg + 2 < argc)
+			UnrollFactor = atoi(argv[++arg]);
+		else if (strncmp(argv[arg], "-O", 2) == 0 && argv[arg][2] >= '0' &&
+			argv[arg][2] <= '2' && argv[arg][3] == '\0')
+			OptLevel = argv[arg][2] - '0';
+#if !NO_ANALYZE
+		else if (strcmp(argv[arg], "-i") == 0 && arg + 2 < argc)
+		{
+			if (!sf_open(argv[++arg]))
+			{
+				fprintf(stderr, "Cannot import symbol file %s\n", argv[arg]);
+				exit(1);
+			}
+		}
+#endif
+#if !NO_CODE
+		else if (strcmp(argv[arg], "-p") == 0 && arg + 2 < argc)
+		{
+			if (!readProfile(argv[++arg]))
+			{
+				fprintf(stderr, "Cannot read profile %s\n", argv[arg]);
+				exit(1);
+			}
+		}
+#endif
+		else
+			break;
+		arg++;
+	}
+	if (arg != argc - 1)
+	{
+		fprintf(stderr, "usage: %s [-w] [-s] [-m] [-O0|-O1|-O2] [-u factor] [-i symfile]... [-p profile] <filename>\n", argv[0]);
 		exit(1);
 	}
-	strcpy(pgm, argv[1]);
+	strcpy(pgm, argv[arg]);
 	if (strchr(pgm, '.') == NULL)
 		strcat(pgm, ".tny");
 	source = fopen(pgm, "r");
@@ -84,6 +176,48 @@ int main(int argc, char * argv[])
 		fprintf(listing, "\nSyntax tree:\n");
 		printTree(syntaxTree);
 	}
+#if !NO_ANALYZE
+	if (!Error) {
+		if (TraceAnalyze) fprintf(listing, "\nBuilding Symbol Table...\n");
+		buildSymtab(syntaxTree);
+		if (TraceAnalyze) fprintf(listing, "\nChecking Types...\n");
+		typeCheck(syntaxTree);
+		if (TraceAnalyze) fprintf(listing, "\nType Checking Finished\n");
+	}
+#if !NO_CODE
+	if (!Error && !watch) {
+		char * codefile;
+		int fnlen = strcspn(pgm, ".");
+		codefile = (char *)calloc(fnlen + 5, sizeof(char));
+		strncpy(codefile, pgm, fnlen);
+		strcat(codefile, ".tm");
+		code = fopen(codefile, "w");
+		if (code == NULL) {
+			printf("Unable to open %s\n", codefile);
+			exit(1);
+		}
+		syntaxTree = runPasses(syntaxTree);
+		codeGen(syntaxTree, codefile);
+		freeSsa(syntaxTree);
+		fclose(code);
+		/* the TM cannot load a program too large for it */
+		if (Error)
+			remove(codefile);
+		/* a library exports its interface */
+		if (Library && !Error)
+		{
+			strcpy(codefile + fnlen, ".sym");
+			if (!sf_write(codefile, syntaxTree))
+				fprintf(stderr, "Unable to write %s\n", codefile);
+		}
+	}
+#endif
+	if (watch) {
+		fclose(source);
+		fflush(listing);
+		watchSource(pgm);
+	}
+#endif
 #endif
 	fclose(source);
 	return 0;
@@ -0,0 +1,391 @@
+/****************************************************/
+/* File: memo.c                                     */
+/* Memoization of pure recursive functions for the  */
+/* C-MINUS compiler                                 */
+/* A pure function returns the same value whenever  */
+/* it is called with the same arguments, so a       */
+/* recursive one that calls itself again and again  */
+/* on the same arguments can look them up instead.  */
+/* Its table is a global array of entries, each a   */
+/* flag set once the entry is filled, the arguments */
+/* and the value; the arguments hash to the entry   */
+/* they may be kept in, the last call hashing there */
+/* replacing what it held. The body starts with the */
+/* lookup, and each return first fills the entry    */
+/* Compiler Construction: Principles and Practice   */
+/* Kenneth C. Louden                                */
+/****************************************************/
+
+#include "globals.h"
+#include "util.h"
+#include "symfile.h"
+#include "memo.h"
+
+/* a table has MEMO_ENTRIES entries, fewer if its
+ * function takes many arguments, but not fewer
+ * than MIN_ENTRIES. The tables of a program take
+ * at most MEMO_BUDGET words, a quarter of the TM
+ * data memory, which the stack also needs
+ */
+#define MEMO_ENTRIES 64
+#define MIN_ENTRIES 8
+#define MEMO_BUDGET 256
+
+/* the functions of the program, whether each is
+ * pure, and whether the search for recursion has
+ * seen it
+ */
+static TreeNode ** funcs = NULL;
+static int * pure = NULL;
+static int * seen = NULL;
+static int nFuncs = 0;
+
+static int indexOf(TreeNode * f)
+{
+    for (int i = 0; i < nFuncs; i++)
+        if (funcs[i] == f)
+            return i;
+    return -1;
+}
+
+/* Function countParams returns how many integer
+ * parameters function f has, -1 if one is an
+ * array
+ */
+static int countParams(TreeNode * f)
+{
+    int n = 0;
+    for (TreeNode * p = f->child[0]; p != NULL; p = p->sibling){
+        if (p->kind.exp == ArrayDeclK)
+            return -1;
+        n++;
+    }
+    return n;
+}
+
+/* Function impure tells whether tree reads or
+ * writes a global, or calls a function not taken
+ * to be pure, input and output among them
+ */
+static int impure(TreeNode * tree)
+{
+    for (; tree != NULL; tree = tree->sibling){
+        if (tree->nodekind == ExpK && tree->kind.exp == IdK && tree->bind.storage == GlobalK)
+            return TRUE;
+        if (isStmt(tree, CallK)){
+            int i = indexOf(tree->decl);
+            if (i < 0 || !pure[i])
+                return TRUE;
+        }
+        for (int i = 0; i < MAXCHILDREN; i++)
+            if (impure(tree->child[i]))
+                return TRUE;
+    }
+    return FALSE;
+}
+
+/* Function reaches tells whether tree calls
+ * function f, directly or not, through functions
+ * not seen yet
+ */
+static int reaches(TreeNode * tree, TreeNode * f)
+{
+    for (; tree != NULL; tree = tree->sibling){
+        if (isStmt(tree, CallK)){
+            int i = indexOf(tree->decl);
+            if (tree->decl == f)
+                return TRUE;
+            if (i >= 0 && !seen[i]){
+                seen[i] = TRUE;
+                if (reaches(funcs[i]->child[1], f))
+                    return TRUE;
+            }
+        }
+        for (int i = 0; i < MAXCHILDREN; i++)
+            if (reaches(tree->child[i], f))
+                return TRUE;
+    }
+    return FALSE;
+}
+
+/* Function recursions counts the calls in tree
+ * that lead back to function f
+ */
+static int recursions(TreeNode * tree, TreeNode * f)
+{
+    int n = 0;
+    for (; tree != NULL; tree = tree->sibling){
+        if (isStmt(tree, CallK)){
+            int i = indexOf(tree->decl);
+            for (int j = 0; j < nFuncs; j++)
+                seen[j] = FALSE;
+            if (tree->decl == f || (i >= 0 && reaches(funcs[i]->child[1], f)))
+                n++;
+        }
+        for (int i = 0; i < MAXCHILDREN; i++)
+            n += recursions(tree->child[i], f);
+    }
+    return n;
+}
+
+/* Function localName returns the name f.what of
+ * a local the memo table adds to function f
+ */
+static char * localName(TreeNode * f, char * what)
+{
+    char * name = malloc(strlen(f->attr.name) + strlen(what) + 2);
+    if (name == NULL){
+        fprintf(listing, "Out of memory error at line %d\n", lineno);
+        exit(-1);
+    }
+    sprintf(name, "%s.%s", f->attr.name, what);
+    return name;
+}
+
+/* Function newLocal declares a scalar local of
+ * function f and returns its declaration
+ */
+static TreeNode * newLocal(TreeNode * f, char * what)
+{
+    TreeNode * v = newExpNode(VarDeclK);
+    TreeNode ** last = &f->child[1]->child[0];
+    v->attr.name = localName(f, what);
+    v->lineno = f->lineno;
+    v->type = Integer;
+    v->bind.storage = LocalK;
+    v->bind.offset = -f->size++;
+    while (*last != NULL)
+        last = &(*last)->sibling;
+    *last = v;
+    return v;
+}
+
+/* Function newOp creates the expression l op r,
+ * of kind SimpleStmtK, AdditiveStmtK or TermK
+ */
+static TreeNode * newOp(StmtKind kind, TreeNode * l, TokenType op, TreeNode * r)
+{
+    TreeNode * t = newStmtNode(kind);
+    t->lineno = l->lineno;
+    t->type = Integer;
+    t->child[0] = l;
+    t->child[1] = newExpNode(OpK);
+    t->child[1]->attr.op = op;
+    t->child[1]->lineno = l->lineno;
+    t->child[2] = r;
+    return t;
+}
+
+/* Function newElement creates the identifier of
+ * word k of the entry of table at index entry
+ */
+static TreeNode * newElement(TreeNode * table, TreeNode * entry, int k, int line)
+{
+    TreeNode * t = newTempId(table, line);
+    TreeNode * i = newTempId(entry, line);
+    t->child[0] = (k == 0) ? i : newOp(AdditiveStmtK, i, PLUS, newConst(k, line));
+    return t;
+}
+
+static TreeNode * newIf(TreeNode * test, TreeNode * then)
+{
+    TreeNode * t = newStmtNode(SelectionStmtK);
+    t->lineno = test->lineno;
+    t->child[0] = test;
+    t->child[1] = then;
+    return t;
+}
+
+/* Procedure fillEntries makes each return of a
+ * value in the list at loc first store the value
+ * and keys in the entry of table at index entry
+ */
+static void fillEntries(TreeNode ** loc, TreeNode * table, TreeNode * entry,
+                        TreeNode ** keys, int n, TreeNode * result)
+{
+    for (; *loc != NULL; loc = &(*loc)->sibling){
+        TreeNode * t = *loc, * block, ** last;
+        int line = t->lineno;
+        if (t->nodekind != StmtK)
+            continue;
+        if (!isStmt(t, ReturnStmtK)){
+            for (int i = 1; i < MAXCHILDREN; i++)
+                fillEntries(&t->child[i], table, entry, keys, n, result);
+            continue;
+        }
+        if (t->child[0] == NULL)
+            continue;
+        block = newStmtNode(CompoundStmtK);
+        block->lineno = line;
+        last = &block->child[1];
+        *last = newAssign(newTempId(result, line), t->child[0]);
+        last = &(*last)->sibling;
+        *last = newAssign(newElement(table, entry, 0, line), newConst(1, line));
+        last = &(*last)->sibling;
+        for (int i = 0; i < n; i++){
+            *last = newAssign(newElement(table, entry, i + 1, line), newTempId(keys[i], line));
+            last = &(*last)->sibling;
+        }
+        *last = newAssign(newElement(table, entry, n + 1, line), newTempId(result, line));
+        last = &(*last)->sibling;
+        t->child[0] = newTempId(result, line);
+        *last = t;
+        block->sibling = t->sibling;
+        t->sibling = NULL;
+        *loc = block;
+    }
+}
+
+/* Function memoize gives function f with n
+ * parameters a table of entries entries at global
+ * address base and returns its declaration
+ */
+static TreeNode * memoize(TreeNode * f, int n, int entries, int base)
+{
+    TreeNode * table = newExpNode(ArrayDeclK);
+    TreeNode * body = f->child[1];
+    TreeNode * entry, * result, * hash, * lookup, * head = NULL, ** last = &head;
+    TreeNode ** keys = (TreeNode **)malloc(n * sizeof(TreeNode *));
+    int width = n + 2, line = body->lineno, k = 0, scale = 1;
+    if (keys == NULL){
+        fprintf(listing, "Out of memory error at line %d\n", lineno);
+        exit(-1);
+    }
+    table->attr.name = localName(f, "memo");
+    table->lineno = f->lineno;
+    table->type = Integer;
+    table->size = entries * width;
+    table->bind.storage = GlobalK;
+    table->bind.offset = base;
+    table->bind.isArray = TRUE;
+    entry = newLocal(f, "entry");
+    result = newLocal(f, "result");
+    /* a parameter the body assigns is kept as it
+     * came, for the entry it is filled in
+     */
+    for (TreeNode * p = f->child[0]; p != NULL; p = p->sibling, k++){
+        keys[k] = p;
+        if (assigns(body->child[1], p)){
+            keys[k] = newLocal(f, p->attr.name);
+            *last = newAssign(newTempId(keys[k], line), newTempId(p, line));
+            last = &(*last)->sibling;
+        }
+    }
+    /* entry = (k0 + 7*k1 + 49*k2 ...) mod entries,
+     * times the width of an entry
+     */
+    hash = newTempId(keys[0], line);
+    for (int i = 1; i < n; i++){
+        scale = (scale < 1000000) ? scale * 7 : 1;
+        hash = newOp(AdditiveStmtK, hash, PLUS,
+                     newOp(TermK, newTempId(keys[i], line), TIMES, newConst(scale, line)));
+    }
+    *last = newAssign(newTempId(entry, line), hash);
+    last = &(*last)->sibling;
+    *last = newAssign(newTempId(entry, line),
+                      newOp(AdditiveStmtK, newTempId(entry, line), MINUS,
+                            newOp(TermK, newOp(TermK, newTempId(entry, line), OVER,
+                                               newConst(entries, line)),
+                                  TIMES, newConst(entries, line))));
+    last = &(*last)->sibling;
+    *last = newIf(newOp(SimpleStmtK, newTempId(entry, line), LT, newConst(0, line)),
+                  newAssign(newTempId(entry, line),
+                            newOp(AdditiveStmtK, newTempId(entry, line), PLUS,
+                                  newConst(entries, line))));
+    last = &(*last)->sibling;
+    *last = newAssign(newTempId(entry, line),
+                      newOp(TermK, newTempId(entry, line), TIMES, newConst(width, line)));
+    last = &(*last)->sibling;
+    /* if the entry is filled and holds the
+     * arguments, return its value
+     */
+    lookup = newStmtNode(ReturnStmtK);
+    lookup->lineno = line;
+    lookup->child[0] = newElement(table, entry, n + 1, line);
+    for (int i = n - 1; i >= 0; i--)
+        lookup = newIf(newOp(SimpleStmtK, newElement(table, entry, i + 1, line), EQ,
+                             newTempId(keys[i], line)), lookup);
+    *last = newIf(newOp(SimpleStmtK, newElement(table, entry, 0, line), NE, newConst(0, line)),
+                  lookup);
+    last = &(*last)->sibling;
+    fillEntries(&body->child[1], table, entry, keys, n, result);
+    *last = body->child[1];
+    body->child[1] = head;
+    free(keys);
+    return table;
+}
+
+/* Function memoizeFunctions, when Memoize is set,
+ * gives each pure recursive function of an
+ * analyzed program a table in global data of the
+ * values it returned for the arguments it was
+ * called with, looked up before its body runs,
+ * and returns the program with the tables
+ * declared. A function is pure if it takes and
+ * returns integers, touches no global, does no
+ * input or output and calls only pure functions
+ */
+TreeNode * memoizeFunctions(TreeNode * syntaxTree)
+{
+    int end = sf_dataEnd(), budget = MEMO_BUDGET, changed;
+    if (!Memoize)
+        return syntaxTree;
+    nFuncs = 0;
+    for (TreeNode * t = syntaxTree; t != NULL; t = t->sibling)
+        if (t->kind.exp == FuncDeclK)
+            nFuncs++;
+        else {
+            int width = (t->kind.exp == ArrayDeclK) ? t->size : 1;
+            if (end < t->bind.offset + width)
+                end = t->bind.offset + width;
+        }
+    funcs = (TreeNode **)malloc((nFuncs + 1) * sizeof(TreeNode *));
+    pure = (int *)calloc(nFuncs + 1, sizeof(int));
+    seen = (int *)calloc(nFuncs + 1, sizeof(int));
+    if (funcs == NULL || pure == NULL || seen == NULL){
+        fprintf(listing, "Out of memory error at line %d\n", lineno);
+        exit(-1);
+    }
+    nFuncs = 0;
+    for (TreeNode * t = syntaxTree; t != NULL; t = t->sibling)
+        if (t->kind.exp == FuncDeclK){
+            funcs[nFuncs] = t;
+            pure[nFuncs++] = t->type == Integer && t->child[1] != NULL && countParams(t) > 0;
+        }
+    /* a function stays pure while what it calls is */
+    do {
+        changed = FALSE;
+        for (int i = 0; i < nFuncs; i++)
+            if (pure[i] && impure(funcs[i]->child[1])){
+                pure[i] = FALSE;
+                changed = TRUE;
+            }
+    } while (changed);
+    for (int i = 0; i < nFuncs; i++){
+        TreeNode * f = funcs[i], * table;
+        int n = countParams(f), entries = MEMO_ENTRIES;
+        if (!pure[i])
+            continue;
+        /* a function recurring once per call gains
+         * nothing: it never meets the same
+         * arguments twice in one call tree
+         */
+        if (recursions(f->child[1], f) < 2)
+            continue;
+        while (entries >= MIN_ENTRIES && entries * (n + 2) > budget)
+            entries /= 2;
+        if (entries < MIN_ENTRIES)
+            continue;
+        table = memoize(f, n, entries, end);
+        fprintf(listing, "Memoized function %s at line %d in %d entries\n",
+                f->attr.name, f->lineno, entries);
+        end += table->size;
+        budget -= table->size;
+        table->sibling = syntaxTree;
+        syntaxTree = table;
+    }
+    free(funcs);
+    free(pure);
+    free(seen);
+    return syntaxTree;
+}
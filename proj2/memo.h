@@ -0,0 +1,24 @@
+/****************************************************/
+/* File: memo.h                                     */
+/* Memoization of pure recursive functions for the  */
+/* C-MINUS compiler                                 */
+/* Compiler Construction: Principles and Practice   */
+/* Kenneth C. Louden                                */
+/****************************************************/
+
+#ifndef _MEMO_H_
+#define _MEMO_H_
+
+/* Function memoizeFunctions, when Memoize is set,
+ * gives each pure recursive function of an
+ * analyzed program a table in global data of the
+ * values it returned for the arguments it was
+ * called with, looked up before its body runs,
+ * and returns the program with the tables
+ * declared. A function is pure if it takes and
+ * returns integers, touches no global, does no
+ * input or output and calls only pure functions
+ */
+TreeNode * memoizeFunctions(TreeNode * syntaxTree);
+
+#endif
@@ -9,9 +9,22 @@
 #include "util.h"
 #include "scan.h"
 #include "parse.h"
+#include <setjmp.h>
 
 static TokenType token; /* holds current token */
 
+/* where a syntax error returns to while reparse
+ * runs, instead of exiting
+ */
+static jmp_buf recovery;
+static int recovering = FALSE;
+
+/* the line of the last branch or call parsed and
+ * how many its line has so far
+ */
+static int siteLine = 0;
+static int siteCount = 0;
+
 /* function prototypes for recursive calls */
 static TreeNode* declaration_list(void);
 static TreeNode* declaration(void);
@@ -31,6 +44,19 @@ static TreeNode* return_stmt(void);
 static TreeNode* expression(void);
 static TreeNode* simple_expression(TreeNode*);
 static TreeNode* op(TokenType);
+
+/* Function nextSite numbers the branches and calls
+ * of a line in the order they are parsed, so that
+ * a profile tells those sharing a line apart
+ */
+static int nextSite(int line)
+{
+    if (line != siteLine){
+        siteLine = line;
+        siteCount = 0;
+    }
+    return siteCount++;
+}
 static TreeNode* additive_expression(TreeNode*);
 static TreeNode* term(TreeNode*);
 static TreeNode* factor(TreeNode*);
@@ -46,6 +72,8 @@ static void syntaxError()
     fprintf(listing,"\nCurrent token: ");
     printToken(token,tokenString);
     fprintf(listing, "\nSyntax tree:\n");
+    if (recovering)
+        longjmp(recovery, 1);
     exit(-1);
 }
 
@@ -78,7 +106,7 @@ TreeNode * declaration_list(void)
 
 TreeNode* declaration(void)
 {
-    TreeNode* ret;
+    TreeNode* ret = NULL;
     ExpType type = type_specifier();
     char* name = copyString(tokenString);
     match(ID);
@@ -90,10 +118,17 @@ TreeNode* declaration(void)
             ret->type = type;
             ret->child[0] = params();
             match(RPAREN);
-            if(ret->child[0] == NULL)
-                ret->child[0] = compound_stmt();
-            else
-                ret->child[1] = compound_stmt();
+            ret->child[1] = compound_stmt();
+            break;
+        case LBRACE:
+            match(LBRACE);
+            ret = newExpNode(ArrayDeclK);
+            ret->attr.name = name;
+            ret->type = type;
+            ret->size = atoi(tokenString);
+            match(NUM);
+            match(RBRACE);
+            match(SEMI);
             break;
         case SEMI:
             match(SEMI);
@@ -112,7 +147,7 @@ TreeNode* declaration(void)
 
 TreeNode* var_declaration(void)
 {
-    TreeNode* ret;
+    TreeNode* ret = NULL;
     ExpType type = type_specifier();
     char* name = copyString(tokenString);
     match(ID);
@@ -154,6 +189,7 @@ ExpType type_specifier(void)
         default: 
             syntaxError();
     }
+    return Void;
 }
 
 TreeNode * params(void)
@@ -288,7 +324,7 @@ TreeNode * stmt(void)
 
 TreeNode * expression_stmt(void)
 {
-    TreeNode* ret;
+    TreeNode* ret = NULL;
     if (token == SEMI)
         match(SEMI);
     else if (token != RCURLY){
@@ -301,6 +337,7 @@ TreeNode * expression_stmt(void)
 TreeNode * selection_stmt(void)
 {
     TreeNode* ret = newStmtNode(SelectionStmtK);
+    ret->site = nextSite(ret->lineno);
     match(IF);
     match(LPAREN);
     ret->child[0] = expression();
@@ -317,6 +354,7 @@ TreeNode * selection_stmt(void)
 TreeNode * iteration_stmt(void)
 {
     TreeNode *ret = newStmtNode(IterationStmtK);
+    ret->site = nextSite(ret->lineno);
     match(WHILE);
     match(LPAREN);
     ret->child[0] = expression();
@@ -447,6 +485,7 @@ TreeNode * call(void)
     if (token == LPAREN){
         match(LPAREN);
         ret = newStmtNode(CallK);
+        ret->site = nextSite(ret->lineno);
         ret->attr.name = name;
         ret->child[0] = args();
         match(RPAREN);
@@ -495,9 +534,27 @@ TreeNode * args_list(void)
 
 TreeNode * parse(void)
 { 
+    siteLine = siteCount = 0;
     token = getToken();
     TreeNode* ret = declaration_list();
     if (token!=ENDFILE)
         syntaxError();
     return ret;
 }
+
+/* Function reparse parses as parse does, but
+ * returns NULL with Error set on a syntax error;
+ * the nodes built until then are not released
+ */
+TreeNode * reparse(void)
+{
+    TreeNode * t;
+    if (setjmp(recovery) != 0){
+        recovering = FALSE;
+        return NULL;
+    }
+    recovering = TRUE;
+    t = parse();
+    recovering = FALSE;
+    return t;
+}
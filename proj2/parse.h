@@ -13,4 +13,10 @@
  */
 TreeNode * parse(void);
 
+/* Function reparse parses as parse does, but
+ * returns NULL with Error set on a syntax error
+ * instead of exiting
+ */
+TreeNode * reparse(void);
+
 #endif
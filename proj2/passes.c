@@ -0,0 +1,176 @@
+/****************************************************/
+/* File: passes.c                                   */
+/* The pass manager of the C-MINUS compiler         */
+/* Passes are listed in the order they run, each    */
+/* with the lowest -O level whose pipeline holds    */
+/* it: -O0 runs none, -O1 those over the syntax     */
+/* tree, -O2 also lowers each function into SSA     */
+/* form, optimizes it there and generates its code  */
+/* from it. A pass over the SSA form runs on each   */
+/* function in turn; a function it leaves invalid   */
+/* is compiled from its syntax tree instead         */
+/* Compiler Construction: Principles and Practice   */
+/* Kenneth C. Louden                                */
+/****************************************************/
+
+#include "globals.h"
+#include <time.h>
+#include "cgen.h"
+#include "prune.h"
+#include "peval.h"
+#include "memo.h"
+#include "inline.h"
+#include "ipcp.h"
+#include "fold.h"
+#include "vector.h"
+#include "unroll.h"
+#include "dce.h"
+#include "licm.h"
+#include "ivsr.h"
+#include "cse.h"
+#include "ir.h"
+#include "irpass.h"
+#include "sccp.h"
+#include "passes.h"
+
+/* PassKind tells what a pass works on: the list
+ * of declarations, which it may change, the
+ * syntax tree or the SSA form of a function
+ */
+typedef enum { ProgramPass, TreePass, SsaPass } PassKind;
+
+typedef struct
+{
+    char * name;
+    int level;
+    PassKind kind;
+    TreeNode * (* program)(TreeNode *);
+    void (* tree)(TreeNode *);
+    void (* ssa)(IrFunc *);
+} PassRec;
+
+static TreeNode * buildSsa(TreeNode * syntaxTree);
+
+static PassRec passes[] =
+{
+    /* what main cannot reach takes no budget */
+    { "Dead function elimination", 1, ProgramPass, removeUnreachable, NULL, NULL },
+    /* what runs before any input is run once, here */
+    { "Partial evaluation", 1, ProgramPass, evaluateProgram, NULL, NULL },
+    { "Memoization", 1, ProgramPass, memoizeFunctions, NULL, NULL },
+    { "Inlining", 1, TreePass, NULL, inlineCalls, NULL },
+    { "Interprocedural constant propagation", 1, TreePass, NULL, propagateArguments, NULL },
+    /* callees inlined or specialized everywhere */
+    { "Dead function elimination", 1, ProgramPass, removeUnreachable, NULL, NULL },
+    { "Constant folding", 1, TreePass, NULL, foldConstants, NULL },
+    { "Loop vectorization", 1, TreePass, NULL, vectorizeLoops, NULL },
+    { "Loop unrolling", 1, TreePass, NULL, unrollLoops, NULL },
+    { "Dead code elimination", 1, TreePass, NULL, eliminateDeadCode, NULL },
+    { "Loop-invariant code motion", 1, TreePass, NULL, hoistInvariants, NULL },
+    { "Induction variable strength reduction", 1, TreePass, NULL, reduceInductionVars, NULL },
+    { "Common subexpression elimination", 1, TreePass, NULL, eliminateCommonSubexps, NULL },
+    { "SSA construction", 2, ProgramPass, buildSsa, NULL, NULL },
+    { "Redundant load elimination", 2, SsaPass, NULL, NULL, forwardLoads },
+    { "Sparse conditional constant propagation", 2, SsaPass, NULL, NULL, propagateConstants },
+    { "Copy propagation", 2, SsaPass, NULL, NULL, propagateCopies },
+    { "SSA dead code elimination", 2, SsaPass, NULL, NULL, removeDeadValues }
+};
+
+#define NPASSES ((int)(sizeof(passes) / sizeof(passes[0])))
+
+/* Procedure dropSsa makes function f compiled
+ * from its syntax tree, its SSA form left invalid
+ * by pass name
+ */
+static void dropSsa(TreeNode * f, char * name)
+{
+    fprintf(listing, "%s left invalid SSA form of %s, compiled from its syntax tree\n",
+            name, f->attr.name);
+    irFree(f->ir);
+    f->ir = NULL;
+}
+
+/* Function buildSsa lowers each function of a
+ * program into SSA form
+ */
+static TreeNode * buildSsa(TreeNode * syntaxTree)
+{
+    for (TreeNode * t = syntaxTree; t != NULL; t = t->sibling)
+        if (t->kind.exp == FuncDeclK && t->child[1] != NULL){
+            irFree(t->ir);
+            t->ir = irBuild(t);
+            if (!irVerify(t->ir))
+                dropSsa(t, "SSA construction");
+        }
+    return syntaxTree;
+}
+
+/* Function measure reports the TM instructions
+ * pass name removed from (or added to) the size of
+ * the code before it and the time it took, and
+ * returns the size after it
+ */
+static int measure(TreeNode * syntaxTree, char * name, int size, clock_t time)
+{
+    int after = codeSize(syntaxTree);
+    double ms = 1000.0 * time / CLOCKS_PER_SEC;
+    if (after <= size)
+        fprintf(listing, "%s removed %d of %d TM instructions in %.2f ms\n",
+                name, size - after, size, ms);
+    else
+        fprintf(listing, "%s added %d to %d TM instructions in %.2f ms\n",
+                name, after - size, size, ms);
+    return after;
+}
+
+/* Function runPasses runs the optimization passes
+ * of the pipeline OptLevel selects over an
+ * analyzed program, reports the TM instructions
+ * each removed and the time it took in the
+ * listing, and returns the program left
+ */
+TreeNode * runPasses(TreeNode * syntaxTree)
+{
+    int size = codeSize(syntaxTree);
+    for (int i = 0; i < NPASSES; i++){
+        PassRec * p = &passes[i];
+        clock_t begin;
+        if (p->level > OptLevel)
+            continue;
+        begin = clock();
+        switch (p->kind){
+            case ProgramPass:
+                syntaxTree = p->program(syntaxTree);
+                break;
+            case TreePass:
+                p->tree(syntaxTree);
+                break;
+            case SsaPass:
+                for (TreeNode * t = syntaxTree; t != NULL; t = t->sibling)
+                    if (t->kind.exp == FuncDeclK && t->ir != NULL){
+                        p->ssa(t->ir);
+                        if (!irVerify(t->ir))
+                            dropSsa(t, p->name);
+                    }
+                break;
+        }
+        size = measure(syntaxTree, p->name, size, clock() - begin);
+    }
+    if (TraceCode)
+        for (TreeNode * t = syntaxTree; t != NULL; t = t->sibling)
+            if (t->kind.exp == FuncDeclK && t->ir != NULL)
+                irPrint(t->ir);
+    return syntaxTree;
+}
+
+/* Procedure freeSsa releases the SSA form of the
+ * functions of a program
+ */
+void freeSsa(TreeNode * syntaxTree)
+{
+    for (TreeNode * t = syntaxTree; t != NULL; t = t->sibling)
+        if (t->kind.exp == FuncDeclK){
+            irFree(t->ir);
+            t->ir = NULL;
+        }
+}
@@ -0,0 +1,24 @@
+/****************************************************/
+/* File: passes.h                                   */
+/* The pass manager of the C-MINUS compiler         */
+/* Compiler Construction: Principles and Practice   */
+/* Kenneth C. Louden                                */
+/****************************************************/
+
+#ifndef _PASSES_H_
+#define _PASSES_H_
+
+/* Function runPasses runs the optimization passes
+ * of the pipeline OptLevel selects over an
+ * analyzed program, reports the TM instructions
+ * each removed and the time it took in the
+ * listing, and returns the program left
+ */
+TreeNode * runPasses(TreeNode * syntaxTree);
+
+/* Procedure freeSsa releases the SSA form of the
+ * functions of a program
+ */
+void freeSsa(TreeNode * syntaxTree);
+
+#endif
@@ -0,0 +1,763 @@
+/****************************************************/
+/* File: peval.c                                    */
+/* Partial evaluation for the C-MINUS compiler      */
+/* Code that reads no input computes the same words */
+/* on every run, so the compiler can run it once    */
+/* instead, interpreting the syntax tree as the TM  */
+/* would run its code. A word is known once it is   */
+/* set, a global from the start: reading one that   */
+/* is not, indexing out of bounds, dividing by zero */
+/* or running out of steps stops the interpretation */
+/* and leaves what it was running to the TM         */
+/* Compiler Construction: Principles and Practice   */
+/* Kenneth C. Louden                                */
+/****************************************************/
+
+#include "globals.h"
+#include "util.h"
+#include "symfile.h"
+#include "fold.h"
+#include "peval.h"
+
+/* the statements of main and the calls of pure
+ * functions may each take PEVAL_STEPS steps in
+ * all, a step being a statement or expression,
+ * with calls nested at most MAX_DEPTH deep. The
+ * arrays of main that start with words computed
+ * are moved into global data, which they may
+ * fill up to DATA_BUDGET words, half of the TM
+ * data memory; the stack needs the rest
+ */
+#define PEVAL_STEPS 1000000
+#define MAX_DEPTH 256
+#define DATA_BUDGET 512
+
+/* Block is the storage of a declaration: its
+ * words and whether each is set. An array
+ * parameter shares the words of its argument
+ */
+typedef struct
+{
+    TreeNode * decl;
+    int * val;
+    char * set;
+    int size;
+    int owned;
+} Block;
+
+/* Frame is the storage of an activation */
+typedef struct
+{
+    Block * blocks;
+    int nBlocks;
+    int maxBlocks;
+} Frame;
+
+static Frame globals = { NULL, 0, 0 };
+static Frame * frame = NULL;
+static long steps = 0;
+static int depth = 0;
+
+/* failed is set once the interpretation stops,
+ * returned while a function returns result
+ */
+static int failed = FALSE;
+static int returned = FALSE;
+static int result = 0;
+
+/* the functions of the program, whether each
+ * may do input or output and whether it is pure
+ */
+static TreeNode ** funcs = NULL;
+static int * io = NULL;
+static int * pure = NULL;
+static int nFuncs = 0;
+
+/* Function indexOf returns the index of function
+ * f, kept in its offset while the pass runs, or -1
+ * if f is not a function of the program
+ */
+static int indexOf(TreeNode * f)
+{
+    int i = f->bind.offset;
+    return (i >= 0 && i < nFuncs && funcs[i] == f) ? i : -1;
+}
+
+static int fail(void)
+{
+    failed = TRUE;
+    return 0;
+}
+
+/* Function step takes a step and tells whether
+ * the interpretation goes on
+ */
+static int step(void)
+{
+    if (--steps < 0)
+        fail();
+    return !failed;
+}
+
+/* Function addBlock adds an empty block for decl
+ * to frame f and returns it
+ */
+static Block * addBlock(Frame * f, TreeNode * decl)
+{
+    Block * b;
+    if (f->nBlocks == f->maxBlocks){
+        f->maxBlocks = (f->maxBlocks == 0) ? 8 : f->maxBlocks * 2;
+        f->blocks = (Block *)realloc(f->blocks, f->maxBlocks * sizeof(Block));
+        if (f->blocks == NULL){
+            fprintf(listing, "Out of memory error at line %d\n", lineno);
+            exit(-1);
+        }
+    }
+    b = &f->blocks[f->nBlocks++];
+    b->decl = decl;
+    b->val = NULL;
+    b->set = NULL;
+    b->size = 0;
+    b->owned = FALSE;
+    return b;
+}
+
+/* Function newBlock adds a block of size words,
+ * none set, for decl to frame f and returns it
+ */
+static Block * newBlock(Frame * f, TreeNode * decl, int size)
+{
+    Block * b = addBlock(f, decl);
+    b->val = (int *)calloc(size + 1, sizeof(int));
+    b->set = (char *)calloc(size + 1, sizeof(char));
+    if (b->val == NULL || b->set == NULL){
+        fprintf(listing, "Out of memory error at line %d\n", lineno);
+        exit(-1);
+    }
+    b->size = size;
+    b->owned = TRUE;
+    return b;
+}
+
+static Block * findBlock(Frame * f, TreeNode * decl)
+{
+    if (f == NULL)
+        return NULL;
+    for (int i = f->nBlocks - 1; i >= 0; i--)
+        if (f->blocks[i].decl == decl)
+            return &f->blocks[i];
+    return NULL;
+}
+
+static void freeFrame(Frame * f)
+{
+    for (int i = 0; i < f->nBlocks; i++)
+        if (f->blocks[i].owned){
+            free(f->blocks[i].val);
+            free(f->blocks[i].set);
+        }
+    free(f->blocks);
+    f->blocks = NULL;
+    f->nBlocks = 0;
+    f->maxBlocks = 0;
+}
+
+/* Procedure declare gives the declarations of a
+ * compound statement their blocks in the current
+ * frame, none of their words set
+ */
+static void declare(TreeNode * d)
+{
+    for (; d != NULL; d = d->sibling){
+        Block * b = findBlock(frame, d);
+        if (b != NULL)
+            memset(b->set, 0, b->size);
+        else
+            newBlock(frame, d, (d->kind.exp == ArrayDeclK) ? d->size : 1);
+    }
+}
+
+static int evalExp(TreeNode * t);
+static void exec(TreeNode * t);
+
+/* Function cellOf returns the word identifier id
+ * names and points set at whether it is set, or
+ * returns NULL if the interpretation stops
+ */
+static int * cellOf(TreeNode * id, char ** set)
+{
+    Block * b = findBlock((id->bind.storage == GlobalK) ? &globals : frame, id->decl);
+    int * val;
+    int size, k;
+    if (b == NULL){
+        fail();
+        return NULL;
+    }
+    *set = b->set;
+    if (id->child[0] == NULL)
+        return b->val;
+    val = b->val;
+    size = b->size;
+    k = evalExp(id->child[0]);
+    if (failed)
+        return NULL;
+    if (k < 0 || k >= size){
+        fail();
+        return NULL;
+    }
+    *set += k;
+    return val + k;
+}
+
+/* Function evalCall runs call t and returns its
+ * value. Arguments are computed in order, in the
+ * frame of the caller
+ */
+static int evalCall(TreeNode * t)
+{
+    TreeNode * f = t->decl, * p, * a;
+    Frame callee = { NULL, 0, 0 }, * caller = frame;
+    int value;
+    if (indexOf(f) < 0 || f->child[1] == NULL || depth >= MAX_DEPTH)
+        return fail();
+    for (p = f->child[0], a = t->child[0]; p != NULL && a != NULL && !failed;
+         p = p->sibling, a = a->sibling){
+        if (p->kind.exp == ArrayDeclK){
+            Block * arg = NULL, * b;
+            if (a->nodekind == ExpK && a->kind.exp == IdK && a->child[0] == NULL)
+                arg = findBlock((a->bind.storage == GlobalK) ? &globals : caller, a->decl);
+            if (arg == NULL){
+                fail();
+                break;
+            }
+            value = arg->size;
+            b = addBlock(&callee, p);
+            b->val = arg->val;
+            b->set = arg->set;
+            b->size = value;
+        }
+        else {
+            value = evalExp(a);
+            if (!failed){
+                Block * b = newBlock(&callee, p, 1);
+                b->val[0] = value;
+                b->set[0] = TRUE;
+            }
+        }
+    }
+    if (failed){
+        freeFrame(&callee);
+        return 0;
+    }
+    frame = &callee;
+    depth++;
+    exec(f->child[1]);
+    depth--;
+    frame = caller;
+    /* an integer function falling off its end
+     * returns no value known
+     */
+    if (!returned && f->type != Void)
+        fail();
+    returned = FALSE;
+    freeFrame(&callee);
+    return failed ? 0 : result;
+}
+
+/* Function evalExp computes expression t as the
+ * TM would
+ */
+static int evalExp(TreeNode * t)
+{
+    int * cell, a, b, ok;
+    char * set;
+    if (t == NULL || !step())
+        return fail();
+    if (t->nodekind == StmtK){
+        switch (t->kind.stmt){
+            case SimpleStmtK:
+            case AdditiveStmtK:
+            case TermK:
+                a = evalExp(t->child[0]);
+                if (failed)
+                    return 0;
+                b = evalExp(t->child[2]);
+                if (failed)
+                    return 0;
+                a = evaluateOp(t->child[1]->attr.op, a, b, &ok);
+                return ok ? a : fail();
+            case CallK:
+                return evalCall(t);
+            default:
+                return fail();
+        }
+    }
+    switch (t->kind.exp){
+        case ConstK:
+            return t->attr.val;
+        case IdK:
+            if (t->bind.isArray && t->child[0] == NULL)
+                return fail();
+            cell = cellOf(t, &set);
+            if (cell == NULL || !*set)
+                return fail();
+            return *cell;
+        case AssignK:
+            cell = cellOf(t->child[0], &set);
+            if (cell == NULL)
+                return 0;
+            a = evalExp(t->child[1]);
+            if (failed)
+                return 0;
+            *cell = a;
+            *set = TRUE;
+            return a;
+        default:
+            return fail();
+    }
+}
+
+/* Procedure execStmt runs statement t */
+static void execStmt(TreeNode * t)
+{
+    if (!step())
+        return;
+    if (t->nodekind != StmtK){
+        evalExp(t);
+        return;
+    }
+    switch (t->kind.stmt){
+        case CompoundStmtK:
+            declare(t->child[0]);
+            exec(t->child[1]);
+            break;
+        case SelectionStmtK:
+            if (evalExp(t->child[0]))
+                exec(t->child[1]);
+            else
+                exec(t->child[2]);
+            break;
+        case IterationStmtK:
+            while (evalExp(t->child[0]) && !failed){
+                exec(t->child[1]);
+                if (failed || returned)
+                    break;
+            }
+            break;
+        case ReturnStmtK:
+            if (t->child[0] != NULL)
+                result = evalExp(t->child[0]);
+            returned = TRUE;
+            break;
+        default:
+            evalExp(t);
+            break;
+    }
+}
+
+/* Procedure exec runs a statement list until it
+ * ends, returns or stops
+ */
+static void exec(TreeNode * t)
+{
+    for (; t != NULL && !failed && !returned; t = t->sibling)
+        execStmt(t);
+}
+
+/* Function doesIo tells whether tree may do
+ * input or output: it calls input, output or a
+ * function that may, or one the interpretation
+ * cannot run
+ */
+static int doesIo(TreeNode * tree)
+{
+    for (; tree != NULL; tree = tree->sibling){
+        if (isStmt(tree, CallK)){
+            int i = indexOf(tree->decl);
+            if (i < 0 || io[i])
+                return TRUE;
+        }
+        for (int i = 0; i < MAXCHILDREN; i++)
+            if (doesIo(tree->child[i]))
+                return TRUE;
+    }
+    return FALSE;
+}
+
+/* Function impure tells whether tree reads or
+ * writes a global, or calls a function not taken
+ * to be pure
+ */
+static int impure(TreeNode * tree)
+{
+    for (; tree != NULL; tree = tree->sibling){
+        if (tree->nodekind == ExpK && tree->kind.exp == IdK && tree->bind.storage == GlobalK)
+            return TRUE;
+        if (isStmt(tree, CallK)){
+            int i = indexOf(tree->decl);
+            if (i < 0 || !pure[i])
+                return TRUE;
+        }
+        for (int i = 0; i < MAXCHILDREN; i++)
+            if (impure(tree->child[i]))
+                return TRUE;
+    }
+    return FALSE;
+}
+
+static int hasReturn(TreeNode * tree)
+{
+    for (; tree != NULL; tree = tree->sibling){
+        if (isStmt(tree, ReturnStmtK))
+            return TRUE;
+        for (int i = 0; i < MAXCHILDREN; i++)
+            if (hasReturn(tree->child[i]))
+                return TRUE;
+    }
+    return FALSE;
+}
+
+static int calls(TreeNode * tree, TreeNode * f)
+{
+    for (; tree != NULL; tree = tree->sibling){
+        if (isStmt(tree, CallK) && tree->decl == f)
+            return TRUE;
+        for (int i = 0; i < MAXCHILDREN; i++)
+            if (calls(tree->child[i], f))
+                return TRUE;
+    }
+    return FALSE;
+}
+
+/* Procedure classify finds which functions may
+ * do input or output and which are pure: they
+ * take and return integers, touch no global and
+ * call only pure functions
+ */
+static void classify(TreeNode * syntaxTree)
+{
+    int changed;
+    nFuncs = 0;
+    for (TreeNode * t = syntaxTree; t != NULL; t = t->sibling)
+        if (t->kind.exp == FuncDeclK)
+            nFuncs++;
+    funcs = (TreeNode **)malloc((nFuncs + 1) * sizeof(TreeNode *));
+    io = (int *)calloc(nFuncs + 1, sizeof(int));
+    pure = (int *)calloc(nFuncs + 1, sizeof(int));
+    if (funcs == NULL || io == NULL || pure == NULL){
+        fprintf(listing, "Out of memory error at line %d\n", lineno);
+        exit(-1);
+    }
+    nFuncs = 0;
+    for (TreeNode * t = syntaxTree; t != NULL; t = t->sibling)
+        if (t->kind.exp == FuncDeclK){
+            funcs[nFuncs] = t;
+            t->bind.offset = nFuncs;
+            io[nFuncs++] = t->child[1] == NULL;
+        }
+    do {
+        changed = FALSE;
+        for (int i = 0; i < nFuncs; i++)
+            if (!io[i] && doesIo(funcs[i]->child[1])){
+                io[i] = TRUE;
+                changed = TRUE;
+            }
+    } while (changed);
+    for (int i = 0; i < nFuncs; i++){
+        pure[i] = !io[i] && funcs[i]->type == Integer;
+        for (TreeNode * p = funcs[i]->child[0]; p != NULL; p = p->sibling)
+            if (p->kind.exp == ArrayDeclK)
+                pure[i] = FALSE;
+    }
+    do {
+        changed = FALSE;
+        for (int i = 0; i < nFuncs; i++)
+            if (pure[i] && impure(funcs[i]->child[1])){
+                pure[i] = FALSE;
+                changed = TRUE;
+            }
+    } while (changed);
+}
+
+/* Function runMain runs the first n statements of
+ * body, the body of main, in frame locals with
+ * the globals of the program all 0, and returns
+ * how many it finished
+ */
+static int runMain(TreeNode * syntaxTree, TreeNode * body, int n, Frame * locals)
+{
+    TreeNode * s = body->child[1];
+    int done = 0;
+    for (TreeNode * t = syntaxTree; t != NULL; t = t->sibling)
+        if (t->kind.exp != FuncDeclK){
+            int width = (t->kind.exp == ArrayDeclK) ? t->size : 1;
+            memset(newBlock(&globals, t, width)->set, TRUE, width);
+        }
+    frame = locals;
+    declare(body->child[0]);
+    steps = PEVAL_STEPS;
+    depth = 0;
+    failed = FALSE;
+    returned = FALSE;
+    for (; done < n; s = s->sibling, done++){
+        execStmt(s);
+        if (failed)
+            break;
+    }
+    frame = NULL;
+    return done;
+}
+
+static int anySet(Block * b)
+{
+    for (int k = 0; k < b->size; k++)
+        if (b->set[k])
+            return TRUE;
+    return FALSE;
+}
+
+/* Function initOf returns a copy of the words of
+ * block b, 0 where not set, or NULL if all are 0
+ */
+static int * initOf(Block * b)
+{
+    int * init = NULL;
+    for (int k = 0; k < b->size; k++)
+        if (b->set[k] && b->val[k] != 0){
+            if (init == NULL){
+                init = (int *)calloc(b->size, sizeof(int));
+                if (init == NULL){
+                    fprintf(listing, "Out of memory error at line %d\n", lineno);
+                    exit(-1);
+                }
+            }
+            init[k] = b->val[k];
+        }
+    return init;
+}
+
+/* Procedure rebind makes the identifiers in tree
+ * naming decl take its binding again
+ */
+static void rebind(TreeNode * tree, TreeNode * decl)
+{
+    for (; tree != NULL; tree = tree->sibling){
+        if (tree->nodekind == ExpK && tree->kind.exp == IdK && tree->decl == decl)
+            tree->bind = decl->bind;
+        for (int i = 0; i < MAXCHILDREN; i++)
+            rebind(tree->child[i], decl);
+    }
+}
+
+/* Function dataEnd returns the end of the global
+ * data of a program
+ */
+static int dataEnd(TreeNode * syntaxTree)
+{
+    int end = sf_dataEnd();
+    for (TreeNode * t = syntaxTree; t != NULL; t = t->sibling)
+        if (t->kind.exp != FuncDeclK){
+            int width = (t->kind.exp == ArrayDeclK) ? t->size : 1;
+            if (end < t->bind.offset + width)
+                end = t->bind.offset + width;
+        }
+    return end;
+}
+
+/* Function keepMain replaces the first done
+ * statements of main, which left the globals and
+ * the locals of main as they are now, by what
+ * they computed, and returns the program with
+ * the arrays of main moved into global data; it
+ * returns NULL, changing nothing, when they do
+ * not fit there
+ */
+static TreeNode * keepMain(TreeNode * syntaxTree, TreeNode * main, int done, Frame * locals)
+{
+    TreeNode * body = main->child[1], * head = NULL, ** last = &head, ** loc, * rest;
+    int end = dataEnd(syntaxTree), moved = 0;
+    for (TreeNode * d = body->child[0]; d != NULL; d = d->sibling)
+        if (d->kind.exp == ArrayDeclK && anySet(findBlock(locals, d)))
+            moved += d->size;
+    if (end + moved > DATA_BUDGET)
+        return NULL;
+    for (TreeNode * t = syntaxTree; t != NULL; t = t->sibling)
+        if (t->kind.exp != FuncDeclK){
+            free(t->init);
+            t->init = initOf(findBlock(&globals, t));
+        }
+    rest = body->child[1];
+    for (int i = 0; i < done; i++){
+        TreeNode * s = rest;
+        rest = rest->sibling;
+        s->sibling = NULL;
+        freeTree(s);
+    }
+    loc = &body->child[0];
+    while (*loc != NULL){
+        TreeNode * d = *loc;
+        Block * b = findBlock(locals, d);
+        if (d->kind.exp == VarDeclK){
+            if (b->set[0]){
+                *last = newAssign(newTempId(d, body->lineno), newConst(b->val[0], body->lineno));
+                last = &(*last)->sibling;
+            }
+            loc = &d->sibling;
+        }
+        else if (!anySet(b))
+            loc = &d->sibling;
+        else {
+            *loc = d->sibling;
+            d->bind.storage = GlobalK;
+            d->bind.offset = end;
+            end += d->size;
+            d->init = initOf(b);
+            rebind(rest, d);
+            fprintf(listing, "Moved array %s of main at line %d into global data\n",
+                    d->attr.name, d->lineno);
+            d->sibling = syntaxTree;
+            syntaxTree = d;
+        }
+    }
+    *last = rest;
+    body->child[1] = head;
+    return syntaxTree;
+}
+
+/* Function runnable tells whether statement s
+ * of main may run at compile time: it does no
+ * input or output and does not return
+ */
+static int runnable(TreeNode * s)
+{
+    TreeNode * next = s->sibling;
+    int ok;
+    s->sibling = NULL;
+    ok = !doesIo(s) && !hasReturn(s);
+    s->sibling = next;
+    return ok;
+}
+
+/* Function evaluateMain runs what main starts
+ * with that does no input or output, and returns
+ * the program with it replaced
+ */
+static TreeNode * evaluateMain(TreeNode * syntaxTree, TreeNode * main)
+{
+    TreeNode * body = main->child[1], * program;
+    Frame locals = { NULL, 0, 0 };
+    int n = 0, done;
+    for (TreeNode * s = body->child[1]; s != NULL && runnable(s); s = s->sibling)
+        n++;
+    if (n == 0)
+        return syntaxTree;
+    done = runMain(syntaxTree, body, n, &locals);
+    if (failed){
+        /* run again up to the statement that
+         * stopped, for what it had computed
+         */
+        freeFrame(&globals);
+        freeFrame(&locals);
+        done = runMain(syntaxTree, body, done, &locals);
+    }
+    if (done > 0){
+        long taken = PEVAL_STEPS - steps;
+        program = keepMain(syntaxTree, main, done, &locals);
+        if (program != NULL){
+            fprintf(listing, "Evaluated %d statements of main at compile time in %ld steps\n",
+                    done, taken);
+            syntaxTree = program;
+        }
+    }
+    freeFrame(&globals);
+    freeFrame(&locals);
+    return syntaxTree;
+}
+
+static int constArgs(TreeNode * call)
+{
+    for (TreeNode * a = call->child[0]; a != NULL; a = a->sibling)
+        if (a->nodekind != ExpK || a->kind.exp != ConstK)
+            return FALSE;
+    return TRUE;
+}
+
+/* Procedure foldCalls replaces each call in the
+ * list at loc of a pure function with constant
+ * arguments by the value it returns, innermost
+ * calls first
+ */
+static void foldCalls(TreeNode ** loc)
+{
+    for (; *loc != NULL; loc = &(*loc)->sibling){
+        TreeNode * t = *loc, * c;
+        int i, value;
+        for (i = 0; i < MAXCHILDREN; i++)
+            foldCalls(&t->child[i]);
+        if (!isStmt(t, CallK) || !constArgs(t))
+            continue;
+        i = indexOf(t->decl);
+        if (i < 0 || !pure[i] || steps <= 0)
+            continue;
+        frame = NULL;
+        depth = 0;
+        failed = FALSE;
+        returned = FALSE;
+        value = evalCall(t);
+        if (failed)
+            continue;
+        fprintf(listing, "Evaluated call of %s at line %d to %d\n",
+                t->attr.name, t->lineno, value);
+        c = newConst(value, t->lineno);
+        c->sibling = t->sibling;
+        t->sibling = NULL;
+        freeTree(t);
+        *loc = c;
+    }
+}
+
+/* Function evaluateProgram runs at compile time,
+ * within a budget of steps, the statements main
+ * starts with that do no input or output, and
+ * returns the program left: the globals and the
+ * arrays of main they set start the TM run with
+ * the words they were left with, the scalars of
+ * main are assigned theirs and the run starts at
+ * the first statement left. Calls of pure
+ * functions with constant arguments are replaced
+ * by the values they return
+ */
+TreeNode * evaluateProgram(TreeNode * syntaxTree)
+{
+    TreeNode * main = NULL;
+    if (Library)
+        return syntaxTree;
+    for (TreeNode * t = syntaxTree; t != NULL; t = t->sibling)
+        if (t->kind.exp == FuncDeclK && strcmp(t->attr.name, "main") == 0)
+            main = t;
+    if (main == NULL || main->child[1] == NULL)
+        return syntaxTree;
+    classify(syntaxTree);
+    /* main called again would find its arrays
+     * and the globals as it left them
+     */
+    for (int i = 0; i < nFuncs; i++)
+        if (calls(funcs[i]->child[1], main))
+            main = NULL;
+    if (main != NULL && main->child[0] == NULL)
+        syntaxTree = evaluateMain(syntaxTree, main);
+    steps = PEVAL_STEPS;
+    for (TreeNode * t = syntaxTree; t != NULL; t = t->sibling)
+        if (t->kind.exp == FuncDeclK && t->child[1] != NULL)
+            foldCalls(&t->child[1]->child[1]);
+    for (int i = 0; i < nFuncs; i++)
+        funcs[i]->bind.offset = 0;
+    free(funcs);
+    free(io);
+    free(pure);
+    funcs = NULL;
+    io = NULL;
+    pure = NULL;
+    nFuncs = 0;
+    return syntaxTree;
+}
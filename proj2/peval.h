@@ -0,0 +1,24 @@
+/****************************************************/
+/* File: peval.h                                    */
+/* Partial evaluation for the C-MINUS compiler      */
+/* Compiler Construction: Principles and Practice   */
+/* Kenneth C. Louden                                */
+/****************************************************/
+
+#ifndef _PEVAL_H_
+#define _PEVAL_H_
+
+/* Function evaluateProgram runs at compile time,
+ * within a budget of steps, the statements main
+ * starts with that do no input or output, and
+ * returns the program left: the globals and the
+ * arrays of main they set start the TM run with
+ * the words they were left with, the scalars of
+ * main are assigned theirs and the run starts at
+ * the first statement left. Calls of pure
+ * functions with constant arguments are replaced
+ * by the values they return
+ */
+TreeNode * evaluateProgram(TreeNode * syntaxTree);
+
+#endif
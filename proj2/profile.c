@@ -0,0 +1,130 @@
+/****************************************************/
+/* File: profile.c                                  */
+/* Execution profiles for the C-MINUS compiler      */
+/* The TM run with -p counts the jumps the compiler */
+/* noted in the code file and writes them by source */
+/* line and site, the order of the branch or call  */
+/* among those of its line, one record a line:      */
+/*   branch <line> <site> <true> <false>            */
+/*   call <line> <site> <callee> <count>            */
+/* Records naming the same site add up, so the      */
+/* copies inlining and unrolling made of a branch   */
+/* or call count together                           */
+/* Compiler Construction: Principles and Practice   */
+/* Kenneth C. Louden                                */
+/****************************************************/
+
+#include "globals.h"
+#include "util.h"
+#include "scan.h"
+#include "profile.h"
+
+typedef struct
+{
+    int branch; /* TRUE for a branch, FALSE for a call */
+    int line;
+    int site;
+    char * callee;
+    long count[2]; /* true and false, or calls */
+} ProfRec;
+
+static ProfRec * recs = NULL;
+static int nRecs = 0, maxRecs = 0;
+static int loaded = FALSE;
+
+static ProfRec * find(int branch, int line, int site, char * callee)
+{
+    for (int i = 0; i < nRecs; i++)
+        if (recs[i].branch == branch && recs[i].line == line && recs[i].site == site &&
+            (branch || strcmp(recs[i].callee, callee) == 0))
+            return &recs[i];
+    return NULL;
+}
+
+static ProfRec * add(int branch, int line, int site, char * callee)
+{
+    ProfRec * r = find(branch, line, site, callee);
+    if (r != NULL)
+        return r;
+    if (nRecs == maxRecs){
+        maxRecs = (maxRecs == 0) ? 64 : 2 * maxRecs;
+        recs = (ProfRec *)realloc(recs, maxRecs * sizeof(ProfRec));
+        if (recs == NULL){
+            fprintf(listing, "Out of memory error at line %d\n", lineno);
+            exit(-1);
+        }
+    }
+    r = &recs[nRecs++];
+    r->branch = branch;
+    r->line = line;
+    r->site = site;
+    r->callee = branch ? NULL : copyString(callee);
+    r->count[0] = r->count[1] = 0;
+    return r;
+}
+
+/* Function readProfile loads an execution profile
+ * the TM wrote for the program being compiled. It
+ * returns FALSE if the file cannot be read
+ */
+int readProfile(char * filename)
+{
+    FILE * f = fopen(filename, "r");
+    char kind[16], callee[MAXTOKENLEN + 1];
+    int line, site;
+    long a, b;
+    if (f == NULL)
+        return FALSE;
+    while (fscanf(f, "%15s", kind) == 1){
+        if (strcmp(kind, "branch") == 0 &&
+            fscanf(f, "%d %d %ld %ld", &line, &site, &a, &b) == 4){
+            ProfRec * r = add(TRUE, line, site, NULL);
+            r->count[0] += a;
+            r->count[1] += b;
+        }
+        else if (strcmp(kind, "call") == 0 &&
+                 fscanf(f, "%d %d %40s %ld", &line, &site, callee, &a) == 4)
+            add(FALSE, line, site, callee)->count[0] += a;
+        else {
+            fclose(f);
+            return FALSE;
+        }
+    }
+    fclose(f);
+    loaded = TRUE;
+    return TRUE;
+}
+
+/* Function profileLoaded tells whether a profile
+ * was read
+ */
+int profileLoaded(void)
+{
+    return loaded;
+}
+
+/* Function profileBranch finds how often the
+ * condition of branch site of source line lineno
+ * was true and false, FALSE if the profile does
+ * not cover it
+ */
+int profileBranch(int lineno, int site, long * taken, long * notTaken)
+{
+    ProfRec * r = find(TRUE, lineno, site, NULL);
+    if (r == NULL)
+        return FALSE;
+    *taken = r->count[0];
+    *notTaken = r->count[1];
+    return TRUE;
+}
+
+/* Function profileCalls returns how often
+ * function callee was called from call site of
+ * source line lineno, -1 if the profile does not
+ * cover it
+ */
+long profileCalls(int lineno, int site, char * callee)
+{
+    ProfRec * r = find(FALSE, lineno, site, callee);
+    return (r == NULL) ? -1 : r->count[0];
+}
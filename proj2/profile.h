@@ -0,0 +1,38 @@
+/****************************************************/
+/* File: profile.h                                  */
+/* Execution profiles for the C-MINUS compiler      */
+/* Compiler Construction: Principles and Practice   */
+/* Kenneth C. Louden                                */
+/****************************************************/
+
+#ifndef _PROFILE_H_
+#define _PROFILE_H_
+
+/* Function readProfile loads an execution profile
+ * the TM wrote for the program being compiled. It
+ * returns FALSE if the file cannot be read
+ */
+int readProfile(char * filename);
+
+/* Function profileLoaded tells whether a profile
+ * was read
+ */
+int profileLoaded(void);
+
+/* Function profileBranch finds how often the
+ * condition of branch site of source line lineno
+ * was true, in taken, and false, in notTaken; the
+ * site numbers the branches and calls of a line
+ * in source order. It returns FALSE if the
+ * profile does not cover the branch
+ */
+int profileBranch(int lineno, int site, long * taken, long * notTaken);
+
+/* Function profileCalls returns how often
+ * function callee was called from call site of
+ * source line lineno, -1 if the profile does not
+ * cover the call
+ */
+long profileCalls(int lineno, int site, char * callee);
+
+#endif
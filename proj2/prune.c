@@ -0,0 +1,174 @@
+/****************************************************/
+/* File: prune.c                                    */
+/* Dead function and global elimination for the     */
+/* C-MINUS compiler                                 */
+/* The declarations of the program reachable from   */
+/* main over calls and references to globals are    */
+/* marked by a worklist; the others are dropped     */
+/* and the globals kept are packed again from the   */
+/* end of the imported data. Declarations imported  */
+/* from a symbol file have no line and are never    */
+/* dropped                                          */
+/* Compiler Construction: Principles and Practice   */
+/* Kenneth C. Louden                                */
+/****************************************************/
+
+#include "globals.h"
+#include "util.h"
+#include "symfile.h"
+#include "prune.h"
+
+/* a declaration of the program, whether it is
+ * reachable from main and its offset before
+ */
+typedef struct
+{
+    TreeNode * node;
+    int live;
+    int offset;
+} DeclRec;
+
+static DeclRec * decls = NULL;
+static int nDecls = 0;
+
+/* indices of declarations marked but not yet
+ * visited
+ */
+static int * work = NULL;
+static int nWork = 0;
+
+/* Function inProgram tells whether declaration d
+ * is one of the program rather than imported
+ */
+static int inProgram(TreeNode * d)
+{
+    return d != NULL && d->lineno > 0;
+}
+
+/* Procedure mark makes declaration d reachable.
+ * While the program is pruned the offset of a
+ * declaration holds its index in decls
+ */
+static void mark(TreeNode * d)
+{
+    DeclRec * r;
+    if (!inProgram(d) || d->bind.offset < 0 || d->bind.offset >= nDecls)
+        return;
+    r = &decls[d->bind.offset];
+    if (r->node != d || r->live)
+        return;
+    r->live = TRUE;
+    work[nWork++] = d->bind.offset;
+}
+
+/* Procedure markRefs marks what a subtree calls
+ * and the globals it references
+ */
+static void markRefs(TreeNode * t)
+{
+    for (; t != NULL; t = t->sibling){
+        if (t->nodekind == StmtK && t->kind.stmt == CallK &&
+            t->decl->bind.storage != BuiltinK)
+            mark(t->decl);
+        else if (t->nodekind == ExpK && t->kind.exp == IdK && t->bind.storage == GlobalK)
+            mark(t->decl);
+        for (int i = 0; i < MAXCHILDREN; i++)
+            markRefs(t->child[i]);
+    }
+}
+
+/* Procedure rebindGlobals copies the new offsets
+ * of the globals into the identifiers of a subtree
+ */
+static void rebindGlobals(TreeNode * t)
+{
+    for (; t != NULL; t = t->sibling){
+        if (t->nodekind == ExpK && t->kind.exp == IdK &&
+            t->bind.storage == GlobalK && inProgram(t->decl))
+            t->bind.offset = t->decl->bind.offset;
+        for (int i = 0; i < MAXCHILDREN; i++)
+            rebindGlobals(t->child[i]);
+    }
+}
+
+/* Function removeUnreachable drops the functions
+ * and globals of an analyzed program that main
+ * neither calls nor references, directly or not,
+ * reports them in the listing and returns the
+ * program left. A library, which has no main,
+ * is left alone
+ */
+TreeNode * removeUnreachable(TreeNode * syntaxTree)
+{
+    TreeNode * head = NULL, ** last = &head, * t;
+    int location = sf_dataEnd();
+    int nFuncs = 0, nGlobals = 0, moved = FALSE;
+    if (Library)
+        return syntaxTree;
+    nDecls = 0;
+    for (t = syntaxTree; t != NULL; t = t->sibling)
+        nDecls++;
+    decls = (DeclRec *)malloc((nDecls + 1) * sizeof(DeclRec));
+    work = (int *)malloc((nDecls + 1) * sizeof(int));
+    if (decls == NULL || work == NULL){
+        fprintf(listing, "Out of memory error at line %d\n", lineno);
+        exit(-1);
+    }
+    nDecls = 0;
+    nWork = 0;
+    for (t = syntaxTree; t != NULL; t = t->sibling){
+        decls[nDecls].node = t;
+        decls[nDecls].live = FALSE;
+        decls[nDecls].offset = t->bind.offset;
+        t->bind.offset = nDecls++;
+    }
+    for (t = syntaxTree; t != NULL; t = t->sibling)
+        if (t->kind.exp == FuncDeclK && strcmp(t->attr.name, "main") == 0)
+            mark(t);
+    while (nWork > 0){
+        TreeNode * d = decls[work[--nWork]].node;
+        if (d->kind.exp == FuncDeclK)
+            markRefs(d->child[1]);
+    }
+    for (int i = 0; i < nDecls; i++){
+        t = decls[i].node;
+        t->sibling = NULL;
+        if (!decls[i].live){
+            if (t->kind.exp == FuncDeclK){
+                fprintf(listing, "Removed unreachable function %s at line %d\n",
+                        t->attr.name, t->lineno);
+                nFuncs++;
+            }
+            else {
+                fprintf(listing, "Removed unused global %s at line %d\n",
+                        t->attr.name, t->lineno);
+                nGlobals++;
+            }
+            freeTree(t);
+            continue;
+        }
+        if (t->kind.exp == FuncDeclK)
+            t->bind.offset = 0;
+        else {
+            t->bind.offset = location;
+            location += (t->kind.exp == ArrayDeclK) ? t->size : 1;
+            moved = moved || t->bind.offset != decls[i].offset;
+        }
+        *last = t;
+        last = &t->sibling;
+    }
+    /* globals declared since the last pruning may
+     * not come in the order of their offsets
+     */
+    if (moved)
+        for (t = head; t != NULL; t = t->sibling)
+            if (t->kind.exp == FuncDeclK)
+                rebindGlobals(t->child[1]);
+    if (nFuncs > 0 || nGlobals > 0)
+        fprintf(listing, "Removed %d functions and %d globals\n", nFuncs, nGlobals);
+    free(decls);
+    free(work);
+    decls = NULL;
+    work = NULL;
+    return head;
+}
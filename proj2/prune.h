@@ -0,0 +1,21 @@
+/****************************************************/
+/* File: prune.h                                    */
+/* Dead function and global elimination for the     */
+/* C-MINUS compiler                                 */
+/* Compiler Construction: Principles and Practice   */
+/* Kenneth C. Louden                                */
+/****************************************************/
+
+#ifndef _PRUNE_H_
+#define _PRUNE_H_
+
+/* Function removeUnreachable drops the functions
+ * and globals of an analyzed program that main
+ * neither calls nor references, directly or not,
+ * reports them in the listing and returns the
+ * program left. A library, which has no main,
+ * is left alone
+ */
+TreeNode * removeUnreachable(TreeNode * syntaxTree);
+
+#endif
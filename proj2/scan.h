@@ -19,4 +19,9 @@ extern char tokenString[MAXTOKENLEN+1];
  */
 TokenType getToken(void);
 
+/* Procedure resetScanner makes getToken start
+ * over at the beginning of a reopened source
+ */
+void resetScanner(void);
+
 #endif
@@ -0,0 +1,304 @@
+/****************************************************/
+/* File: sccp.c                                     */
+/* Sparse conditional constant propagation for the  */
+/* C-MINUS compiler                                 */
+/* The algorithm of Wegman and Zadeck: each value   */
+/* starts unknown and only falls to a constant or   */
+/* to varying, and a block is visited only once an  */
+/* edge into it is found to run. A phi meets just   */
+/* the arguments of the edges that run, so a value  */
+/* set once before a loop and kept by every path    */
+/* through it stays constant, and the branches it   */
+/* decides follow one edge                          */
+/* Compiler Construction: Principles and Practice   */
+/* Kenneth C. Louden                                */
+/****************************************************/
+
+#include "globals.h"
+#include "fold.h"
+#include "sccp.h"
+
+/* the lattice of a value */
+typedef enum { Unknown, Constant, Varying } Lattice;
+
+static IrFunc * ir;
+static Lattice * state;
+static int * val;
+
+/* the instructions reading each value: those of
+ * value v are users[first[v]] on to users[first[v+1]]
+ */
+static IrInst ** users;
+static int * first;
+
+/* whether each block runs, and each edge into
+ * it: edge k of block b is at edges[edgeBase[b]+k]
+ */
+static int * runs;
+static int * edges;
+static int * edgeBase;
+
+/* edges found to run and values whose lattice
+ * fell, not yet visited
+ */
+typedef struct
+{
+    IrBlock * block;
+    int pred;
+} EdgeRec;
+
+static EdgeRec * edgeWork;
+static int nEdgeWork;
+static int * valueWork;
+static int nValueWork;
+
+static void * allocate(int n, int size)
+{
+    void * p = calloc(n + 1, size);
+    if (p == NULL){
+        fprintf(listing, "Out of memory error at line %d\n", lineno);
+        exit(-1);
+    }
+    return p;
+}
+
+/* Procedure lower moves value v down to lattice
+ * s, with constant c
+ */
+static void lower(int v, Lattice s, int c)
+{
+    if (s <= state[v])
+        return;
+    state[v] = s;
+    val[v] = c;
+    valueWork[nValueWork++] = v;
+}
+
+/* Procedure follow marks the edges from block
+ * from to block to as running
+ */
+static void follow(IrBlock * from, IrBlock * to)
+{
+    for (int k = 0; k < to->nPreds; k++)
+        if (to->preds[k] == from && !edges[edgeBase[to->rpo] + k]){
+            edges[edgeBase[to->rpo] + k] = TRUE;
+            edgeWork[nEdgeWork].block = to;
+            edgeWork[nEdgeWork++].pred = k;
+        }
+}
+
+static void visitPhi(IrInst * phi)
+{
+    IrBlock * b = phi->block;
+    for (int k = 0; k < phi->nArgs; k++){
+        int a = phi->args[k];
+        if (!edges[edgeBase[b->rpo] + k] || state[a] == Unknown)
+            continue;
+        if (state[a] == Varying || (state[phi->dst] == Constant && val[phi->dst] != val[a])){
+            lower(phi->dst, Varying, 0);
+            return;
+        }
+        lower(phi->dst, Constant, val[a]);
+    }
+}
+
+static void visitBin(IrInst * inst)
+{
+    int l = inst->args[0], r = inst->args[1], ok;
+    int c;
+    /* a product with zero is zero whatever the
+     * other factor
+     */
+    if (inst->binop == TIMES && ((state[l] == Constant && val[l] == 0) ||
+        (state[r] == Constant && val[r] == 0))){
+        lower(inst->dst, Constant, 0);
+        return;
+    }
+    if (state[l] == Varying || state[r] == Varying){
+        lower(inst->dst, Varying, 0);
+        return;
+    }
+    if (state[l] == Unknown || state[r] == Unknown)
+        return;
+    c = evaluateOp(inst->binop, val[l], val[r], &ok);
+    lower(inst->dst, ok ? Constant : Varying, c);
+}
+
+static void visit(IrInst * inst)
+{
+    int c;
+    switch (inst->op){
+        case IR_PHI:
+            visitPhi(inst);
+            break;
+        case IR_CONST:
+            lower(inst->dst, Constant, inst->imm);
+            break;
+        case IR_COPY:
+            c = inst->args[0];
+            if (state[c] != Unknown)
+                lower(inst->dst, state[c], val[c]);
+            break;
+        case IR_BIN:
+            visitBin(inst);
+            break;
+        case IR_JUMP:
+            follow(inst->block, inst->target[0]);
+            break;
+        case IR_BRANCH:
+            c = inst->args[0];
+            if (state[c] == Varying){
+                follow(inst->block, inst->target[0]);
+                follow(inst->block, inst->target[1]);
+            }
+            else if (state[c] == Constant)
+                follow(inst->block, inst->target[val[c] != 0 ? 0 : 1]);
+            break;
+        default:
+            if (inst->dst >= 0)
+                lower(inst->dst, Varying, 0);
+            break;
+    }
+}
+
+/* Procedure findUsers lists the instructions
+ * reading each value
+ */
+static void findUsers(void)
+{
+    int * count = (int *)allocate(ir->nValues + 1, sizeof(int));
+    int total = 0;
+    first = (int *)allocate(ir->nValues + 1, sizeof(int));
+    for (int i = 0; i < ir->nBlocks; i++)
+        for (IrInst * inst = ir->blocks[i]->first; inst != NULL; inst = inst->next)
+            for (int k = 0; k < inst->nArgs; k++)
+                count[inst->args[k]]++;
+    for (int v = 0; v < ir->nValues; v++){
+        first[v] = total;
+        total += count[v];
+        count[v] = first[v];
+    }
+    first[ir->nValues] = total;
+    users = (IrInst **)allocate(total, sizeof(IrInst *));
+    for (int i = 0; i < ir->nBlocks; i++)
+        for (IrInst * inst = ir->blocks[i]->first; inst != NULL; inst = inst->next)
+            for (int k = 0; k < inst->nArgs; k++)
+                users[count[inst->args[k]]++] = inst;
+    free(count);
+}
+
+/* Procedure rewrite makes the constant values
+ * constants and the decided branches jumps
+ */
+static void rewrite(void)
+{
+    int * repl = (int *)allocate(ir->nValues, sizeof(int));
+    int n = ir->nValues;
+    for (int v = 0; v < n; v++)
+        repl[v] = v;
+    for (int i = 0; i < ir->nBlocks; i++){
+        IrBlock * b = ir->blocks[i];
+        IrInst * inst = b->first, * body;
+        if (!runs[i])
+            continue;
+        body = inst;
+        while (body != NULL && body->op == IR_PHI)
+            body = body->next;
+        while (inst != NULL){
+            IrInst * next = inst->next;
+            int v = inst->dst;
+            if (v >= 0 && v < n && state[v] == Constant && inst->op != IR_CONST){
+                if (inst->op == IR_PHI){
+                    /* constants come after the phis */
+                    IrInst * c = irNewInst(IR_CONST);
+                    c->imm = val[v];
+                    c->lineno = inst->lineno;
+                    irInsertBefore(body, c);
+                    repl[v] = irNewValue(ir, c);
+                    irRemove(ir, inst);
+                }
+                else if (!irHasEffect(inst)){
+                    inst->op = IR_CONST;
+                    inst->imm = val[v];
+                    inst->nArgs = 0;
+                }
+            }
+            else if (inst->op == IR_BRANCH && state[inst->args[0]] == Constant){
+                int taken = (val[inst->args[0]] != 0) ? 0 : 1;
+                IrBlock * dropped = inst->target[1 - taken];
+                inst->op = IR_JUMP;
+                inst->target[0] = inst->target[taken];
+                inst->target[1] = NULL;
+                inst->nArgs = 0;
+                irRemoveEdge(b, dropped);
+            }
+            inst = next;
+        }
+    }
+    for (int i = 0; i < ir->nBlocks; i++)
+        for (IrInst * inst = ir->blocks[i]->first; inst != NULL; inst = inst->next)
+            for (int k = 0; k < inst->nArgs; k++)
+                if (inst->args[k] < n)
+                    inst->args[k] = repl[inst->args[k]];
+    free(repl);
+}
+
+/* Procedure propagateConstants finds the values
+ * of a function in SSA form that are constant on
+ * every path that runs, and the branches that can
+ * go only one way. The values are made constants,
+ * the branches jumps, and the blocks no path
+ * reaches any more are removed
+ */
+void propagateConstants(IrFunc * f)
+{
+    int nEdges = 0, n;
+    ir = f;
+    n = ir->nValues;
+    state = (Lattice *)allocate(n, sizeof(Lattice));
+    val = (int *)allocate(n, sizeof(int));
+    valueWork = (int *)allocate(2 * n, sizeof(int));
+    runs = (int *)allocate(ir->nBlocks, sizeof(int));
+    edgeBase = (int *)allocate(ir->nBlocks, sizeof(int));
+    for (int i = 0; i < ir->nBlocks; i++){
+        edgeBase[i] = nEdges;
+        nEdges += ir->blocks[i]->nPreds;
+    }
+    edges = (int *)allocate(nEdges, sizeof(int));
+    edgeWork = (EdgeRec *)allocate(nEdges, sizeof(EdgeRec));
+    nEdgeWork = nValueWork = 0;
+    findUsers();
+    runs[0] = TRUE;
+    for (IrInst * inst = ir->blocks[0]->first; inst != NULL; inst = inst->next)
+        visit(inst);
+    while (nEdgeWork > 0 || nValueWork > 0){
+        while (nEdgeWork > 0){
+            IrBlock * b = edgeWork[--nEdgeWork].block;
+            if (!runs[b->rpo]){
+                runs[b->rpo] = TRUE;
+                for (IrInst * inst = b->first; inst != NULL; inst = inst->next)
+                    visit(inst);
+            }
+            else
+                for (IrInst * inst = b->first; inst != NULL && inst->op == IR_PHI; inst = inst->next)
+                    visit(inst);
+        }
+        while (nValueWork > 0 && nEdgeWork == 0){
+            int v = valueWork[--nValueWork];
+            for (int u = first[v]; u < first[v + 1]; u++)
+                if (runs[users[u]->block->rpo])
+                    visit(users[u]);
+        }
+    }
+    rewrite();
+    irAnalyze(ir);
+    free(state);
+    free(val);
+    free(valueWork);
+    free(runs);
+    free(edgeBase);
+    free(edges);
+    free(edgeWork);
+    free(first);
+    free(users);
+}
@@ -0,0 +1,23 @@
+/****************************************************/
+/* File: sccp.h                                     */
+/* Sparse conditional constant propagation for the  */
+/* C-MINUS compiler                                 */
+/* Compiler Construction: Principles and Practice   */
+/* Kenneth C. Louden                                */
+/****************************************************/
+
+#ifndef _SCCP_H_
+#define _SCCP_H_
+
+#include "ir.h"
+
+/* Procedure propagateConstants finds the values
+ * of a function in SSA form that are constant on
+ * every path that runs, and the branches that can
+ * go only one way. The values are made constants,
+ * the branches jumps, and the blocks no path
+ * reaches any more are removed
+ */
+void propagateConstants(IrFunc * ir);
+
+#endif
@@ -0,0 +1,124 @@
+/****************************************************/
+/* File: stbench.c                                  */
+/* Contention benchmark of the concurrent file      */
+/* scope against one global lock around symtab.c    */
+/* usage: stbench [names [operations]]              */
+/* Compiler Construction: Principles and Practice   */
+/* Kenneth C. Louden                                */
+/****************************************************/
+
+#include <pthread.h>
+#include <time.h>
+#include "globals.h"
+#include "util.h"
+#include "symtab.h"
+#include "cstab.h"
+
+/* globals symtab.c reports errors with */
+int lineno = 0;
+FILE * listing;
+
+#define MAXTHREADS 32
+
+/* one insert for every INSERT_RATIO operations,
+ * the others are lookups
+ */
+#define INSERT_RATIO 8
+
+static char ** names;
+static int nNames = 20000;
+static int nOps = 2000000;
+
+static ConcurrentScope shared;
+static Scope locked;
+static pthread_mutex_t globalLock = PTHREAD_MUTEX_INITIALIZER;
+static int nThreads;
+static int useLock;
+
+/* Procedure worker runs the operations of one
+ * thread. Thread k starts at name k*nNames/8, so
+ * the names of neighbouring threads overlap
+ */
+static void * worker(void * arg)
+{
+    long k = (long)arg;
+    unsigned int seed = 12345 + k;
+    int base = (int)(k * nNames / 8);
+    int ops = nOps / nThreads;
+    long found = 0;
+    for (int i = 0; i < ops; i++){
+        char * name;
+        seed = seed * 1103515245 + 12345;
+        name = names[(base + (seed >> 8) % (nNames / 2)) % nNames];
+        if (useLock){
+            pthread_mutex_lock(&globalLock);
+            if (i % INSERT_RATIO == 0){
+                sc_push(locked);
+                st_insert(name, i, i, NULL);
+            }
+            else {
+                sc_push(locked);
+                found += (st_lookup(name) != NULL);
+            }
+            pthread_mutex_unlock(&globalLock);
+        }
+        else if (i % INSERT_RATIO == 0)
+            cst_insert(shared, name, i, i, NULL);
+        else
+            found += (cst_lookup(shared, name) != NULL);
+    }
+    return (void *)found;
+}
+
+static double run(int threads, int lock)
+{
+    pthread_t tid[MAXTHREADS];
+    struct timespec start, end;
+    nThreads = threads;
+    useLock = lock;
+    shared = cs_new("global");
+    locked = sc_new("global", NULL);
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    for (long k = 0; k < threads; k++)
+        pthread_create(&tid[k], NULL, worker, (void *)k);
+    for (int k = 0; k < threads; k++)
+        pthread_join(tid[k], NULL);
+    clock_gettime(CLOCK_MONOTONIC, &end);
+    cs_free(shared);
+    sc_free(locked);
+    return (end.tv_sec - start.tv_sec) + (end.tv_nsec - start.tv_nsec) / 1e9;
+}
+
+int main(int argc, char * argv[])
+{
+    static int threads[] = { 1, 2, 4, 8, 16, 32 };
+    listing = stderr;
+    if (argc > 1)
+        nNames = atoi(argv[1]);
+    if (argc > 2)
+        nOps = atoi(argv[2]);
+    if (nNames < 2 || nOps < 1){
+        fprintf(stderr, "usage: %s [names [operations]]\n", argv[0]);
+        exit(1);
+    }
+    names = (char **)malloc(nNames * sizeof(char *));
+    for (int i = 0; i < nNames; i++){
+        /* identifiers are letters only */
+        char buf[16];
+        int n = i, j = 0;
+        do {
+            buf[j++] = 'a' + n % 26;
+            n /= 26;
+        } while (n > 0);
+        buf[j] = '\0';
+        names[i] = copyString(buf);
+    }
+    printf("%d names, %d operations, 1 insert in %d\n", nNames, nOps, INSERT_RATIO);
+    printf("threads  global lock Mops/s  concurrent Mops/s\n");
+    for (int i = 0; i < (int)(sizeof(threads) / sizeof(threads[0])); i++){
+        double tl = run(threads[i], TRUE);
+        double tc = run(threads[i], FALSE);
+        printf("%7d  %18.2f  %17.2f\n", threads[i], nOps / tl / 1e6, nOps / tc / 1e6);
+    }
+    return 0;
+}
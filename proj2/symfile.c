@@ -0,0 +1,312 @@
+/****************************************************/
+/* File: symfile.c                                  */
+/* Symbol file implementation for the C-MINUS       */
+/* compiler. A symbol file is a header, a hash      */
+/* index of chained records, the parameter records  */
+/* and a string table                               */
+/* Compiler Construction: Principles and Practice   */
+/* Kenneth C. Louden                                */
+/****************************************************/
+
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include "globals.h"
+#include "util.h"
+#include "symfile.h"
+
+/* FNV-1a, fixed so that files stay readable
+ * by later compilers
+ */
+static unsigned int hashName(char * name)
+{
+    unsigned int h = 2166136261u;
+    while (*name != '\0')
+        h = (h ^ (unsigned char)*name++) * 16777619u;
+    return h;
+}
+
+static int isExported(TreeNode * t)
+{
+    return t->bind.storage == GlobalK || t->bind.storage == FuncK ||
+        t->bind.storage == StaticFuncK;
+}
+
+/* Function sf_write writes the global variables
+ * and functions of a compiled program to a symbol
+ * file. It returns FALSE if the file cannot be
+ * written
+ */
+int sf_write(char * filename, TreeNode * syntaxTree)
+{
+    SymFileHeader h;
+    SymRec * recs;
+    ParamRec * params;
+    int * buckets;
+    char * strings;
+    int nParams = 0, nStrings = 0, n = 0, ok;
+    int dataEnd = sf_dataEnd();
+    FILE * f;
+    for (TreeNode * t = syntaxTree; t != NULL; t = t->sibling){
+        if (!isExported(t))
+            continue;
+        /* the module's data ends after its last
+         * global or static frame
+         */
+        if (t->bind.storage == GlobalK){
+            int width = (t->kind.exp == ArrayDeclK) ? t->size : 1;
+            if (dataEnd < t->bind.offset + width)
+                dataEnd = t->bind.offset + width;
+        }
+        else if (t->bind.storage == StaticFuncK && dataEnd < t->bind.frame + 1)
+            dataEnd = t->bind.frame + 1;
+        n++;
+        nStrings += strlen(t->attr.name) + 1;
+        if (t->kind.exp == FuncDeclK)
+            for (TreeNode * p = t->child[0]; p != NULL; p = p->sibling)
+                nParams++;
+    }
+    h.magic = SYMFILE_MAGIC;
+    h.version = SYMFILE_VERSION;
+    h.dataEnd = dataEnd;
+    h.nSymbols = n;
+    h.nBuckets = 2 * n + 1;
+    h.buckets = sizeof(SymFileHeader);
+    h.records = h.buckets + h.nBuckets * sizeof(int);
+    h.params = h.records + n * sizeof(SymRec);
+    h.strings = h.params + nParams * sizeof(ParamRec);
+    h.fileSize = h.strings + nStrings;
+    buckets = (int *)malloc(h.nBuckets * sizeof(int));
+    recs = (SymRec *)calloc(n + 1, sizeof(SymRec));
+    params = (ParamRec *)calloc(nParams + 1, sizeof(ParamRec));
+    strings = (char *)malloc(nStrings + 1);
+    if (buckets == NULL || recs == NULL || params == NULL || strings == NULL){
+        fprintf(listing, "Out of memory error at line %d\n", lineno);
+        exit(-1);
+    }
+    for (int i = 0; i < h.nBuckets; i++)
+        buckets[i] = -1;
+    n = nParams = nStrings = 0;
+    for (TreeNode * t = syntaxTree; t != NULL; t = t->sibling){
+        SymRec * r = &recs[n];
+        int b;
+        if (!isExported(t))
+            continue;
+        r->name = nStrings;
+        strcpy(strings + nStrings, t->attr.name);
+        nStrings += strlen(t->attr.name) + 1;
+        r->kind = t->kind.exp;
+        r->type = t->type;
+        r->size = t->size;
+        r->bind = t->bind;
+        r->firstParam = nParams;
+        if (t->kind.exp == FuncDeclK)
+            for (TreeNode * p = t->child[0]; p != NULL; p = p->sibling){
+                params[nParams].kind = p->kind.exp;
+                params[nParams].type = p->type;
+                nParams++;
+            }
+        r->nParams = nParams - r->firstParam;
+        b = hashName(t->attr.name) % h.nBuckets;
+        r->next = buckets[b];
+        buckets[b] = n++;
+    }
+    f = fopen(filename, "wb");
+    ok = (f != NULL);
+    if (ok){
+        ok = fwrite(&h, sizeof(h), 1, f) == 1 &&
+            fwrite(buckets, sizeof(int), h.nBuckets, f) == (size_t)h.nBuckets &&
+            fwrite(recs, sizeof(SymRec), n, f) == (size_t)n &&
+            fwrite(params, sizeof(ParamRec), nParams, f) == (size_t)nParams &&
+            fwrite(strings, 1, nStrings, f) == (size_t)nStrings;
+        ok = (fclose(f) == 0) && ok;
+    }
+    free(buckets);
+    free(recs);
+    free(params);
+    free(strings);
+    return ok;
+}
+
+/* an open symbol file; decls holds the
+ * declarations built so far, by record
+ */
+typedef struct
+{
+    char * base;
+    SymFileHeader * header;
+    TreeNode ** decls;
+} SymFile;
+
+#define MAXSYMFILES 16
+
+static SymFile files[MAXSYMFILES];
+static int nFiles = 0;
+
+/* Function valid checks that the parts of a
+ * mapped file lie inside it
+ */
+static int valid(SymFileHeader * h, int size)
+{
+    long end = h->strings;
+    return size >= (int)sizeof(SymFileHeader) &&
+        h->magic == SYMFILE_MAGIC && h->version == SYMFILE_VERSION &&
+        h->fileSize == size && h->nSymbols >= 0 && h->nBuckets > 0 &&
+        h->buckets == sizeof(SymFileHeader) &&
+        h->records == h->buckets + h->nBuckets * (long)sizeof(int) &&
+        h->params == h->records + h->nSymbols * (long)sizeof(SymRec) &&
+        h->params <= end && end <= size;
+}
+
+/* Function validRecords checks that every bucket
+ * and record of a file whose parts are valid
+ * refers inside it: names are in the string table
+ * and ended there, parameters are in the parameter
+ * records, and each bucket chain only goes to
+ * earlier records, as sf_write writes them, so it
+ * ends
+ */
+static int validRecords(char * base, SymFileHeader * h)
+{
+    int * buckets = (int *)(base + h->buckets);
+    SymRec * recs = (SymRec *)(base + h->records);
+    ParamRec * params = (ParamRec *)(base + h->params);
+    char * strings = base + h->strings;
+    int nStrings = h->fileSize - h->strings;
+    int nParams;
+    if ((h->strings - h->params) % sizeof(ParamRec) != 0)
+        return FALSE;
+    nParams = (h->strings - h->params) / sizeof(ParamRec);
+    for (int b = 0; b < h->nBuckets; b++)
+        if (buckets[b] < -1 || buckets[b] >= h->nSymbols)
+            return FALSE;
+    for (int i = 0; i < nParams; i++)
+        if (params[i].kind != VarDeclK && params[i].kind != ArrayDeclK)
+            return FALSE;
+    for (int i = 0; i < h->nSymbols; i++){
+        SymRec * r = &recs[i];
+        if (r->kind != VarDeclK && r->kind != ArrayDeclK && r->kind != FuncDeclK)
+            return FALSE;
+        if (r->name < 0 || r->name >= nStrings ||
+            memchr(strings + r->name, '\0', nStrings - r->name) == NULL)
+            return FALSE;
+        if (r->nParams < 0 || r->firstParam < 0 || r->firstParam > nParams ||
+            r->nParams > nParams - r->firstParam)
+            return FALSE;
+        if (r->next < -1 || r->next >= i)
+            return FALSE;
+    }
+    return TRUE;
+}
+
+/* Function sf_open maps a symbol file so its names
+ * can be imported. It returns FALSE if the file
+ * cannot be read or is not a symbol file, or if
+ * any of its records refers outside it
+ */
+int sf_open(char * filename)
+{
+    struct stat st;
+    char * base;
+    int fd;
+    if (nFiles == MAXSYMFILES)
+        return FALSE;
+    fd = open(filename, O_RDONLY);
+    if (fd < 0)
+        return FALSE;
+    if (fstat(fd, &st) != 0 || st.st_size < (off_t)sizeof(SymFileHeader)){
+        close(fd);
+        return FALSE;
+    }
+    base = (char *)mmap(NULL, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (base == MAP_FAILED)
+        return FALSE;
+    if (!valid((SymFileHeader *)base, (int)st.st_size) ||
+        !validRecords(base, (SymFileHeader *)base)){
+        munmap(base, st.st_size);
+        return FALSE;
+    }
+    files[nFiles].base = base;
+    files[nFiles].header = (SymFileHeader *)base;
+    files[nFiles].decls = NULL;
+    nFiles++;
+    return TRUE;
+}
+
+/* Function declOf builds the declaration of
+ * record i of file f
+ */
+static TreeNode * declOf(SymFile * f, int i)
+{
+    SymFileHeader * h = f->header;
+    SymRec * r = (SymRec *)(f->base + h->records) + i;
+    ParamRec * p = (ParamRec *)(f->base + h->params) + r->firstParam;
+    TreeNode * t, * last = NULL;
+    if (f->decls == NULL){
+        f->decls = (TreeNode **)calloc(h->nSymbols, sizeof(TreeNode *));
+        if (f->decls == NULL){
+            fprintf(listing, "Out of memory error at line %d\n", lineno);
+            exit(-1);
+        }
+    }
+    if (f->decls[i] != NULL)
+        return f->decls[i];
+    t = newExpNode((ExpKind)r->kind);
+    t->attr.name = copyString(f->base + h->strings + r->name);
+    t->type = (ExpType)r->type;
+    t->size = r->size;
+    t->bind = r->bind;
+    /* imported declarations have no line */
+    t->lineno = 0;
+    for (int k = 0; k < r->nParams; k++){
+        TreeNode * q = newExpNode((ExpKind)p[k].kind);
+        q->attr.name = copyString("");
+        q->type = (ExpType)p[k].type;
+        q->isParam = TRUE;
+        q->lineno = 0;
+        if (last == NULL)
+            t->child[0] = q;
+        else
+            last->sibling = q;
+        last = q;
+    }
+    f->decls[i] = t;
+    return t;
+}
+
+/* Function sf_lookup returns the declaration of a
+ * name exported by one of the open symbol files,
+ * or NULL. The declaration is built from the
+ * mapped record the first time it is asked for
+ */
+TreeNode * sf_lookup(char * name)
+{
+    unsigned int hash = hashName(name);
+    for (int k = 0; k < nFiles; k++){
+        SymFile * f = &files[k];
+        SymFileHeader * h = f->header;
+        int * buckets = (int *)(f->base + h->buckets);
+        SymRec * recs = (SymRec *)(f->base + h->records);
+        int i = buckets[hash % h->nBuckets];
+        while (i >= 0 && i < h->nSymbols){
+            if (strcmp(f->base + h->strings + recs[i].name, name) == 0)
+                return declOf(f, i);
+            i = recs[i].next;
+        }
+    }
+    return NULL;
+}
+
+/* Function sf_dataEnd returns the end of the
+ * global data of the imported modules
+ */
+int sf_dataEnd(void)
+{
+    int end = 0;
+    for (int k = 0; k < nFiles; k++)
+        if (end < files[k].header->dataEnd)
+            end = files[k].header->dataEnd;
+    return end;
+}
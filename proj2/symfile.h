@@ -0,0 +1,80 @@
+/****************************************************/
+/* File: symfile.h                                  */
+/* Symbol files of the C-MINUS compiler: the file   */
+/* scope of a compiled module, written after        */
+/* analysis and mapped into later compilations      */
+/* Compiler Construction: Principles and Practice   */
+/* Kenneth C. Louden                                */
+/****************************************************/
+
+#ifndef _SYMFILE_H_
+#define _SYMFILE_H_
+
+/* SYMFILE_MAGIC and SYMFILE_VERSION identify the
+ * format. Every field of a symbol file is an int
+ * and every reference an offset from the start of
+ * the file, so the file is used where it is mapped
+ */
+#define SYMFILE_MAGIC 0x594d5343 /* "CSMY" */
+#define SYMFILE_VERSION 1
+
+typedef struct
+{
+    int magic;
+    int version;
+    int fileSize;
+    int dataEnd; /* global data used by the module */
+    int nSymbols;
+    int nBuckets;
+    int buckets; /* int[nBuckets], first record or -1 */
+    int records; /* SymRec[nSymbols] */
+    int params; /* ParamRec[] */
+    int strings; /* names, each ended by '\0' */
+} SymFileHeader;
+
+/* the record of a global variable or function */
+typedef struct
+{
+    int name; /* offset in the string table */
+    int next; /* next record in the bucket, or -1 */
+    int kind; /* VarDeclK, ArrayDeclK or FuncDeclK */
+    int type;
+    int size;
+    Binding bind;
+    int nParams;
+    int firstParam; /* index in the parameter records */
+} SymRec;
+
+typedef struct
+{
+    int kind;
+    int type;
+} ParamRec;
+
+/* Function sf_write writes the global variables
+ * and functions of a compiled program to a symbol
+ * file. It returns FALSE if the file cannot be
+ * written
+ */
+int sf_write(char * filename, TreeNode * syntaxTree);
+
+/* Function sf_open maps a symbol file so its names
+ * can be imported. It returns FALSE if the file
+ * cannot be read or is not a symbol file, or if
+ * any of its records refers outside it
+ */
+int sf_open(char * filename);
+
+/* Function sf_lookup returns the declaration of a
+ * name exported by one of the open symbol files,
+ * or NULL. The declaration is built from the
+ * mapped record the first time it is asked for
+ */
+TreeNode * sf_lookup(char * name);
+
+/* Function sf_dataEnd returns the end of the
+ * global data of the imported modules
+ */
+int sf_dataEnd(void);
+
+#endif
@@ -0,0 +1,242 @@
+/****************************************************/
+/* File: symtab.c                                   */
+/* Symbol table implementation for the C-MINUS      */
+/* compiler                                         */
+/* Each scope is implemented as a chained hash      */
+/* table linked to its enclosing scope              */
+/* Compiler Construction: Principles and Practice   */
+/* Kenneth C. Louden                                */
+/****************************************************/
+
+#include "globals.h"
+#include "symtab.h"
+
+/* SHIFT is the power of two used as multiplier
+   in hash function  */
+#define SHIFT 4
+
+/* the hash function */
+static int hash(char * key, int size)
+{
+    int temp = 0;
+    int i = 0;
+    while (key[i] != '\0'){
+        temp = ((temp << SHIFT) + key[i]) % size;
+        ++i;
+    }
+    return temp;
+}
+
+/* innermost scope; the stack is the parent chain */
+static Scope top = NULL;
+
+/* scopes printed by printSymTab, in creation order */
+static Scope * scopeList = NULL;
+static int nScopes = 0;
+static int maxScopes = 0;
+
+Scope sc_new(char * name, Scope parent)
+{
+    Scope s = (Scope)malloc(sizeof(struct ScopeListRec));
+    if (s != NULL){
+        s->size = (parent == NULL) ? GLOBAL_SIZE : SIZE;
+        s->hashTable = (BucketList *)calloc(s->size, sizeof(BucketList));
+    }
+    if (s == NULL || s->hashTable == NULL){
+        fprintf(listing, "Out of memory error at line %d\n", lineno);
+        exit(-1);
+    }
+    s->name = name;
+    s->parent = parent;
+    s->nestedLevel = (parent == NULL) ? 0 : parent->nestedLevel + 1;
+    return s;
+}
+
+void sc_free(Scope scope)
+{
+    if (scope == NULL)
+        return;
+    sc_empty(scope);
+    free(scope->hashTable);
+    free(scope);
+}
+
+void sc_empty(Scope scope)
+{
+    for (int i = 0; i < scope->size; i++){
+        BucketList l = scope->hashTable[i];
+        scope->hashTable[i] = NULL;
+        while (l != NULL){
+            BucketList next = l->next;
+            LineList t = l->lines;
+            while (t != NULL){
+                LineList tn = t->next;
+                free(t);
+                t = tn;
+            }
+            free(l);
+            l = next;
+        }
+    }
+}
+
+void sc_push(Scope scope)
+{
+    top = scope;
+}
+
+void sc_pop(void)
+{
+    if (top != NULL)
+        top = top->parent;
+}
+
+Scope sc_top(void)
+{
+    return top;
+}
+
+void sc_list(Scope scope)
+{
+    if (nScopes == maxScopes){
+        maxScopes = (maxScopes == 0) ? 64 : maxScopes * 2;
+        scopeList = (Scope *)realloc(scopeList, maxScopes * sizeof(Scope));
+        if (scopeList == NULL){
+            fprintf(listing, "Out of memory error at line %d\n", lineno);
+            exit(-1);
+        }
+    }
+    scopeList[nScopes++] = scope;
+}
+
+void sc_clear(void)
+{
+    nScopes = 0;
+    top = NULL;
+}
+
+void sc_shift_lines(Scope scope, int delta)
+{
+    for (int i = 0; i < scope->size; i++){
+        for (BucketList l = scope->hashTable[i]; l != NULL; l = l->next){
+            for (LineList t = l->lines; t != NULL; t = t->next)
+                t->lineno += delta;
+        }
+    }
+}
+
+void sc_relocate(Scope scope)
+{
+    for (int i = 0; i < scope->size; i++){
+        for (BucketList l = scope->hashTable[i]; l != NULL; l = l->next){
+            StorageKind k = l->node->bind.storage;
+            if (k == LocalK || k == ParamK)
+                l->memloc = -l->node->bind.offset;
+        }
+    }
+}
+
+/* Procedure st_insert inserts an identifier
+ * declared by node into the innermost scope
+ * loc = memory location is inserted only the
+ * first time, later calls add the line number
+ */
+void st_insert(char * name, int lineno, int loc, TreeNode * node)
+{
+    int h = hash(name, top->size);
+    BucketList l = top->hashTable[h];
+    while ((l != NULL) && (strcmp(name, l->name) != 0))
+        l = l->next;
+    if (l == NULL){ /* variable not yet in table */
+        l = (BucketList)malloc(sizeof(struct BucketListRec));
+        l->name = name;
+        l->lines = (LineList)malloc(sizeof(struct LineListRec));
+        l->lines->lineno = lineno;
+        l->lines->next = NULL;
+        l->lastLine = l->lines;
+        l->memloc = loc;
+        l->node = node;
+        l->scope = top;
+        l->next = top->hashTable[h];
+        top->hashTable[h] = l;
+    }
+    else /* found in table, so just add line number */
+        st_add_lineno(l, lineno);
+} /* st_insert */
+
+static BucketList lookupIn(Scope s, char * name)
+{
+    BucketList l = s->hashTable[hash(name, s->size)];
+    while ((l != NULL) && (strcmp(name, l->name) != 0))
+        l = l->next;
+    return l;
+}
+
+BucketList st_lookup(char * name)
+{
+    for (Scope s = top; s != NULL; s = s->parent){
+        BucketList l = lookupIn(s, name);
+        if (l != NULL)
+            return l;
+    }
+    return NULL;
+}
+
+BucketList st_lookup_top(char * name)
+{
+    if (top == NULL)
+        return NULL;
+    return lookupIn(top, name);
+}
+
+void st_add_lineno(BucketList l, int lineno)
+{
+    LineList t = (LineList)malloc(sizeof(struct LineListRec));
+    t->lineno = lineno;
+    t->next = NULL;
+    l->lastLine->next = t;
+    l->lastLine = t;
+}
+
+static char * kindName(TreeNode * node)
+{
+    if (node == NULL)
+        return "";
+    switch (node->kind.exp){
+        case FuncDeclK:
+            return "Function";
+        case ArrayDeclK:
+            return node->isParam ? "Array Param" : "Array";
+        default:
+            return node->isParam ? "Param" : "Variable";
+    }
+}
+
+/* Procedure printSymTab prints a formatted
+ * listing of the symbol table contents
+ * to the listing file
+ */
+void printSymTab(FILE * listing)
+{
+    for (int k = 0; k < nScopes; k++){
+        Scope s = scopeList[k];
+        fprintf(listing, "\nScope: %s (nested level %d)\n", s->name, s->nestedLevel);
+        fprintf(listing, "Name           Kind         Location   Line Numbers\n");
+        fprintf(listing, "-------------  -----------  --------   ------------\n");
+        for (int i = 0; i < s->size; ++i){
+            BucketList l = s->hashTable[i];
+            while (l != NULL){
+                LineList t = l->lines;
+                fprintf(listing, "%-14s ", l->name);
+                fprintf(listing, "%-12s ", kindName(l->node));
+                fprintf(listing, "%-8d  ", l->memloc);
+                while (t != NULL){
+                    fprintf(listing, "%4d ", t->lineno);
+                    t = t->next;
+                }
+                fprintf(listing, "\n");
+                l = l->next;
+            }
+        }
+    }
+} /* printSymTab */
@@ -0,0 +1,136 @@
+/****************************************************/
+/* File: symtab.h                                   */
+/* Symbol table interface for the C-MINUS compiler  */
+/* (one hash table per scope, scopes are nested)    */
+/* Compiler Construction: Principles and Practice   */
+/* Kenneth C. Louden                                */
+/****************************************************/
+
+#ifndef _SYMTAB_H_
+#define _SYMTAB_H_
+
+/* SIZE is the size of the hash table of a
+ * function or block scope, which holds only a
+ * few names, GLOBAL_SIZE that of the file
+ * scope, which holds every function
+ */
+#define SIZE 61
+#define GLOBAL_SIZE 8191
+
+/* Activation record layout. A local or parameter
+ * with memory location k lives at address fp-k,
+ * a global with memory location k at gp+k
+ */
+#define OFP_SLOT 0 /* caller's frame pointer */
+#define RET_SLOT 1 /* return address */
+#define FRAME_HEADER 2 /* first slot for parameters */
+
+/* the list of line numbers of the source
+ * code in which a variable is referenced
+ */
+typedef struct LineListRec
+{
+    int lineno;
+    struct LineListRec * next;
+} * LineList;
+
+/* The record in the bucket lists for
+ * each identifier, including name,
+ * declaring node, assigned memory location,
+ * and the list of line numbers in which
+ * it appears in the source code
+ */
+typedef struct BucketListRec
+{
+    char * name;
+    LineList lines;
+    LineList lastLine; /* end of lines, for appending */
+    TreeNode * node; /* declaration of the identifier */
+    int memloc; /* memory location for variable */
+    struct ScopeListRec * scope; /* scope holding the record */
+    struct BucketListRec * next;
+} * BucketList;
+
+/* A scope is a hash table of its own
+ * declarations chained to the enclosing scope
+ */
+typedef struct ScopeListRec
+{
+    char * name; /* owning function, "global" for file scope */
+    BucketList * hashTable;
+    int size; /* number of buckets in hashTable */
+    int nestedLevel;
+    struct ScopeListRec * parent;
+} * Scope;
+
+/* Function sc_new allocates an empty scope
+ * nested inside parent (NULL for file scope)
+ */
+Scope sc_new(char * name, Scope parent);
+
+/* Procedure sc_free releases a scope and its
+ * records; names are owned by the syntax tree
+ */
+void sc_free(Scope scope);
+
+/* Procedure sc_empty releases the records of a
+ * scope but keeps the scope for reuse
+ */
+void sc_empty(Scope scope);
+
+/* Procedures sc_push and sc_pop enter and leave
+ * a scope; insertions go to the innermost scope
+ */
+void sc_push(Scope scope);
+void sc_pop(void);
+
+/* Function sc_top returns the innermost scope */
+Scope sc_top(void);
+
+/* Procedure sc_list adds a scope to those printed
+ * by printSymTab, sc_clear empties that list
+ * and the scope stack
+ */
+void sc_list(Scope scope);
+void sc_clear(void);
+
+/* Procedure sc_shift_lines moves every line number
+ * recorded in scope by delta
+ */
+void sc_shift_lines(Scope scope, int delta);
+
+/* Procedure sc_relocate sets the memory location
+ * of every frame variable in scope from the
+ * binding of its declaration
+ */
+void sc_relocate(Scope scope);
+
+/* Procedure st_insert inserts an identifier
+ * declared by node into the innermost scope
+ * loc = memory location is inserted only the
+ * first time, later calls add the line number
+ */
+void st_insert(char * name, int lineno, int loc, TreeNode * node);
+
+/* Function st_lookup returns the record of the
+ * innermost visible declaration or NULL
+ */
+BucketList st_lookup(char * name);
+
+/* Function st_lookup_top returns the record of a
+ * declaration in the innermost scope only
+ */
+BucketList st_lookup_top(char * name);
+
+/* Procedure st_add_lineno records another
+ * reference to an identifier
+ */
+void st_add_lineno(BucketList l, int lineno);
+
+/* Procedure printSymTab prints a formatted
+ * listing of the symbol table contents
+ * to the listing file
+ */
+void printSymTab(FILE * listing);
+
+#endif
@@ -0,0 +1,68 @@
+#!/bin/sh
+#####################################################
+# File: check.sh                                    #
+# Runs the sample programs of the tests directory   #
+# Each NAME.c is compiled at -O0, -O1 and -O2, with #
+# the flags in NAME.flags if there is one, and once #
+# more at -O2 with the profile of its -O0 run, and  #
+# run on the TM with the input in NAME.in; what the #
+# OUT instructions print must match NAME.out        #
+# usage: check.sh compiler tm                       #
+#####################################################
+
+if [ $# -ne 2 ]; then
+    echo "usage: $0 compiler tm"
+    exit 2
+fi
+dir=$(cd "$(dirname "$0")" && pwd)
+cc=$(cd "$(dirname "$1")" && pwd)/$(basename "$1")
+tm=$(cd "$(dirname "$2")" && pwd)/$(basename "$2")
+work=$(mktemp -d)
+trap 'rm -rf "$work"' EXIT
+failed=0
+total=0
+
+# run NAME [profile]: runs NAME.tm on the input of
+# the test, printing what OUT prints
+run()
+{
+    { echo g; [ -f "$dir/$1.in" ] && cat "$dir/$1.in"; echo q; } |
+        "$tm" ${2:+-p "$2"} "$1.tm" 2>&1 |
+        grep -o 'OUT instruction prints: -*[0-9]*'
+}
+
+# check NAME LABEL FLAGS...: compiles and runs a
+# test, comparing its output with NAME.out
+check()
+{
+    name=$1
+    label=$2
+    shift 2
+    total=$((total + 1))
+    rm -f "$name.tm"
+    "$cc" "$@" "$name.c" >/dev/null 2>&1
+    if [ ! -f "$name.tm" ]; then
+        echo "FAIL $name $label: not compiled"
+        failed=$((failed + 1))
+    elif ! run "$name" | cmp -s - "$dir/$name.out"; then
+        echo "FAIL $name $label"
+        run "$name" | diff "$dir/$name.out" - | sed 's/^/    /'
+        failed=$((failed + 1))
+    fi
+}
+
+cd "$work" || exit 2
+for src in "$dir"/*.c; do
+    name=$(basename "$src" .c)
+    flags=
+    [ -f "$dir/$name.flags" ] && flags=$(cat "$dir/$name.flags")
+    cp "$src" "$name.c"
+    for level in -O0 -O1 -O2; do
+        check "$name" "$level $flags" $level $flags
+    done
+    rm -f "$name.prof"
+    "$cc" -O0 $flags "$name.c" >/dev/null 2>&1 && run "$name" "$name.prof" >/dev/null
+    check "$name" "-O2 $flags -p" -O2 $flags -p "$name.prof"
+done
+echo "$((total - failed)) of $total runs passed"
+[ $failed -eq 0 ]
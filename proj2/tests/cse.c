@@ -0,0 +1,31 @@
+/* common subexpressions in straight-line code */
+int g;
+int a[10];
+
+int f(int x)
+{
+    g = g + x;
+    return g;
+}
+
+void main(void)
+{
+    int b[10]; int i; int x; int y;
+    i = input();
+    x = 0;
+    while (x < 10) { a[x] = x * x; b[x] = x + 1; x = x + 1; }
+    a[i + 1] = a[i + 1] + b[i + 1];
+    output(a[i + 1]);
+    x = a[i] * a[i] + (i * 3 + 1) * (i * 3 + 1);
+    output(x);
+    /* the call changes g between the two sums */
+    g = 2;
+    y = (g + i) + f(1) + (g + i);
+    output(y);
+    if (i * 3 > 2) { output(i * 3 + 4); x = i; output(i * 3 + 4); } else output(i * 3);
+    output(i * 3);
+    /* a store to a may change a[i] */
+    x = a[i] + 1;
+    a[x - 21] = 50;
+    output(a[i] + 1);
+}
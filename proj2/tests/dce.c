@@ -0,0 +1,35 @@
+/* unreachable statements and dead stores */
+int g;
+
+int f(int x)
+{
+    int y; int z;
+    y = x * 2;
+    z = y + 1;
+    y = 5;
+    if (x > 3) return y; else { z = 7; return x; }
+    output(99);
+    x = 3;
+}
+
+int h(int n)
+{
+    int t; int u;
+    t = 0; u = 0;
+    while (n > 0) { t = t + n; u = g = n; n = n - 1; }
+    /* the value is dead, the call is not */
+    u = f(t);
+    return t;
+}
+
+void main(void)
+{
+    int a;
+    a = input();
+    output(f(a));
+    output(f(a - 3));
+    output(h(a));
+    output(g);
+    while (1) { output(a); return; }
+    output(a);
+}
@@ -0,0 +1,23 @@
+/* functions and globals main cannot reach */
+int unused[100];
+int count;
+int table[5];
+
+int helper(int x) { return x * 2; }
+
+int deadA(int x) { unused[x] = x; return helper(x); }
+
+int deadB(int y) { return deadA(y) + deadB(y - 1); }
+
+void bump(void) { count = count + 1; }
+
+void main(void)
+{
+    int i; int n;
+    n = input();
+    i = 0;
+    while (i < n) { table[i] = helper(i); bump(); i = i + 1; }
+    /* the globals moved down over unused */
+    output(table[n - 1]);
+    output(count);
+}
@@ -0,0 +1,24 @@
+/* constant folding and algebraic identities */
+int g[4];
+
+int f(int x)
+{
+    output(x);
+    return x;
+}
+
+void main(void)
+{
+    int x; int y;
+    x = input();
+    y = 2 * 3 + x * 1;
+    output(y);
+    output(x - x + 0 * x);
+    /* the call is kept for its output */
+    output(f(x) * 0);
+    if (1 < 2) output(7); else output(8);
+    while (0) output(9);
+    if (x == x) { g[1 + 2] = 3 * 4; output(g[3]); }
+    output((x + 0) * 1 - 0 + (8 - 2 * 3) * x);
+    output(100 / 7 - 100 / 7 * 7 + (0 - 9) / 2);
+}
@@ -0,0 +1,31 @@
+/* fill, iota and copy loops run as block memory ops */
+int arr[300];
+int z[50];
+
+void cp(int d[], int s[], int n)
+{
+    int i;
+    i = 0;
+    while (i < n) { d[i] = s[i]; i = i + 1; }
+}
+
+void main(void)
+{
+    int b[50]; int i; int v; int n;
+    n = input();
+    v = input();
+    i = 0;
+    while (i < 300) { arr[i] = i; i = i + 1; }
+    i = 3;
+    while (i < n) { z[i] = v; b[i] = i - 2; i = i + 1; }
+    output(i);
+    i = 0;
+    while (i <= 9) { z[i] = 0; i = i + 1; }
+    /* overlapping copies are left to the loop */
+    cp(b, arr, 12);
+    cp(arr, arr, 5);
+    i = 0;
+    while (i < 20) { b[i] = 7 + i; arr[i] = b[i]; i = i + 1; }
+    i = 0;
+    while (i < 50) { output(arr[i * 5] + z[i] * 1000 + b[i] * 100000); i = i + 1; }
+}
@@ -0,0 +1,58 @@
+#!/bin/sh
+#####################################################
+# File: import.sh                                   #
+# Compiles import/lib.c with -s and the programs    #
+# that import its symbol file with -i: use.c must   #
+# run and print import/use.out, call.c must be      #
+# refused for calling an imported function, and a   #
+# damaged symbol file must not be imported          #
+# usage: import.sh compiler tm                      #
+#####################################################
+
+if [ $# -ne 2 ]; then
+    echo "usage: $0 compiler tm"
+    exit 2
+fi
+dir=$(cd "$(dirname "$0")/import" && pwd)
+cc=$(cd "$(dirname "$1")" && pwd)/$(basename "$1")
+tm=$(cd "$(dirname "$2")" && pwd)/$(basename "$2")
+work=$(mktemp -d)
+trap 'rm -rf "$work"' EXIT
+cd "$work" || exit 2
+cp "$dir"/*.c .
+failed=0
+
+"$cc" -s lib.c >/dev/null 2>&1
+if [ ! -f lib.sym ]; then
+    echo "FAIL import: lib.sym not written"
+    exit 1
+fi
+
+"$cc" -i lib.sym use.c >/dev/null 2>&1
+if [ ! -f use.tm ]; then
+    echo "FAIL import use: not compiled"
+    failed=$((failed + 1))
+elif ! printf 'g\nq\n' | "$tm" use.tm 2>&1 |
+        grep -o 'OUT instruction prints: -*[0-9]*' | cmp -s - "$dir/use.out"; then
+    echo "FAIL import use"
+    failed=$((failed + 1))
+fi
+
+"$cc" -i lib.sym call.c >/dev/null 2>&1
+if [ -f call.tm ] ||
+        ! grep -q 'imported function cannot be called: twice' call_20181623.txt; then
+    echo "FAIL import call: not refused"
+    failed=$((failed + 1))
+fi
+
+# the string table loses its last '\0'
+head -c $(($(wc -c <lib.sym) - 1)) lib.sym >bad.sym
+printf x >>bad.sym
+rm -f use.tm
+if "$cc" -i bad.sym use.c >/dev/null 2>&1 || [ -f use.tm ]; then
+    echo "FAIL import bad.sym: imported"
+    failed=$((failed + 1))
+fi
+
+[ $failed -eq 0 ] && echo "import: 3 checks passed"
+[ $failed -eq 0 ]
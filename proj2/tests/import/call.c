@@ -0,0 +1,2 @@
+/* calls a function of lib.sym, whose code is not in this program */
+void main(void) { output(twice(3)); }
@@ -0,0 +1,3 @@
+/* a library: compiled with -s into lib.sym */
+int g;
+int twice(int a) { return a * 2; }
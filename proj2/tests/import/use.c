@@ -0,0 +1,3 @@
+/* uses the global of lib.sym; its own globals follow */
+int h;
+void main(void) { g = 3; h = 4; output(g + h); output(h - g); }
@@ -0,0 +1,62 @@
+/* small functions inlined at their call sites */
+int g;
+int v[10];
+int max(int a, int b)
+{
+    if (a > b) return a;
+    return b;
+}
+int get(int a[], int i) { return a[i]; }
+void put(int a[], int i, int x) { a[i] = x; }
+int bump(int d) { g = g + d; return g; }
+void report(int x)
+{
+    if (x < 0) { output(0 - x); return; }
+    output(x);
+}
+int sumsq(int n)
+{
+    int t[3]; int s;
+    t[0] = n; t[1] = n + 1; t[2] = n + 2;
+    s = t[0] * t[0] + t[1] * t[1] + t[2] * t[2];
+    return s;
+}
+int find(int a[], int n, int x)
+{
+    int i;
+    i = 0;
+    while (i < n) { if (a[i] == x) return i; i = i + 1; }
+    return 0 - 1;
+}
+int fact(int n) { if (n < 2) return 1; return n * fact(n - 1); }
+int clamp(int x, int lo, int hi)
+{
+    if (x < lo) x = lo;
+    else if (x > hi) x = hi;
+    return x;
+}
+void main(void)
+{
+    int i; int m; int a; int b;
+    a = input(); b = input();
+    output(max(a, b));
+    output(max(max(a, 3), max(b, 4)));
+    i = 0;
+    while (i < 10) { put(v, i, i * 3); i = i + 1; }
+    m = 0;
+    i = 0;
+    while (i < 10) { m = max(m, get(v, i)); i = i + 1; }
+    output(m);
+    g = 5;
+    output(g + bump(2));
+    output(bump(1) + g);
+    report(0 - 7);
+    report(9);
+    output(sumsq(2));
+    output(find(v, 10, 12));
+    output(find(v, 10, 13));
+    output(fact(5));
+    if (max(a, b) > 5) output(1); else output(2);
+    output(clamp(a, 0, 4));
+    output(clamp(b, 0, 4) + clamp(0 - b, 0 - 1, 4));
+}
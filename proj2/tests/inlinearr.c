@@ -0,0 +1,32 @@
+/* callees with a local array inlined into a loop */
+void f(void)
+{
+    int la[5];
+    la[0] = 0; la[1] = 1; la[2] = 2; la[3] = 3; la[4] = 4;
+}
+
+int h(int x)
+{
+    int la[5];
+    la[0] = x; la[1] = x + 1; la[2] = x + 2; la[3] = x + 3; la[4] = x + 4;
+    return la[0] + la[4];
+}
+
+void main(void)
+{
+    int i; int c; int a;
+    i = 0; c = 10; a = input();
+    while (i < a) {
+        f();
+        i = i + 1;
+    }
+    output(i);
+    output(c + a);
+    i = 0; c = 0;
+    while (i < a) {
+        c = c + h(i);
+        i = i + 1;
+    }
+    output(i);
+    output(c);
+}
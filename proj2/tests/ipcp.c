@@ -0,0 +1,53 @@
+/* constant arguments propagated into callees and clones */
+int g[20];
+
+int scale(int x, int mode, int k)
+{
+    int r;
+    r = x;
+    if (mode == 0) r = x * k;
+    else if (mode == 1) r = x + k;
+    else { while (k > 0) { r = r - 1; k = k - 1; } }
+    return r;
+}
+
+int fill(int v[], int n, int step)
+{
+    int i; int s;
+    i = 0; s = 0;
+    while (i < n) { v[i] = i * step; s = s + v[i]; i = i + 1; }
+    step = step + 1;
+    return s + step;
+}
+
+int power(int b, int e)
+{
+    if (e == 0) return 1;
+    return b * power(b, e - 1);
+}
+
+/* the last of 32 parameters is always 1 */
+int wide(int pa, int pb, int pc, int pd, int pe, int pf, int pg, int ph,
+         int pi, int pj, int pk, int pl, int pm, int pn, int po, int pp,
+         int pq, int pr, int ps, int pt, int pu, int pv, int pw, int px,
+         int py, int pz, int qa, int qb, int qc, int qd, int qe, int qf)
+{
+    if (qf == 1) return pa + qe;
+    return pa - qe;
+}
+
+void main(void)
+{
+    int i; int t; int n;
+    n = input();
+    i = 0; t = 0;
+    while (i < n) { t = t + scale(i, 0, 3) + scale(i, 1, 5) + scale(i, 2, 2); i = i + 1; }
+    output(t);
+    output(fill(g, 20, 2));
+    output(fill(g, n, 2));
+    output(power(2, 10)); output(power(3, 4)); output(power(n, 3));
+    output(wide(n, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+                0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 7, 1));
+    output(wide(1, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+                0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, n, 1));
+}
@@ -0,0 +1,29 @@
+/* array indexing strength-reduced by induction variables */
+int g[12];
+
+void add(int a[], int b[], int n)
+{
+    int i;
+    i = n - 1;
+    while (i >= 0) {
+        a[i] = a[i] + b[i] * 2 + b[i + 1];
+        i = i - 1;
+    }
+}
+
+void main(void)
+{
+    int b[13]; int i; int s; int n;
+    n = input();
+    i = 0;
+    while (i < n + 1) { b[i] = i; if (i < n) g[i] = 100; i = i + 1; }
+    add(g, b, n);
+    i = 0; s = 0;
+    while (i < n) { s = s + g[i]; output(g[i]); i = i + 1; }
+    output(s);
+    /* a stride of three, read after the loop */
+    i = 1; s = 0;
+    while (i < n) { s = s + b[i] * i; i = i + 3; }
+    output(s);
+    output(i);
+}
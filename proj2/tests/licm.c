@@ -0,0 +1,38 @@
+/* loop-invariant operations hoisted out of loops */
+int scale;
+int a[20];
+
+void fill(int n)
+{
+    int i; int j;
+    i = 0;
+    while (i < n * 2) {
+        a[i] = i * scale + (n - 1) * scale;
+        j = 0;
+        while (j < n / 2 + 1) { a[i] = a[i] + scale * 3 + n * n; j = j + 1; }
+        i = i + 1;
+    }
+}
+
+int sum(int n)
+{
+    int i; int s;
+    i = 0; s = 0;
+    /* a[n] is read after the loop stores to a */
+    while (i < n * 2) { s = s + a[i] / 7 + n * 4; a[n] = a[n] + 1; i = i + 1; }
+    return s + a[n];
+}
+
+void main(void)
+{
+    int n; int k;
+    n = input();
+    scale = input();
+    fill(n);
+    output(a[0]); output(a[n * 2 - 1]);
+    output(sum(n));
+    /* the loop never runs: its invariants must not either */
+    k = 0;
+    while (k < n - 100) { output(scale / (n - 5)); k = k + 1; }
+    output(k);
+}
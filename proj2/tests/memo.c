@@ -0,0 +1,48 @@
+/* pure recursive functions memoized with -m */
+int g;
+int unused[8];
+
+int fib(int n)
+{
+    if (n < 2) return n;
+    return fib(n - 1) + fib(n - 2);
+}
+
+int paths(int r, int c)
+{
+    int s;
+    if (r == 0) return 1;
+    if (c == 0) return 1;
+    s = paths(r - 1, c);
+    r = r - 0;
+    c = c - 1;
+    return s + paths(r, c);
+}
+
+/* reads a global, so it is not memoized */
+int impureRec(int n)
+{
+    if (n < 1) return g;
+    return impureRec(n - 1) + 1;
+}
+
+int sq(int x) { return x * x; }
+
+int sumsq(int n)
+{
+    if (n == 0) return 0;
+    return sq(n) + sumsq(n - 1);
+}
+
+void main(void)
+{
+    int n;
+    n = input();
+    g = 5;
+    output(fib(n));
+    output(paths(n / 2, n / 2));
+    output(impureRec(3));
+    output(sumsq(n));
+    output(fib(n - 3));
+    output(fib(0 - 4));
+}
@@ -0,0 +1,70 @@
+/* code run at compile time up to the first input */
+int primes[100];
+int np;
+int table[10];
+
+int fact(int n)
+{
+    if (n < 2) return 1;
+    return n * fact(n - 1);
+}
+
+int gcd(int a, int b)
+{
+    if (b == 0) return a;
+    return gcd(b, a - a / b * b);
+}
+
+void sieve(int lim)
+{
+    int i; int j; int comp[200];
+    i = 2;
+    while (i < lim) { comp[i] = 0; i = i + 1; }
+    i = 2;
+    while (i < lim) {
+        if (comp[i] == 0) {
+            primes[np] = i; np = np + 1;
+            j = i * i;
+            while (j < lim) { comp[j] = 1; j = j + i; }
+        }
+        i = i + 1;
+    }
+}
+
+void fill(int a[], int n)
+{
+    int i;
+    i = 0;
+    while (i < n) { a[i] = i * i + 1; i = i + 1; }
+}
+
+/* never returns, and is never run at compile time */
+int spin(void)
+{
+    int x;
+    x = 0;
+    while (1) x = x + 1;
+    return x;
+}
+
+void main(void)
+{
+    int k; int s; int loc[20]; int u; int q;
+    sieve(200);
+    fill(loc, 20);
+    k = fact(10);
+    s = 0;
+    u = 0;
+    while (u < 20) { s = s + loc[u]; u = u + 1; }
+    table[3] = gcd(1071, 462);
+    /* what follows waits for input */
+    q = input();
+    output(np);
+    output(primes[q]);
+    output(k);
+    output(s);
+    output(loc[q]);
+    output(table[3]);
+    output(fact(5) + gcd(q, 12));
+    if (q > 100) output(spin());
+}
@@ -0,0 +1,19 @@
+/* code that runs past the compile-time budget */
+int g;
+
+int spin(int n)
+{
+    while (n < 400000) n = n + 1;
+    return n;
+}
+
+void main(void)
+{
+    int a; int b; int c[5];
+    g = 7;
+    a = g * 3;
+    c[0] = 4;
+    b = spin(1);
+    output(a + b + g + c[0]);
+    output(input() + c[0]);
+}
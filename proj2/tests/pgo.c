@@ -0,0 +1,27 @@
+/* branches and calls laid out by an execution profile */
+int f(int x) { return x * 2 + 1; }
+
+int g(int x)
+{
+    /* never taken in a profiled run */
+    if (x < 0) { output(x); output(x + 1); output(x + 2); }
+    return x;
+}
+
+void main(void)
+{
+    int i; int s; int n;
+    n = input();
+    s = 0; i = 0;
+    while (i < n) {
+        if (i == 57) s = s + f(i);
+        else s = s + 1;
+        s = s + g(i);
+        i = i + 1;
+    }
+    output(s);
+    /* a loop the profile never sees run */
+    i = 0;
+    while (i < n - 1000) { s = s + g(i - n); i = i + 1; }
+    output(s);
+}
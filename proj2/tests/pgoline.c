@@ -0,0 +1,14 @@
+/* a profile tells apart branches and calls sharing a line */
+int f(int x) { return x * 3 + 1; }
+
+void main(void)
+{
+    int i; int s; int t; int n;
+    n = input();
+    s = 0; t = 0; i = 0;
+    while (i < n) {
+        if (i < 0) t = t + f(i); if (i > 2) s = s + f(i); else s = s - f(t);
+        i = i + 1;
+    }
+    output(s); output(t);
+}
@@ -0,0 +1,40 @@
+/* loads forwarded from earlier stores and loads */
+int x;
+int y;
+int g[10];
+
+void bump(int a[], int k) { a[k] = a[k] + 100; x = x + 1; }
+
+int sum(int a[], int b[], int n)
+{
+    int i; int s;
+    i = 0; s = 0;
+    while (i < n) {
+        a[i] = a[i] + 1;
+        /* a and b may be the same array */
+        b[0] = 7;
+        s = s + a[i] + a[i] + b[0];
+        i = i + 1;
+    }
+    return s;
+}
+
+void main(void)
+{
+    int loc[10]; int i;
+    x = input();
+    x = x + 1; y = x * 2;
+    output(x + y);
+    g[2] = x; g[3] = y; loc[2] = 5;
+    output(g[2] + g[3] + loc[2] + g[2]);
+    bump(g, 2);
+    output(g[2] + x);
+    i = 0;
+    while (i < 10) { loc[i] = i; g[i] = i * i; i = i + 1; }
+    output(sum(g, g, 5));
+    output(sum(loc, g, 5));
+    output(g[0] + loc[0]);
+    i = input();
+    g[i] = 11; loc[i] = 12;
+    output(g[3] + loc[3] + g[i] + loc[i]);
+}
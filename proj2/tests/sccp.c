@@ -0,0 +1,34 @@
+/* constants propagated along the branches that can run */
+int g;
+
+int pick(int m, int x)
+{
+    if (m == 2) return x * 2;
+    return x;
+}
+
+int run(int n)
+{
+    int mode; int debug; int i; int s; int k;
+    mode = 1; debug = 0; i = 0; s = 0; k = 3;
+    while (i < n) {
+        if (mode == 1) s = s + i; else s = s - i;
+        /* never runs, so k stays 3 and debug 0 */
+        if (debug) { output(999); debug = 1; }
+        if (k != 3) k = k + 1;
+        i = i + 1;
+    }
+    output(k + debug);
+    return s;
+}
+
+void main(void)
+{
+    int mode;
+    g = input();
+    output(run(g));
+    mode = 1;
+    if (g > 0) mode = 2;
+    output(pick(mode, 5));
+    output(pick(mode - 1, 5));
+}
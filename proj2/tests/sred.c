@@ -0,0 +1,22 @@
+/* multiply and divide by constants as shifts and adds */
+int f(int x)
+{
+    return x * 8 + x / 2 + x * 10 + x / 16 + 3 * x + x * 7 + x / 1 + x * 1;
+}
+
+void main(void)
+{
+    int x; int a[4]; int i;
+    x = input();
+    while (x != 0) {
+        output(x * 2); output(x * 4); output(x * 5); output(x * 6); output(x * 12);
+        output(x * 31); output(x * 33); output(x * 1024); output(x * 7);
+        /* a negative quotient rounds toward zero */
+        output(x / 2); output(x / 4); output(x / 8); output(x / 1024); output(x / 1073741824);
+        output(f(x));
+        i = 0;
+        while (i < 4) { a[i] = x * 9 + i / 2; i = i + 1; }
+        output(a[3] / 4);
+        x = input();
+    }
+}
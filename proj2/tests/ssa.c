@@ -0,0 +1,36 @@
+/* code generated from the SSA form at -O2 */
+int g;
+
+int fib(int n)
+{
+    int a; int b; int t; int i;
+    a = 0; b = 1; i = 0;
+    /* a and b swap through phis every iteration */
+    while (i < n) { t = a; a = b; b = t + b; i = i + 1; }
+    return a;
+}
+
+int mix(int x, int y)
+{
+    int p; int q; int r; int s; int u; int v; int w; int z;
+    p = x + 1; q = y + 2; r = x * y; s = p - q;
+    u = r + s; v = u * 2; w = v - p; z = w + q;
+    if (x > y) { p = z; q = r; } else { p = s; q = u; }
+    g = g + p;
+    return p * 3 + q + r + s + u + v + w + z;
+}
+
+void main(void)
+{
+    int n; int i; int s;
+    n = input();
+    output(fib(n));
+    i = 0; s = 0;
+    while (i < n) {
+        if (i - i / 3 * 3 == 0) s = s + mix(i, n);
+        else s = s - mix(n, i);
+        i = i + 1;
+    }
+    output(s);
+    output(g);
+}
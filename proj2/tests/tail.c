@@ -0,0 +1,50 @@
+/* calls in tail position turned into jumps */
+int a[10];
+
+int sum(int n, int acc)
+{
+    if (n == 0) return acc;
+    return sum(n - 1, acc + n);
+}
+
+int gcd(int u, int v)
+{
+    if (v == 0) return u;
+    else return gcd(v, u - u / v * v);
+}
+
+int sq(int x) { return x * x; }
+
+int twice(int x) { return sq(x + x); }
+
+int find(int v[], int lo, int hi, int x)
+{
+    int mid;
+    if (lo > hi) return 0 - 1;
+    mid = (lo + hi) / 2;
+    if (v[mid] == x) return mid;
+    if (v[mid] < x) return find(v, mid + 1, hi, x);
+    return find(v, lo, mid - 1, x);
+}
+
+void count(int n)
+{
+    if (n > 0) { a[0] = a[0] + 1; count(n - 1); }
+}
+
+void main(void)
+{
+    int i; int n;
+    n = input();
+    i = 0;
+    while (i < 10) { a[i] = i * 3; i = i + 1; }
+    /* deeper than the TM memory holds frames for */
+    output(sum(n, 0));
+    output(gcd(1071, 462));
+    output(twice(7));
+    output(find(a, 0, 9, 21));
+    output(find(a, 0, 9, 22));
+    a[0] = 0;
+    count(n + 10000);
+    output(a[0]);
+}
@@ -0,0 +1,44 @@
+/* counted loops unrolled fully and partly */
+int g[30];
+
+int sum(int a[], int n)
+{
+    int i; int s;
+    s = 0;
+    i = 0;
+    while (i < n) { s = s + a[i]; i = i + 1; }
+    return s;
+}
+
+void main(void)
+{
+    int i; int j; int k; int n; int a[12];
+    n = input();
+    i = 0;
+    while (i < 11) { a[i] = i * i; i = i + 1; }
+    output(i);
+    output(sum(a, 11));
+    j = 10;
+    k = 0;
+    while (j != 0) { int t; t = j * 2; k = k + t; j = j - 2; }
+    output(k);
+    output(j);
+    i = 29;
+    while (i >= 3) { g[i] = i; i = i - 3; output(i); }
+    output(sum(g, 30));
+    i = 0;
+    while (i < 3) {
+        j = 0;
+        while (j < 3) { a[i * 3 + j] = i + j; j = j + 1; }
+        i = i + 1;
+    }
+    output(sum(a, 9));
+    /* a block of the body declares locals of its own */
+    k = 0;
+    i = 0;
+    while (i < 30) {
+        { int t; int b[2]; t = n + i; b[1] = t; k = k + b[1]; }
+        i = i + 1;
+    }
+    output(k);
+}
@@ -0,0 +1,14 @@
+/* unrolled copies of a body whose block declares locals */
+void main(void)
+{
+    int i; int s; int n;
+    n = input();
+    s = 0;
+    i = 0;
+    while (i < 8) {
+        { int t; t = n; s = s + t; }
+        i = i + 1;
+    }
+    output(i);
+    output(s);
+}
@@ -0,0 +1,33 @@
+/* simple array loops run as TM vector ops */
+int g[20];
+int h[20];
+
+void addv(int c[], int a[], int b[], int n)
+{
+    int i;
+    i = 0;
+    while (i < n) {
+        c[i] = a[i] + b[i];
+        c[i] = c[i] * a[i];
+        i = i + 1;
+    }
+}
+
+void main(void)
+{
+    int a[20]; int b[20]; int c[20]; int i; int n;
+    n = input();
+    i = 0;
+    while (i < 20) { a[i] = i * 3 - 7; b[i] = 20 - i * i; i = i + 1; }
+    /* a start and an end the vector loop must respect */
+    i = 2;
+    while (i < n) { c[i] = a[i] - b[i]; i = i + 1; }
+    output(i);
+    i = 0;
+    while (n > i) { g[i] = a[i] > b[i]; h[i] = b[i] >= a[i]; i = i + 1; }
+    i = 0;
+    while (i <= 9) { g[i] = a[i] == b[i]; h[i] = a[i] != g[i]; i = i + 1; }
+    addv(c, a, b, n);
+    i = 0;
+    while (i < 20) { output(c[i] + g[i] * 1000 + h[i] * 100000); i = i + 1; }
+}
@@ -0,0 +1,69 @@
+#!/bin/sh
+#####################################################
+# File: watch.sh                                    #
+# Runs the compiler with -w on watch/step0.c and    #
+# puts watch/step1.c, step2.c, ... in its place one #
+# after the other; what each recompilation reports, #
+# on stderr and in the listing, must match          #
+# watch/watch.out                                   #
+# usage: watch.sh compiler                          #
+#####################################################
+
+if [ $# -ne 1 ]; then
+    echo "usage: $0 compiler"
+    exit 2
+fi
+dir=$(cd "$(dirname "$0")/watch" && pwd)
+cc=$(cd "$(dirname "$1")" && pwd)/$(basename "$1")
+work=$(mktemp -d)
+pid=
+trap '[ -n "$pid" ] && kill $pid 2>/dev/null; rm -rf "$work"' EXIT
+cd "$work" || exit 2
+
+# await PATTERN FILE COUNT: waits until COUNT lines
+# of FILE match PATTERN, for ten seconds at most
+await()
+{
+    tries=0
+    while [ "$(grep -c "$1" "$2" 2>/dev/null)" != "$3" ]; do
+        tries=$((tries + 1))
+        [ $tries -gt 100 ] && return 1
+        sleep 0.1
+    done
+}
+
+cp "$dir/step0.c" prog.c
+touch -d @1000000000 prog.c
+"$cc" -w prog.c >/dev/null 2>stderr.txt &
+pid=$!
+if ! await 'TINY COMPILATION' prog_20181623.txt 1; then
+    echo "FAIL watch: not compiled"
+    exit 1
+fi
+step=1
+while [ -f "$dir/step$step.c" ]; do
+    # stamped before the rename so that the watcher
+    # sees each edit once, whole and with a new time
+    cp "$dir/step$step.c" next.c
+    touch -d @$((1000000000 + step)) next.c
+    mv next.c prog.c
+    if ! await 'recompiled' stderr.txt $step; then
+        echo "FAIL watch: step $step not recompiled"
+        exit 1
+    fi
+    step=$((step + 1))
+done
+kill $pid
+pid=
+{
+    cat stderr.txt
+    grep 'RECOMPILATION\|error at line\|Re-analysis' prog_20181623.txt |
+        sed 's/ in [0-9.]* ms$//'
+} >report.txt
+if cmp -s report.txt "$dir/watch.out"; then
+    echo "watch: $((step - 1)) recompilations passed"
+else
+    echo "FAIL watch"
+    diff "$dir/watch.out" report.txt | sed 's/^/    /'
+    exit 1
+fi
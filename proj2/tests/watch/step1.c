@@ -0,0 +1,5 @@
+/* one body edited: only h is checked again */
+int k;
+int f(int x) { return x + k; }
+int h(int y) { return f(y) * 3; }
+void main(void) { k = input(); output(h(k)); }
@@ -0,0 +1,5 @@
+/* f takes another parameter: f and its caller h are checked */
+int k;
+int f(int x, int z) { return x + z + k; }
+int h(int y) { return f(y) * 3; }
+void main(void) { k = input(); output(h(k)); }
@@ -0,0 +1,5 @@
+/* the global k becomes a function */
+int k(void) { return 1; }
+int f(int x) { return x + k; }
+int h(int y) { return f(y) * 3; }
+void main(void) { k = input(); output(h(k)); }
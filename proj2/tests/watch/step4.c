@@ -0,0 +1,4 @@
+/* k is a variable again and h is removed */
+int k;
+int f(int x) { return x + k; }
+void main(void) { k = input(); output(h(k)); }
@@ -0,0 +1,4 @@
+/* a syntax error keeps the last analysis */
+int k;
+int f(int x) { return x + k }
+void main(void) { k = input(); output(h(k)); }
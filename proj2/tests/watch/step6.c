@@ -0,0 +1,5 @@
+/* the first program again: h and main are checked */
+int k;
+int f(int x) { return x + k; }
+int h(int y) { return f(y) * 2; }
+void main(void) { k = input(); output(h(k)); }
@@ -0,0 +1,919 @@
+/****************************************************/
+/* File: tm.c                                       */
+/* The TM ("Tiny Machine") computer                 */
+/* Compiler Construction: Principles and Practice   */
+/* Kenneth C. Louden                                */
+/****************************************************/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <ctype.h>
+
+#ifndef TRUE
+#define TRUE 1
+#endif
+#ifndef FALSE
+#define FALSE 0
+#endif
+
+/******* const *******/
+#define   IADDR_SIZE  1024 /* increase for large programs */
+#define   DADDR_SIZE  1024 /* increase for large programs */
+#define   NO_REGS 8
+#define   PC_REG  7
+
+#define   LINESIZE  121
+#define   WORDSIZE  20
+#define   NAMESIZE  41  /* longest C-MINUS name, and its end */
+
+/* the cycles an instruction takes: one, but for a
+   multiply or divide, and for a vector op one for
+   every VLANES elements, which its SIMD unit
+   works on at once */
+#define   MUL_CYCLES  4
+#define   DIV_CYCLES  20
+#define   VLANES  4
+
+/******* type  *******/
+
+typedef enum {
+   opclRR,     /* reg operands r,s,t */
+   opclRM,     /* reg r, mem d+s */
+   opclRA      /* reg r, int d+s */
+   } OPCLASS;
+
+typedef enum {
+   /* RR instructions */
+   opHALT,    /* RR     halt, operands are ignored */
+   opIN,      /* RR     read into reg(r); s and t are ignored */
+   opOUT,     /* RR     write from reg(r), s and t are ignored */
+   opADD,    /* RR     reg(r) = reg(s)+reg(t) */
+   opSUB,    /* RR     reg(r) = reg(s)-reg(t) */
+   opMUL,    /* RR     reg(r) = reg(s)*reg(t) */
+   opDIV,    /* RR     reg(r) = reg(s)/reg(t) */
+   opSHL,    /* RR     reg(r) = reg(s)<<reg(t) */
+   opSHR,    /* RR     reg(r) = reg(s)>>reg(t), shifting in zeros */
+   opSAR,    /* RR     reg(r) = reg(s)>>reg(t), shifting in the sign */
+   opAND,    /* RR     reg(r) = reg(s)&reg(t) */
+   opOR,     /* RR     reg(r) = reg(s)|reg(t) */
+   opXOR,    /* RR     reg(r) = reg(s)^reg(t) */
+   opVSET,   /* RR     vlen = reg(r); s and t are ignored */
+   opVADD,   /* RR     mem(reg(r)+k) = mem(reg(s)+k)+mem(reg(t)+k), 0<=k<vlen */
+   opVSUB,   /* RR     mem(reg(r)+k) = mem(reg(s)+k)-mem(reg(t)+k), 0<=k<vlen */
+   opVMUL,   /* RR     mem(reg(r)+k) = mem(reg(s)+k)*mem(reg(t)+k), 0<=k<vlen */
+   opVLT,    /* RR     mem(reg(r)+k) = mem(reg(s)+k)<mem(reg(t)+k), 0<=k<vlen */
+   opVLE,    /* RR     mem(reg(r)+k) = mem(reg(s)+k)<=mem(reg(t)+k), 0<=k<vlen */
+   opVEQ,    /* RR     mem(reg(r)+k) = mem(reg(s)+k)==mem(reg(t)+k), 0<=k<vlen */
+   opVNE,    /* RR     mem(reg(r)+k) = mem(reg(s)+k)!=mem(reg(t)+k), 0<=k<vlen */
+   opMSET,   /* RR     mem(reg(r)+k) = reg(s), 0<=k<vlen; t is ignored */
+   opMCPY,   /* RR     mem(reg(r)+k) = mem(reg(s)+k), 0<=k<vlen, as memmove; t is ignored */
+   opMIOTA,  /* RR     mem(reg(r)+k) = reg(s)+k, 0<=k<vlen; t is ignored */
+   opRRLim,   /* limit of RR opcodes */
+
+   /* RM instructions */
+   opLD,      /* RM     reg(r) = mem(d+reg(s)) */
+   opST,      /* RM     mem(d+reg(s)) = reg(r) */
+   opRMLim,   /* Limit of RM opcodes */
+
+   /* RA instructions */
+   opLDA,     /* RA     reg(r) = d+reg(s) */
+   opLDC,     /* RA     reg(r) = d ; reg(s) is ignored */
+   opJLT,     /* RA     if reg(r)<0 then reg(7) = d+reg(s) */
+   opJLE,     /* RA     if reg(r)<=0 then reg(7) = d+reg(s) */
+   opJGT,     /* RA     if reg(r)>0 then reg(7) = d+reg(s) */
+   opJGE,     /* RA     if reg(r)>=0 then reg(7) = d+reg(s) */
+   opJEQ,     /* RA     if reg(r)==0 then reg(7) = d+reg(s) */
+   opJNE,     /* RA     if reg(r)!=0 then reg(7) = d+reg(s) */
+   opRALim    /* Limit of RA opcodes */
+   } OPCODE;
+
+typedef enum {
+   srOKAY,
+   srHALT,
+   srIMEM_ERR,
+   srDMEM_ERR,
+   srZERODIVIDE
+   } STEPRESULT;
+
+typedef struct {
+      int iop  ;
+      int iarg1  ;
+      int iarg2  ;
+      int iarg3  ;
+   } INSTRUCTION;
+
+/* what the compiler noted of a location: the
+   jump deciding the condition of branch site of
+   source line line, taken when it is true if
+   sense is 1, or the jump calling function
+   callee at call site there */
+typedef enum {
+   noNONE,
+   noBRANCH,
+   noCALL
+   } NOTEKIND;
+
+typedef struct {
+      NOTEKIND kind ;
+      int line ;
+      int site ;
+      int sense ;
+      char callee[NAMESIZE] ;
+   } NOTE;
+
+/* a record of the profile: the counts of a
+   branch when true and false, or of a call */
+typedef struct {
+      NOTEKIND kind ;
+      int line ;
+      int site ;
+      char callee[NAMESIZE] ;
+      long count[2] ;
+   } PROFREC;
+
+#define   MAXRECS  (2 * IADDR_SIZE)
+
+/******** vars ********/
+int iloc = 0 ;
+int dloc = 0 ;
+int traceflag = FALSE;
+int icountflag = FALSE;
+int cycles = 0 ;
+
+INSTRUCTION iMem [IADDR_SIZE];
+int dMem [DADDR_SIZE];
+int dInit [DADDR_SIZE]; /* the data memory a run starts with */
+int reg [NO_REGS];
+int vlen = 0 ; /* the number of elements a vector op works on */
+
+char * opCodeTab[]
+        = {"HALT","IN","OUT","ADD","SUB","MUL","DIV",
+           "SHL","SHR","SAR","AND","OR","XOR",
+           "VSET","VADD","VSUB","VMUL","VLT","VLE","VEQ","VNE",
+           "MSET","MCPY","MIOTA","????",
+            /* RR opcodes */
+           "LD","ST","????", /* RM opcodes */
+           "LDA","LDC","JLT","JLE","JGT","JGE","JEQ","JNE","????"
+           /* RA opcodes */
+          };
+
+char * stepResultTab[]
+        = {"OK","Halted","Instruction Memory Fault",
+           "Data Memory Fault","Division by 0"
+          };
+
+char pgmName[20];
+FILE *pgm  ;
+
+/* the execution profile: the notes of each
+   location, how often it ran and how often its
+   jump was taken */
+char * profName = NULL ;
+NOTE notes [IADDR_SIZE] ;
+long runCount [IADDR_SIZE] ;
+long takenCount [IADDR_SIZE] ;
+PROFREC profRecs [MAXRECS] ;
+int nProfRecs = 0 ;
+
+char in_Line[LINESIZE] ;
+int lineLen ;
+int inCol  ;
+int num  ;
+char word[WORDSIZE] ;
+char ch  ;
+int done  ;
+
+/********************************************/
+int opClass( int c )
+{ if      ( c <= opRRLim) return ( opclRR );
+  else if ( c <= opRMLim) return ( opclRM );
+  else                    return ( opclRA );
+} /* opClass */
+
+/********************************************/
+void writeInstruction ( int loc )
+{ printf( "%5d: ", loc) ;
+  if ( (loc >= 0) && (loc < IADDR_SIZE) )
+  { printf("%6s%3d,", opCodeTab[iMem[loc].iop], iMem[loc].iarg1);
+    switch ( opClass(iMem[loc].iop) )
+    { case opclRR: printf("%1d,%1d", iMem[loc].iarg2, iMem[loc].iarg3);
+                   break;
+      case opclRM:
+      case opclRA: printf("%3d(%1d)", iMem[loc].iarg2, iMem[loc].iarg3);
+                   break;
+    }
+    printf ("\n") ;
+  }
+} /* writeInstruction */
+
+/********************************************/
+void getCh (void)
+{ if (++inCol < lineLen)
+  ch = in_Line[inCol] ;
+  else ch = ' ' ;
+} /* getCh */
+
+/********************************************/
+int nonBlank (void)
+{ while ((inCol < lineLen)
+         && (in_Line[inCol] == ' ') )
+    inCol++ ;
+  if (inCol < lineLen)
+  { ch = in_Line[inCol] ;
+    return TRUE ; }
+  else
+  { ch = ' ' ;
+    return FALSE ; }
+} /* nonBlank */
+
+/********************************************/
+int getNum (void)
+{ int sign;
+  int term;
+  int temp = FALSE;
+  num = 0 ;
+  do
+  { sign = 1;
+    while ( nonBlank() && ((ch == '+') || (ch == '-')) )
+    { temp = FALSE ;
+      if (ch == '-')  sign = - sign ;
+      getCh();
+    }
+    term = 0 ;
+    nonBlank();
+    while (isdigit(ch))
+    { temp = TRUE ;
+      term = term * 10 + ( ch - '0' ) ;
+      getCh();
+    }
+    num = num + (term * sign) ;
+  } while ( (nonBlank()) && ((ch == '+') || (ch == '-')) ) ;
+  return temp;
+} /* getNum */
+
+/********************************************/
+int getWord (void)
+{ int temp = FALSE;
+  int length = 0;
+  if (nonBlank ())
+  { while (isalnum(ch))
+    { if (length < WORDSIZE-1) word [length++] =  ch ;
+      getCh() ;
+    }
+    word[length] = '\0';
+    temp = (length != 0);
+  }
+  return temp;
+} /* getWord */
+
+/********************************************/
+int skipCh ( char c  )
+{ int temp = FALSE;
+  if ( nonBlank() && (ch == c) )
+  { getCh();
+    temp = TRUE;
+  }
+  return temp;
+} /* skipCh */
+
+/********************************************/
+int atEOL(void)
+{ return ( ! nonBlank ());
+} /* atEOL */
+
+/********************************************/
+/* reads a line of the terminal into in_Line,
+   without its newline; FALSE at end of input */
+int readLine (void)
+{ if (fgets(in_Line, LINESIZE, stdin) == NULL)
+  { in_Line[0] = '\0' ;
+    lineLen = 0 ;
+    return FALSE ;
+  }
+  lineLen = strlen(in_Line) ;
+  if ((lineLen > 0) && (in_Line[lineLen-1] == '\n'))
+    in_Line[--lineLen] = '\0' ;
+  return TRUE ;
+} /* readLine */
+
+/********************************************/
+int error( char * msg, int lineNo, int instNo)
+{ printf("Line %d",lineNo);
+  if (instNo >= 0) printf(" (Instruction %d)",instNo);
+  printf("   %s\n",msg);
+  return FALSE;
+} /* error */
+
+/********************************************/
+/* a note is a comment the TM reads only to
+   write a profile; one it cannot read is left
+   like any other comment */
+void readNote (void)
+{ int loc, line, site, sense ;
+  char callee[NAMESIZE] ;
+  if ( sscanf(in_Line + inCol, "*@ %d branch %d %d %d",
+              &loc, &line, &site, &sense) == 4 )
+  { if ( (loc < 0) || (loc >= IADDR_SIZE) ) return ;
+    notes[loc].kind = noBRANCH ;
+    notes[loc].line = line ;
+    notes[loc].site = site ;
+    notes[loc].sense = sense ;
+  }
+  else if ( sscanf(in_Line + inCol, "*@ %d call %d %d %40s",
+                   &loc, &line, &site, callee) == 4 )
+  { if ( (loc < 0) || (loc >= IADDR_SIZE) ) return ;
+    notes[loc].kind = noCALL ;
+    notes[loc].line = line ;
+    notes[loc].site = site ;
+    strcpy(notes[loc].callee, callee) ;
+  }
+} /* readNote */
+
+/********************************************/
+/* a data line gives a word a run starts with
+   other than 0: the compiler computed it before
+   the run. Location 0 holds the top of memory */
+int readData (int lineNo)
+{ int loc, val ;
+  if ( sscanf(in_Line + inCol, ".DATA %d %d", &loc, &val) != 2 )
+    return error("Bad data line", lineNo, -1);
+  if ( (loc <= 0) || (loc >= DADDR_SIZE) )
+    return error("Bad data location", lineNo, -1);
+  dInit[loc] = val ;
+  return TRUE ;
+} /* readData */
+
+/********************************************/
+void resetData (void)
+{ memcpy(dMem, dInit, sizeof(dMem)) ;
+} /* resetData */
+
+/********************************************/
+int readInstructions (void)
+{ OPCODE op;
+  int arg1, arg2, arg3;
+  int loc, regNo, lineNo;
+  for (regNo = 0 ; regNo < NO_REGS ; regNo++)
+      reg[regNo] = 0 ;
+  vlen = 0 ;
+  dInit[0] = DADDR_SIZE - 1 ;
+  for (loc = 1 ; loc < DADDR_SIZE ; loc++)
+      dInit[loc] = 0 ;
+  for (loc = 0 ; loc < IADDR_SIZE ; loc++)
+  { iMem[loc].iop = opHALT ;
+    iMem[loc].iarg1 = 0 ;
+    iMem[loc].iarg2 = 0 ;
+    iMem[loc].iarg3 = 0 ;
+    notes[loc].kind = noNONE ;
+    runCount[loc] = 0 ;
+    takenCount[loc] = 0 ;
+  }
+  lineNo = 0 ;
+  while (! feof(pgm))
+  { fgets( in_Line, LINESIZE-2, pgm  ) ;
+    inCol = 0 ; 
+    lineNo++;
+    lineLen = strlen(in_Line)-1 ;
+    if (in_Line[lineLen]=='\n') in_Line[lineLen] = '\0' ;
+    else in_Line[++lineLen] = '\0';
+    if ( (nonBlank()) && (in_Line[inCol] == '*') )
+      readNote () ;
+    else if ( (nonBlank()) && (in_Line[inCol] == '.') )
+    { if (! readData (lineNo))
+        return FALSE;
+    }
+    else if ( nonBlank() )
+    { if (! getNum())
+        return error("Bad location", lineNo,-1);
+      loc = num;
+      if ((loc < 0) || (loc >= IADDR_SIZE))
+        return error("Location too large",lineNo,loc);
+      if (! skipCh(':'))
+        return error("Missing colon", lineNo,loc);
+      if (! getWord ())
+        return error("Missing opcode", lineNo,loc);
+      op = opHALT ;
+      while ((op < opRALim)
+             && (strncmp(opCodeTab[op], word, 4) != 0) )
+          op++ ;
+      if (strncmp(opCodeTab[op], word, 4) != 0)
+          return error("Illegal opcode", lineNo,loc);
+      switch ( opClass(op) )
+      { case opclRR :
+        /***********************************/
+        if ( (! getNum ()) || (num < 0) || (num >= NO_REGS) )
+            return error("Bad first register", lineNo,loc);
+        arg1 = num;
+        if ( ! skipCh(','))
+            return error("Missing comma", lineNo, loc);
+        if ( (! getNum ()) || (num < 0) || (num >= NO_REGS) )
+            return error("Bad second register", lineNo, loc);
+        arg2 = num;
+        if ( ! skipCh(',')) 
+            return error("Missing comma", lineNo,loc);
+        if ( (! getNum ()) || (num < 0) || (num >= NO_REGS) )
+            return error("Bad third register", lineNo,loc);
+        arg3 = num;
+        break;
+
+        case opclRM :
+        case opclRA :
+        /***********************************/
+        if ( (! getNum ()) || (num < 0) || (num >= NO_REGS) )
+            return error("Bad first register", lineNo,loc);
+        arg1 = num;
+        if ( ! skipCh(','))
+            return error("Missing comma", lineNo,loc);
+        if (! getNum ())
+            return error("Bad displacement", lineNo,loc);
+        arg2 = num;
+        if ( ! skipCh('(') && ! skipCh(',') )
+            return error("Missing LParen", lineNo,loc);
+        if ( (! getNum ()) || (num < 0) || (num >= NO_REGS))
+            return error("Bad second register", lineNo,loc);
+        arg3 = num;
+        break;
+        }
+      iMem[loc].iop = op;
+      iMem[loc].iarg1 = arg1;
+      iMem[loc].iarg2 = arg2;
+      iMem[loc].iarg3 = arg3;
+    }
+  }
+  resetData () ;
+  return TRUE;
+} /* readInstructions */
+
+
+/********************************************/
+void jump ( int pc, int m )
+{ reg[PC_REG] = m ;
+  takenCount[pc]++ ;
+} /* jump */
+
+/********************************************/
+/* a vector op runs element by element, in
+   order, as a loop would: each case is a plain
+   loop over the host arrays, which the host
+   compiler turns into its own SIMD code */
+void vectorOp ( int op, int * d, int * a, int * b, int n )
+{ int k ;
+  switch (op)
+  { case opVADD : for (k = 0; k < n; k++) d[k] = a[k] + b[k] ; break;
+    case opVSUB : for (k = 0; k < n; k++) d[k] = a[k] - b[k] ; break;
+    case opVMUL : for (k = 0; k < n; k++) d[k] = a[k] * b[k] ; break;
+    case opVLT :  for (k = 0; k < n; k++) d[k] = a[k] < b[k] ; break;
+    case opVLE :  for (k = 0; k < n; k++) d[k] = a[k] <= b[k] ; break;
+    case opVEQ :  for (k = 0; k < n; k++) d[k] = a[k] == b[k] ; break;
+    case opVNE :  for (k = 0; k < n; k++) d[k] = a[k] != b[k] ; break;
+  }
+} /* vectorOp */
+
+/********************************************/
+/* a block memory op fills, copies or counts a
+   block of vlen words at host memset and memcpy
+   speed */
+void blockOp ( int op, int * d, int * a, int v, int n )
+{ int k ;
+  switch (op)
+  { case opMSET :
+      if ( v == 0 ) memset(d, 0, n * sizeof(int)) ;
+      else for (k = 0; k < n; k++) d[k] = v ;
+      break;
+    case opMCPY : memmove(d, a, n * sizeof(int)) ; break;
+    case opMIOTA : for (k = 0; k < n; k++) d[k] = v + k ; break;
+  }
+} /* blockOp */
+
+/********************************************/
+/* whether the vlen words from address m are
+   all in data memory */
+int inDMem ( int m )
+{ return (m >= 0) && (m <= DADDR_SIZE - vlen) ;
+} /* inDMem */
+
+/********************************************/
+int opCycles ( int op )
+{ switch (op)
+  { case opMUL : return MUL_CYCLES ;
+    case opDIV : return DIV_CYCLES ;
+    default :
+      if ( (op > opVSET) && (op < opRRLim) )
+        return 1 + (vlen + VLANES - 1) / VLANES ;
+      return 1 ;
+  }
+} /* opCycles */
+
+/********************************************/
+STEPRESULT stepTM (void)
+{ INSTRUCTION currentinstruction  ;
+  int pc  ;
+  int r,s,t,m  ;
+  int ok ;
+
+  pc = reg[PC_REG] ;
+  if ( (pc < 0) || (pc >= IADDR_SIZE)  )
+      return srIMEM_ERR ;
+  reg[PC_REG] = pc + 1 ;
+  currentinstruction = iMem[ pc ] ;
+  runCount[pc]++ ;
+  cycles += opCycles(currentinstruction.iop) ;
+  switch (opClass(currentinstruction.iop) )
+  { case opclRR :
+    /***********************************/
+      r = currentinstruction.iarg1 ;
+      s = currentinstruction.iarg2 ;
+      t = currentinstruction.iarg3 ;
+      break;
+
+    case opclRM :
+    /***********************************/
+      r = currentinstruction.iarg1 ;
+      s = currentinstruction.iarg3 ;
+      m = currentinstruction.iarg2 + reg[s] ;
+      if ( (m < 0) || (m > DADDR_SIZE))
+         return srDMEM_ERR ;
+      break;
+
+    case opclRA :
+    /***********************************/
+      r = currentinstruction.iarg1 ;
+      s = currentinstruction.iarg3 ;
+      m = currentinstruction.iarg2 + reg[s] ;
+      break;
+  } /* case */
+
+  switch ( currentinstruction.iop)
+  { /* RR instructions */
+    case opHALT :
+    /***********************************/
+      printf("HALT: %1d,%1d,%1d\n",r,s,t);
+      return srHALT ;
+      /* break; */
+
+    case opIN :
+    /***********************************/
+      do
+      { printf("Enter value for IN instruction: ") ;
+        fflush (stdin);
+        fflush (stdout);
+        if (! readLine()) return srHALT ;
+        inCol = 0;
+        ok = getNum();
+        if ( ! ok ) printf ("Illegal value\n");
+        else reg[r] = num;
+      }
+      while (! ok);
+      break;
+
+    case opOUT :  
+      printf ("OUT instruction prints: %d\n", reg[r] ) ;
+      break;
+    case opADD :  reg[r] = reg[s] + reg[t] ;  break;
+    case opSUB :  reg[r] = reg[s] - reg[t] ;  break;
+    case opMUL :  reg[r] = reg[s] * reg[t] ;  break;
+
+    case opDIV :
+    /***********************************/
+      if ( reg[t] != 0 ) reg[r] = reg[s] / reg[t];
+      else return srZERODIVIDE ;
+      break;
+
+    /* a shift counts modulo 32 */
+    case opSHL :  reg[r] = (int) ((unsigned) reg[s] << (reg[t] & 31)) ;  break;
+    case opSHR :  reg[r] = (int) ((unsigned) reg[s] >> (reg[t] & 31)) ;  break;
+    case opSAR :
+    /***********************************/
+      if ( reg[s] >= 0 ) reg[r] = reg[s] >> (reg[t] & 31) ;
+      else reg[r] = ~ (~ reg[s] >> (reg[t] & 31)) ;
+      break;
+    case opAND :  reg[r] = reg[s] & reg[t] ;  break;
+    case opOR :   reg[r] = reg[s] | reg[t] ;  break;
+    case opXOR :  reg[r] = reg[s] ^ reg[t] ;  break;
+
+    case opVSET :  vlen = (reg[r] > 0) ? reg[r] : 0 ;  break;
+
+    case opVADD :
+    case opVSUB :
+    case opVMUL :
+    case opVLT :
+    case opVLE :
+    case opVEQ :
+    case opVNE :
+    /***********************************/
+      if ( vlen == 0 ) break;
+      if ( ! inDMem(reg[r]) || ! inDMem(reg[s]) || ! inDMem(reg[t]) )
+         return srDMEM_ERR ;
+      vectorOp(currentinstruction.iop, dMem + reg[r], dMem + reg[s], dMem + reg[t], vlen) ;
+      break;
+
+    case opMSET :
+    case opMIOTA :
+    /***********************************/
+      if ( vlen == 0 ) break;
+      if ( ! inDMem(reg[r]) )
+         return srDMEM_ERR ;
+      blockOp(currentinstruction.iop, dMem + reg[r], NULL, reg[s], vlen) ;
+      break;
+
+    case opMCPY :
+    /***********************************/
+      if ( vlen == 0 ) break;
+      if ( ! inDMem(reg[r]) || ! inDMem(reg[s]) )
+         return srDMEM_ERR ;
+      blockOp(currentinstruction.iop, dMem + reg[r], dMem + reg[s], 0, vlen) ;
+      break;
+
+    /*************** RM instructions ********************/
+    case opLD :    reg[r] = dMem[m] ;  break;
+    case opST :    dMem[m] = reg[r] ;  break;
+
+    /*************** RA instructions ********************/
+    case opLDA :    reg[r] = m ; break;
+    case opLDC :    reg[r] = currentinstruction.iarg2 ;   break;
+    case opJLT :    if ( reg[r] <  0 ) jump(pc,m) ; break;
+    case opJLE :    if ( reg[r] <=  0 ) jump(pc,m) ; break;
+    case opJGT :    if ( reg[r] >  0 ) jump(pc,m) ; break;
+    case opJGE :    if ( reg[r] >=  0 ) jump(pc,m) ; break;
+    case opJEQ :    if ( reg[r] == 0 ) jump(pc,m) ; break;
+    case opJNE :    if ( reg[r] != 0 ) jump(pc,m) ; break;
+
+    /* end of legal instructions */
+  } /* case */
+  return srOKAY ;
+} /* stepTM */
+
+/********************************************/
+int doCommand (void)
+{ char cmd;
+  int stepcnt=0, i;
+  int printcnt;
+  int stepResult;
+  int regNo;
+  do
+  { printf ("Enter command: ");
+    fflush (stdin);
+    fflush (stdout);
+    if (! readLine()) return FALSE ;
+    inCol = 0;
+  }
+  while (! getWord ());
+
+  cmd = word[0] ;
+  switch ( cmd )
+  { case 't' :
+    /***********************************/
+      traceflag = ! traceflag ;
+      printf("Tracing now ");
+      if ( traceflag ) printf("on.\n"); else printf("off.\n");
+      break;
+
+    case 'h' :
+    /***********************************/
+      printf("Commands are:\n");
+      printf("   s(tep <n>      "\
+             "Execute n (default 1) TM instructions\n");
+      printf("   g(o            "\
+             "Execute TM instructions until HALT\n");
+      printf("   r(egs          "\
+             "Print the contents of the registers\n");
+      printf("   i(Mem <b <n>>  "\
+             "Print n iMem locations starting at b\n");
+      printf("   d(Mem <b <n>>  "\
+             "Print n dMem locations starting at b\n");
+      printf("   t(race         "\
+             "Toggle instruction trace\n");
+      printf("   p(rint         "\
+             "Toggle print of total instructions executed"\
+             " and cycles ('go' only)\n");
+      printf("   c(lear         "\
+             "Reset simulator for new execution of program\n");
+      printf("   h(elp          "\
+             "Cause this list of commands to be printed\n");
+      printf("   q(uit          "\
+             "Terminate the simulation\n");
+      break;
+
+    case 'p' :
+    /***********************************/
+      icountflag = ! icountflag ;
+      printf("Printing instruction count now ");
+      if ( icountflag ) printf("on.\n"); else printf("off.\n");
+      break;
+
+    case 's' :
+    /***********************************/
+      if ( atEOL ())  stepcnt = 1;
+      else if ( getNum ())  stepcnt = abs(num);
+      else   printf("Step count?\n");
+      break;
+
+    case 'g' :   stepcnt = 1 ;     break;
+
+    case 'r' :
+    /***********************************/
+      for (i = 0; i < NO_REGS; i++)
+      { printf("%1d: %4d    ", i,reg[i]);
+        if ( (i % 4) == 3 ) printf ("\n");
+      }
+      printf("vlen: %d\n", vlen);
+      break;
+
+    case 'i' :
+    /***********************************/
+      printcnt = 1 ;
+      if ( getNum ())
+      { iloc = num ;
+        if ( getNum ()) printcnt = num ;
+      }
+      if ( ! atEOL ())
+        printf ("Instruction locations?\n");
+      else
+      { while ((iloc >= 0) && (iloc < IADDR_SIZE)
+                && (printcnt > 0) )
+        { writeInstruction(iloc);
+          iloc++ ;
+          printcnt-- ;
+        }
+      }
+      break;
+
+    case 'd' :
+    /***********************************/
+      printcnt = 1 ;
+      if ( getNum  ())
+      { dloc = num ;
+        if ( getNum ()) printcnt = num ;
+      }
+      if ( ! atEOL ())
+        printf("Data locations?\n");
+      else
+      { while ((dloc >= 0) && (dloc < DADDR_SIZE)
+                  && (printcnt > 0))
+        { printf("%5d: %5d\n",dloc,dMem[dloc]);
+          dloc++;
+          printcnt--;
+        }
+      }
+      break;
+
+    case 'c' :
+    /***********************************/
+      iloc = 0;
+      dloc = 0;
+      stepcnt = 0;
+      cycles = 0;
+      vlen = 0;
+      for (regNo = 0;  regNo < NO_REGS ; regNo++)
+            reg[regNo] = 0 ;
+      resetData () ;
+      break;
+
+    case 'q' : return FALSE;  /* break; */
+
+    default : printf("Command %c unknown.\n", cmd); break;
+  }  /* case */
+  stepResult = srOKAY;
+  if ( stepcnt > 0 )
+  { if ( cmd == 'g' )
+    { stepcnt = 0;
+      cycles = 0;
+      while (stepResult == srOKAY)
+      { iloc = reg[PC_REG] ;
+        if ( traceflag ) writeInstruction( iloc ) ;
+        stepResult = stepTM ();
+        stepcnt++;
+      }
+      if ( icountflag )
+      { printf("Number of instructions executed = %d\n",stepcnt);
+        printf("Number of cycles = %d\n",cycles);
+      }
+    }
+    else
+    { while ((stepcnt > 0) && (stepResult == srOKAY))
+      { iloc = reg[PC_REG] ;
+        if ( traceflag ) writeInstruction( iloc ) ;
+        stepResult = stepTM ();
+        stepcnt-- ;
+      }
+    }
+    printf( "%s\n",stepResultTab[stepResult] );
+  }
+  return TRUE;
+} /* doCommand */
+
+
+/********************************************/
+PROFREC * profRec ( NOTEKIND kind, int line, int site, char * callee )
+{ int i ;
+  for (i = 0 ; i < nProfRecs ; i++)
+    if ( (profRecs[i].kind == kind) && (profRecs[i].line == line)
+         && (profRecs[i].site == site)
+         && ((kind == noBRANCH) || (strcmp(profRecs[i].callee, callee) == 0)) )
+      return &profRecs[i] ;
+  if (nProfRecs == MAXRECS) return NULL ;
+  profRecs[nProfRecs].kind = kind ;
+  profRecs[nProfRecs].line = line ;
+  profRecs[nProfRecs].site = site ;
+  strcpy(profRecs[nProfRecs].callee, (kind == noCALL) ? callee : "") ;
+  profRecs[nProfRecs].count[0] = 0 ;
+  profRecs[nProfRecs].count[1] = 0 ;
+  return &profRecs[nProfRecs++] ;
+} /* profRec */
+
+/********************************************/
+/* the counts of this simulation are added to
+   those the profile file already has, so it sums
+   up every run of the program */
+int writeProfile (void)
+{ FILE * prof ;
+  PROFREC * rec ;
+  char kind[WORDSIZE], callee[NAMESIZE] ;
+  int loc, line, site ;
+  long a, b ;
+  prof = fopen(profName, "r") ;
+  if (prof != NULL)
+  { while (fscanf(prof, "%19s", kind) == 1)
+    { if ( (strcmp(kind, "branch") == 0)
+           && (fscanf(prof, "%d %d %ld %ld", &line, &site, &a, &b) == 4) )
+        rec = profRec(noBRANCH, line, site, "") ;
+      else if ( (strcmp(kind, "call") == 0)
+           && (fscanf(prof, "%d %d %40s %ld", &line, &site, callee, &a) == 4) )
+      { rec = profRec(noCALL, line, site, callee) ;
+        b = 0 ;
+      }
+      else break ;
+      if (rec != NULL)
+      { rec->count[0] += a ;
+        rec->count[1] += b ;
+      }
+    }
+    fclose(prof) ;
+  }
+  for (loc = 0 ; loc < IADDR_SIZE ; loc++)
+  { if (notes[loc].kind == noNONE) continue ;
+    rec = profRec(notes[loc].kind, notes[loc].line, notes[loc].site,
+                  notes[loc].callee) ;
+    if (rec == NULL) continue ;
+    if (notes[loc].kind == noCALL)
+      rec->count[0] += runCount[loc] ;
+    else
+    { a = notes[loc].sense ? takenCount[loc] : runCount[loc] - takenCount[loc] ;
+      rec->count[0] += a ;
+      rec->count[1] += runCount[loc] - a ;
+    }
+  }
+  prof = fopen(profName, "w") ;
+  if (prof == NULL) return FALSE ;
+  for (loc = 0 ; loc < nProfRecs ; loc++)
+  { rec = &profRecs[loc] ;
+    if (rec->kind == noBRANCH)
+      fprintf(prof, "branch %d %d %ld %ld\n", rec->line, rec->site,
+              rec->count[0], rec->count[1]) ;
+    else
+      fprintf(prof, "call %d %d %s %ld\n", rec->line, rec->site,
+              rec->callee, rec->count[0]) ;
+  }
+  fclose(prof) ;
+  return TRUE ;
+} /* writeProfile */
+
+/********************************************/
+/* E X E C U T I O N   B E G I N S   H E R E */
+/********************************************/
+
+int main( int argc, char * argv[] )
+{ if ( (argc == 4) && (strcmp(argv[1], "-p") == 0) )
+  { profName = argv[2] ;
+    argv += 2 ;
+    argc -= 2 ;
+  }
+  if (argc != 2)
+  { printf("usage: %s [-p profile] <filename>\n",argv[0]);
+    exit(1);
+  }
+  strcpy(pgmName,argv[1]) ;
+  if (strchr (pgmName, '.') == NULL)
+     strcat(pgmName,".tm");
+  pgm = fopen(pgmName,"r");
+  if (pgm == NULL)
+  { printf("file '%s' not found\n",pgmName);
+    exit(1);
+  }
+
+  /* read the program */
+  if ( ! readInstructions ())
+         exit(1) ;
+  /* switch input file to terminal */
+  /* reset( input ); */
+  /* read-eval-print */
+  printf("TM  simulation (enter h for help)...\n");
+  do
+     done = ! doCommand ();
+  while (! done );
+  if ( (profName != NULL) && ! writeProfile () )
+    printf("Unable to write profile %s\n", profName);
+  printf("Simulation done.\n");
+  return 0;
+}
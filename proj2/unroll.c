@@ -0,0 +1,499 @@
+/****************************************************/
+/* File: unroll.c                                   */
+/* Loop unrolling for the C-MINUS compiler          */
+/* A counted loop is a while loop testing a local   */
+/* i against a constant n by i < n, i <= n, i > n,  */
+/* i >= n or i != n, whose body assigns i once, by  */
+/* a statement i = i + c run every iteration, with  */
+/* i set to a constant before the loop: the number  */
+/* of iterations is known. Copy k of the body reads */
+/* i as i + k*c and drops the step, so copies need  */
+/* no test or step of their own; a loop unrolled    */
+/* fully reads i as the constant it has instead     */
+/* Compiler Construction: Principles and Practice   */
+/* Kenneth C. Louden                                */
+/****************************************************/
+
+#include "globals.h"
+#include "util.h"
+#include "fold.h"
+#include "code.h"
+#include "cgen.h"
+#include "profile.h"
+#include "unroll.h"
+
+/* loops of at most FULL_TRIPS iterations are
+ * unrolled fully. Unrolling a loop must keep the
+ * program within CODE_BUDGET TM instructions,
+ * leaving part of the IADDR_SIZE of the TM to
+ * later passes, and grow it by at most LOOP_BUDGET
+ */
+#define FULL_TRIPS 8
+#define CODE_BUDGET (IADDR_SIZE * 3 / 4)
+#define LOOP_BUDGET (IADDR_SIZE / 8)
+
+/* iterations counted before a loop is taken as
+ * too long to count
+ */
+#define MAX_TRIPS 65536
+
+/* the program and the size of its code */
+static TreeNode * program;
+static int size;
+
+/* the declarations of a statement and those of
+ * its copy
+ */
+typedef struct
+{
+    TreeNode * from;
+    TreeNode * to;
+} MapRec;
+
+static MapRec * map = NULL;
+static int nMap = 0, maxMap = 0;
+
+/* a counted loop: i op n with i stepped by c */
+typedef struct
+{
+    TreeNode * id;      /* i in the test */
+    TokenType op;       /* the test read as i op n */
+    int bound;          /* n */
+    TreeNode * step;    /* the statement i = i + c */
+    int by;             /* c */
+    int init;           /* i before the loop */
+    int trips;          /* iterations the loop runs */
+} CountedLoop;
+
+static void * grow(void * array, int n, int * max, int size)
+{
+    if (n < *max)
+        return array;
+    *max = (*max == 0) ? 16 : 2 * *max;
+    array = realloc(array, *max * size);
+    if (array == NULL){
+        fprintf(listing, "Out of memory error at line %d\n", lineno);
+        exit(-1);
+    }
+    return array;
+}
+
+/* Function countAssigns counts the assignments
+ * to variable decl in statement or expression t
+ */
+static int countAssigns(TreeNode * t, TreeNode * decl)
+{
+    int n = 0;
+    if (t == NULL)
+        return 0;
+    if (isAssign(t) && isScalar(t->child[0], decl))
+        n++;
+    for (int i = 0; i < MAXCHILDREN; i++)
+        for (TreeNode * c = t->child[i]; c != NULL; c = c->sibling)
+            n += countAssigns(c, decl);
+    return n;
+}
+
+/* Function isStep tells whether statement t is
+ * i = i + c, i = c + i or i = i - c for variable
+ * decl, setting by to c
+ */
+static int isStep(TreeNode * t, TreeNode * decl, int * by)
+{
+    TreeNode * rhs, * l, * r;
+    if (!isAssign(t) || !isScalar(t->child[0], decl))
+        return FALSE;
+    rhs = t->child[1];
+    if (rhs->nodekind != StmtK || rhs->kind.stmt != AdditiveStmtK)
+        return FALSE;
+    l = rhs->child[0];
+    r = rhs->child[2];
+    if (rhs->child[1]->attr.op == PLUS){
+        if (isScalar(l, decl) && isConst(r))
+            *by = r->attr.val;
+        else if (isConst(l) && isScalar(r, decl))
+            *by = l->attr.val;
+        else
+            return FALSE;
+    }
+    else if (isScalar(l, decl) && isConst(r))
+        *by = -r->attr.val;
+    else
+        return FALSE;
+    return *by != 0;
+}
+
+/* Function holds evaluates the test of a loop
+ * for i = v
+ */
+static int holds(TokenType op, long v, long n)
+{
+    switch (op){
+        case LT: return v < n;
+        case LE: return v <= n;
+        case GT: return v > n;
+        case GE: return v >= n;
+        default: return v != n;
+    }
+}
+
+static TokenType mirror(TokenType op)
+{
+    switch (op){
+        case LT: return GT;
+        case LE: return GE;
+        case GT: return LT;
+        case GE: return LE;
+        default: return op;
+    }
+}
+
+/* Function countedLoop tells whether the while
+ * statement loop of the statement list starting
+ * at head is a counted loop, filling in c
+ */
+static int countedLoop(TreeNode * head, TreeNode * loop, CountedLoop * c)
+{
+    TreeNode * test = loop->child[0], * body = loop->child[1], * decl;
+    TokenType op;
+    int known = FALSE;
+    long v;
+    if (test->nodekind != StmtK || test->kind.stmt != SimpleStmtK ||
+        body->nodekind != StmtK || body->kind.stmt != CompoundStmtK)
+        return FALSE;
+    op = test->child[1]->attr.op;
+    if (op == EQ)
+        return FALSE;
+    if (isConst(test->child[2])){
+        c->id = test->child[0];
+        c->op = op;
+        c->bound = test->child[2]->attr.val;
+    }
+    else if (isConst(test->child[0])){
+        c->id = test->child[2];
+        c->op = mirror(op);
+        c->bound = test->child[0]->attr.val;
+    }
+    else
+        return FALSE;
+    if (c->id->nodekind != ExpK || c->id->kind.exp != IdK || c->id->bind.isArray ||
+        (c->id->bind.storage != LocalK && c->id->bind.storage != ParamK))
+        return FALSE;
+    decl = c->id->decl;
+    /* the body assigns i once, at its top level */
+    if (countAssigns(body, decl) != 1)
+        return FALSE;
+    for (c->step = body->child[1]; c->step != NULL; c->step = c->step->sibling)
+        if (isStep(c->step, decl, &c->by))
+            break;
+    if (c->step == NULL)
+        return FALSE;
+    /* the value i has when the loop is reached */
+    for (TreeNode * t = head; t != loop; t = t->sibling)
+        if (isAssign(t) && isScalar(t->child[0], decl) && isConst(t->child[1])){
+            known = TRUE;
+            c->init = t->child[1]->attr.val;
+        }
+        else if (countAssigns(t, decl) > 0)
+            known = FALSE;
+    if (!known)
+        return FALSE;
+    c->trips = 0;
+    for (v = c->init; holds(c->op, v, c->bound); v += c->by){
+        if (++c->trips > MAX_TRIPS)
+            return FALSE;
+        /* a step past the int range wraps on the TM */
+        if (v + c->by < -2147483647L - 1 || v + c->by > 2147483647L)
+            return FALSE;
+    }
+    return TRUE;
+}
+
+/* Function offset creates the expression l + val,
+ * l - -val for a negative val
+ */
+static TreeNode * offset(TreeNode * l, int val)
+{
+    TreeNode * t = newStmtNode(AdditiveStmtK);
+    t->lineno = l->lineno;
+    t->type = Integer;
+    t->child[0] = l;
+    t->child[1] = newExpNode(OpK);
+    t->child[1]->attr.op = (val < 0) ? MINUS : PLUS;
+    t->child[1]->lineno = l->lineno;
+    t->child[2] = newConst((val < 0) ? -val : val, l->lineno);
+    return t;
+}
+
+/* Procedure substitute replaces the reads of
+ * variable decl in the tree at loc by val, when
+ * full is set, or else by decl + val
+ */
+static void substitute(TreeNode ** loc, TreeNode * decl, int full, int val)
+{
+    TreeNode * t = *loc, * r;
+    if (isScalar(t, decl)){
+        if (!full && val == 0)
+            return;
+        r = full ? newConst(val, t->lineno) : offset(t, val);
+        r->sibling = t->sibling;
+        t->sibling = NULL;
+        if (full)
+            freeTree(t);
+        *loc = r;
+        return;
+    }
+    for (int i = 0; i < MAXCHILDREN; i++)
+        for (TreeNode ** c = &t->child[i]; *c != NULL; c = &(*c)->sibling)
+            substitute(c, decl, full, val);
+}
+
+static void mapDecls(TreeNode * from, TreeNode * to)
+{
+    for (; from != NULL && to != NULL; from = from->sibling, to = to->sibling){
+        if (from->nodekind == ExpK &&
+            (from->kind.exp == VarDeclK || from->kind.exp == ArrayDeclK)){
+            map = grow(map, nMap, &maxMap, sizeof(MapRec));
+            map[nMap].from = from;
+            map[nMap++].to = to;
+        }
+        for (int i = 0; i < MAXCHILDREN; i++)
+            mapDecls(from->child[i], to->child[i]);
+    }
+}
+
+/* Procedure redirect makes the identifiers of a
+ * copied statement resolve to the declarations of
+ * its own blocks, which the original loop frees
+ */
+static void redirect(TreeNode * t)
+{
+    for (; t != NULL; t = t->sibling){
+        for (int i = 0; i < MAXCHILDREN; i++)
+            redirect(t->child[i]);
+        if (t->nodekind == ExpK && t->kind.exp == IdK)
+            for (int i = 0; i < nMap; i++)
+                if (map[i].from == t->decl){
+                    t->decl = map[i].to;
+                    break;
+                }
+    }
+}
+
+/* Function copyIteration copies the statements of
+ * the body of counted loop c but its step, with i
+ * read as before up to the step and as after past
+ * it, constants when full is set or else offsets
+ */
+static TreeNode * copyIteration(CountedLoop * c, TreeNode * stmts, int full, int before, int after)
+{
+    TreeNode * head = NULL, ** last = &head;
+    int val = before;
+    for (TreeNode * s = stmts; s != NULL; s = s->sibling){
+        TreeNode * next = s->sibling;
+        if (s == c->step){
+            val = after;
+            continue;
+        }
+        s->sibling = NULL;
+        *last = copyTree(s);
+        nMap = 0;
+        mapDecls(s, *last);
+        redirect(*last);
+        s->sibling = next;
+        substitute(last, c->id->decl, full, val);
+        last = &(*last)->sibling;
+    }
+    return head;
+}
+
+/* Function fits tells whether the program is
+ * within budget with the loop just unrolled,
+ * taking its size as the new size if so
+ */
+static int fits(void)
+{
+    int after = codeSize(program);
+    if (after > CODE_BUDGET || after - size > LOOP_BUDGET)
+        return FALSE;
+    size = after;
+    return TRUE;
+}
+
+/* Function unrollFully replaces the counted loop
+ * at loc by a compound statement of a copy of its
+ * body for each iteration, which sets i to the
+ * value it has after the loop, and tells whether
+ * the code fits
+ */
+static int unrollFully(TreeNode ** loc, CountedLoop * c)
+{
+    TreeNode * loop = *loc, * body = loop->child[1];
+    TreeNode * block = newStmtNode(CompoundStmtK), ** last = &block->child[1];
+    int val = c->init;
+    block->lineno = loop->lineno;
+    for (int k = 0; k < c->trips; k++){
+        *last = copyIteration(c, body->child[1], TRUE, val, val + c->by);
+        while (*last != NULL)
+            last = &(*last)->sibling;
+        val += c->by;
+    }
+    *last = newAssign(newName(c->id, loop->lineno), newConst(val, loop->lineno));
+    block->child[1] = foldStatements(block->child[1]);
+    block->sibling = loop->sibling;
+    *loc = block;
+    if (!fits()){
+        *loc = loop;
+        block->sibling = NULL;
+        freeTree(block);
+        return FALSE;
+    }
+    /* the copies still name the locals of the body */
+    block->child[0] = body->child[0];
+    body->child[0] = NULL;
+    loop->sibling = NULL;
+    freeTree(loop);
+    return TRUE;
+}
+
+/* Function unrollPartly puts before the counted
+ * loop at loc a loop running factor copies of its
+ * body an iteration for as long as all of them
+ * would run, leaving the rest of the iterations
+ * to the original loop, and tells whether the
+ * code fits. When factor divides the iterations
+ * the new loop replaces the original one
+ */
+static int unrollPartly(TreeNode ** loc, CountedLoop * c, int factor)
+{
+    TreeNode * loop = *loc, * body = loop->child[1];
+    TreeNode * copy = newStmtNode(IterationStmtK), * block = newStmtNode(CompoundStmtK);
+    TreeNode ** last = &block->child[1];
+    int exact = (c->trips % factor == 0);
+    long stride = (long)factor * c->by, bound = c->bound - (stride - c->by);
+    if (stride < -2147483647L - 1 || stride > 2147483647L){
+        freeTree(copy);
+        freeTree(block);
+        return FALSE;
+    }
+    if (!exact){
+        /* the test must fail for good once it fails */
+        if (!(((c->op == LT || c->op == LE) && c->by > 0) ||
+              ((c->op == GT || c->op == GE) && c->by < 0)) ||
+            bound < -2147483647L - 1 || bound > 2147483647L){
+            freeTree(copy);
+            freeTree(block);
+            return FALSE;
+        }
+    }
+    copy->lineno = block->lineno = loop->lineno;
+    for (int k = 0; k < factor; k++){
+        *last = copyIteration(c, body->child[1], FALSE, k * c->by, (k + 1) * c->by);
+        while (*last != NULL)
+            last = &(*last)->sibling;
+    }
+    *last = newAssign(newName(c->id, loop->lineno),
+                      offset(newName(c->id, loop->lineno), (int)stride));
+    block->child[1] = foldStatements(block->child[1]);
+    copy->child[0] = copyTree(loop->child[0]);
+    copy->child[1] = block;
+    /* i + (factor - 1)*c op n is i op n - (factor - 1)*c */
+    if (!exact){
+        TreeNode * n = isConst(copy->child[0]->child[2]) ?
+            copy->child[0]->child[2] : copy->child[0]->child[0];
+        n->attr.val = (int)bound;
+    }
+    copy->sibling = exact ? loop->sibling : loop;
+    *loc = copy;
+    if (!fits()){
+        *loc = loop;
+        copy->sibling = NULL;
+        freeTree(copy);
+        return FALSE;
+    }
+    if (exact){
+        block->child[0] = body->child[0];
+        body->child[0] = NULL;
+        loop->sibling = NULL;
+        freeTree(loop);
+    }
+    return TRUE;
+}
+
+/* Function unrollLoop unrolls the while statement
+ * at loc of the list starting at head if it is a
+ * counted loop and returns where the last
+ * statement replacing it is linked from
+ */
+static TreeNode ** unrollLoop(TreeNode * head, TreeNode ** loc)
+{
+    TreeNode * loop = *loc;
+    CountedLoop c;
+    long taken, notTaken;
+    if (!countedLoop(head, loop, &c))
+        return loc;
+    /* a loop the profile never saw run is not worth
+     * the code
+     */
+    if (profileBranch(loop->lineno, loop->site, &taken, &notTaken) && taken + notTaken == 0)
+        return loc;
+    if (c.trips <= FULL_TRIPS && unrollFully(loc, &c))
+        return loc;
+    if (c.trips >= UnrollFactor && unrollPartly(loc, &c, UnrollFactor) &&
+        (*loc)->sibling == loop)
+        return &(*loc)->sibling;
+    return loc;
+}
+
+/* Procedure unrollStmts unrolls the loops of a
+ * list of statements, inner loops first
+ */
+static void unrollStmts(TreeNode ** head)
+{
+    for (TreeNode ** loc = head; *loc != NULL; loc = &(*loc)->sibling){
+        TreeNode * t = *loc;
+        if (t->nodekind != StmtK)
+            continue;
+        switch (t->kind.stmt){
+            case CompoundStmtK:
+                unrollStmts(&t->child[1]);
+                break;
+            case SelectionStmtK:
+                unrollStmts(&t->child[1]);
+                unrollStmts(&t->child[2]);
+                break;
+            case IterationStmtK:
+                unrollStmts(&t->child[1]);
+                loc = unrollLoop(*head, loc);
+                break;
+            default:
+                break;
+        }
+    }
+}
+
+/* Procedure unrollLoops replaces each while loop
+ * of an analyzed program that runs a number of
+ * iterations known at compile time by copies of
+ * its body: all of them for a short loop, else a
+ * loop running UnrollFactor copies an iteration
+ * followed by the original loop for what remains.
+ * Loops are unrolled only while the code fits in
+ * a budget below the TM instruction memory, and
+ * not if an execution profile never saw them run
+ */
+void unrollLoops(TreeNode * syntaxTree)
+{
+    if (UnrollFactor <= 1)
+        return;
+    program = syntaxTree;
+    size = codeSize(syntaxTree);
+    if (size > CODE_BUDGET)
+        return;
+    for (TreeNode * t = syntaxTree; t != NULL; t = t->sibling)
+        if (t->kind.exp == FuncDeclK)
+            unrollStmts(&t->child[1]->child[1]);
+    free(map);
+    map = NULL;
+    nMap = maxMap = 0;
+}
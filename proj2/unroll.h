@@ -0,0 +1,23 @@
+/****************************************************/
+/* File: unroll.h                                   */
+/* Loop unrolling for the C-MINUS compiler          */
+/* Compiler Construction: Principles and Practice   */
+/* Kenneth C. Louden                                */
+/****************************************************/
+
+#ifndef _UNROLL_H_
+#define _UNROLL_H_
+
+/* Procedure unrollLoops replaces each while loop
+ * of an analyzed program that runs a number of
+ * iterations known at compile time by copies of
+ * its body: all of them for a short loop, else a
+ * loop running UnrollFactor copies an iteration
+ * followed by the original loop for what remains.
+ * Loops are unrolled only while the code fits in
+ * a budget below the TM instruction memory, and
+ * not if an execution profile never saw them run
+ */
+void unrollLoops(TreeNode * syntaxTree);
+
+#endif
@@ -119,6 +119,17 @@ TreeNode * newStmtNode(StmtKind kind)
             t->child[i] = NULL;
         t->sibling = NULL;
         t->lineno = lineno;
+        t->site = 0;
+        t->type = Void;
+        t->isParam = FALSE;
+        t->size = 0;
+        t->decl = NULL;
+        t->bind.storage = UnboundK;
+        t->bind.offset = 0;
+        t->bind.isArray = FALSE;
+        t->bind.frame = 0;
+        t->ir = NULL;
+        t->init = NULL;
     }
     return t;
 }
@@ -141,8 +152,17 @@ TreeNode * newExpNode(ExpKind kind)
             t->child[i] = NULL;
         t->sibling = NULL;
         t->lineno = lineno;
+        t->site = 0;
         t->type = Void;
         t->isParam = FALSE;
+        t->size = 0;
+        t->decl = NULL;
+        t->bind.storage = UnboundK;
+        t->bind.offset = 0;
+        t->bind.isArray = FALSE;
+        t->bind.frame = 0;
+        t->ir = NULL;
+        t->init = NULL;
     }
     return t;
 }
@@ -164,6 +184,201 @@ char * copyString(char * s)
     return t;
 }
 
+/* Function newTemp declares a compiler temp, a
+ * scalar local of function func named $1, $2, ...
+ * in frame slot slot, and returns its declaration
+ */
+TreeNode * newTemp(TreeNode * func, int slot)
+{
+    TreeNode * body = func->child[1];
+    TreeNode * t = newExpNode(VarDeclK);
+    TreeNode ** last = &body->child[0];
+    int n = 1;
+    char name[16];
+    /* temps follow the declarations of the body */
+    while (*last != NULL){
+        if ((*last)->attr.name[0] == '$')
+            n++;
+        last = &(*last)->sibling;
+    }
+    sprintf(name, "$%d", n);
+    t->attr.name = copyString(name);
+    t->type = Integer;
+    t->bind.storage = LocalK;
+    t->bind.offset = -slot;
+    *last = t;
+    return t;
+}
+
+/* Function newTempId creates an identifier
+ * naming temp at line lineno
+ */
+TreeNode * newTempId(TreeNode * temp, int lineno)
+{
+    TreeNode * id = newExpNode(IdK);
+    id->attr.name = copyString(temp->attr.name);
+    id->lineno = lineno;
+    id->type = Integer;
+    id->decl = temp;
+    id->bind = temp->bind;
+    return id;
+}
+
+/* Function newName creates an identifier with
+ * the name, declaration and binding of id, not
+ * indexed, at line lineno
+ */
+TreeNode * newName(TreeNode * id, int lineno)
+{
+    TreeNode * t = newExpNode(IdK);
+    t->attr.name = copyString(id->attr.name);
+    t->lineno = lineno;
+    t->type = id->bind.isArray ? IntegerArray : id->type;
+    t->decl = id->decl;
+    t->bind = id->bind;
+    return t;
+}
+
+/* Function newConst creates the constant val
+ * at line lineno
+ */
+TreeNode * newConst(int val, int lineno)
+{
+    TreeNode * t = newExpNode(ConstK);
+    t->attr.val = val;
+    t->lineno = lineno;
+    t->type = Integer;
+    return t;
+}
+
+/* Function newAssign creates the assignment
+ * lhs = rhs at the line of rhs
+ */
+TreeNode * newAssign(TreeNode * lhs, TreeNode * rhs)
+{
+    TreeNode * t = newExpNode(AssignK);
+    t->lineno = rhs->lineno;
+    t->type = Integer;
+    t->child[0] = lhs;
+    t->child[1] = rhs;
+    return t;
+}
+
+/* Function isConst tells whether t is a constant */
+int isConst(TreeNode * t)
+{
+    return t != NULL && t->nodekind == ExpK && t->kind.exp == ConstK;
+}
+
+/* Function isAssign tells whether t is an
+ * assignment
+ */
+int isAssign(TreeNode * t)
+{
+    return t != NULL && t->nodekind == ExpK && t->kind.exp == AssignK;
+}
+
+/* Function isStmt tells whether t is a statement
+ * of kind kind
+ */
+int isStmt(TreeNode * t, StmtKind kind)
+{
+    return t != NULL && t->nodekind == StmtK && t->kind.stmt == kind;
+}
+
+/* Function isScalar tells whether t names the
+ * scalar variable decl
+ */
+int isScalar(TreeNode * t, TreeNode * decl)
+{
+    return t != NULL && t->nodekind == ExpK && t->kind.exp == IdK &&
+        !t->bind.isArray && t->decl == decl;
+}
+
+/* Function assigns tells whether a tree or its
+ * siblings assign to variable decl
+ */
+int assigns(TreeNode * t, TreeNode * decl)
+{
+    for (; t != NULL; t = t->sibling){
+        if (isAssign(t) && t->child[0]->decl == decl)
+            return TRUE;
+        for (int i = 0; i < MAXCHILDREN; i++)
+            if (assigns(t->child[i], decl))
+                return TRUE;
+    }
+    return FALSE;
+}
+
+/* Function copyTree makes a copy of a syntax
+ * tree and its siblings that shares the
+ * declarations of the original
+ */
+TreeNode * copyTree(TreeNode * tree)
+{
+    TreeNode * head = NULL, ** last = &head;
+    for (; tree != NULL; tree = tree->sibling){
+        TreeNode * t = (TreeNode *)malloc(sizeof(TreeNode));
+        if (t == NULL){
+            fprintf(listing, "Out of memory error at line %d\n", lineno);
+            exit(-1);
+        }
+        *t = *tree;
+        t->sibling = NULL;
+        t->ir = NULL;
+        t->init = NULL;
+        for (int i = 0; i < MAXCHILDREN; i++)
+            t->child[i] = copyTree(tree->child[i]);
+        if (t->nodekind == StmtK && t->kind.stmt == CallK)
+            t->attr.name = copyString(tree->attr.name);
+        else if (t->nodekind == ExpK){
+            switch (t->kind.exp) {
+                case VarDeclK:
+                case ArrayDeclK:
+                case FuncDeclK:
+                case IdK:
+                    t->attr.name = copyString(tree->attr.name);
+                    break;
+                default:
+                    break;
+            }
+        }
+        *last = t;
+        last = &t->sibling;
+    }
+    return head;
+}
+
+/* Procedure freeTree releases a syntax tree,
+ * its siblings and the names and initial words
+ * it owns
+ */
+void freeTree(TreeNode * tree)
+{
+    while (tree != NULL){
+        TreeNode * next = tree->sibling;
+        for (int i = 0; i < MAXCHILDREN; i++)
+            freeTree(tree->child[i]);
+        if (tree->nodekind == StmtK && tree->kind.stmt == CallK)
+            free(tree->attr.name);
+        else if (tree->nodekind == ExpK){
+            switch (tree->kind.exp) {
+                case VarDeclK:
+                case ArrayDeclK:
+                case FuncDeclK:
+                case IdK:
+                    free(tree->attr.name);
+                    break;
+                default:
+                    break;
+            }
+        }
+        free(tree->init);
+        free(tree);
+        tree = next;
+    }
+}
+
 /* Variable indentno is used by printTree to
  * store current number of spaces to indent
  */
@@ -243,6 +458,8 @@ void printTree(TreeNode * tree)
                                 case Void:
                                     fprintf(listing, "Type : void\n");
                                     break;
+                                default:
+                                    break;
                             }
                         }
                     }
@@ -256,6 +473,8 @@ void printTree(TreeNode * tree)
                             case Void:
                                 fprintf(listing, "Type : void\n");
                                 break;
+                            default:
+                                break;
                         }
                     }
                     break;
@@ -270,6 +489,8 @@ void printTree(TreeNode * tree)
                             case Void:
                                 fprintf(listing, "Type : void\n");
                                 break;
+                            default:
+                                break;
                         }
                     }
                     else{
@@ -282,6 +503,8 @@ void printTree(TreeNode * tree)
                             case Void:
                                 fprintf(listing, "Type : void\n");
                                 break;
+                            default:
+                                break;
                         }
                         printSpaces();
                         fprintf(listing,"Size : %d\n", tree->size);
@@ -297,6 +520,8 @@ void printTree(TreeNode * tree)
                         case Void:
                             fprintf(listing, "Type : void\n");
                             break;
+                        default:
+                            break;
                     }
                     break;
                 case AssignK:
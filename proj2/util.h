@@ -28,6 +28,67 @@ TreeNode * newExpNode(ExpKind);
  */
 char * copyString( char * );
 
+/* Function newTemp declares a compiler temp, a
+ * scalar local of function func named $1, $2, ...
+ * in frame slot slot, and returns its declaration
+ */
+TreeNode * newTemp( TreeNode * func, int slot );
+
+/* Function newTempId creates an identifier
+ * naming temp at line lineno
+ */
+TreeNode * newTempId( TreeNode * temp, int lineno );
+
+/* Function newName creates an identifier with
+ * the name, declaration and binding of id, not
+ * indexed, at line lineno
+ */
+TreeNode * newName( TreeNode * id, int lineno );
+
+/* Function newConst creates the constant val
+ * at line lineno
+ */
+TreeNode * newConst( int val, int lineno );
+
+/* Function newAssign creates the assignment
+ * lhs = rhs at the line of rhs
+ */
+TreeNode * newAssign( TreeNode * lhs, TreeNode * rhs );
+
+/* Function isConst tells whether t is a constant */
+int isConst( TreeNode * t );
+
+/* Function isAssign tells whether t is an
+ * assignment
+ */
+int isAssign( TreeNode * t );
+
+/* Function isStmt tells whether t is a statement
+ * of kind kind
+ */
+int isStmt( TreeNode * t, StmtKind kind );
+
+/* Function isScalar tells whether t names the
+ * scalar variable decl
+ */
+int isScalar( TreeNode * t, TreeNode * decl );
+
+/* Function assigns tells whether a tree or its
+ * siblings assign to variable decl
+ */
+int assigns( TreeNode * t, TreeNode * decl );
+
+/* Function copyTree makes a copy of a syntax
+ * tree and its siblings that shares the
+ * declarations of the original
+ */
+TreeNode * copyTree( TreeNode * );
+
+/* Procedure freeTree releases a syntax tree,
+ * its siblings and the names it owns
+ */
+void freeTree( TreeNode * );
+
 /* procedure printTree prints a syntax tree to the 
  * listing file using indentation to indicate subtrees
  */
@@ -0,0 +1,329 @@
+/****************************************************/
+/* File: vector.c                                   */
+/* Loop vectorization for the C-MINUS compiler      */
+/* A vector loop tests a local i by i < n, n > i,   */
+/* or i <= n or n >= i for a constant n, where n is */
+/* a constant or a scalar the loop does not assign, */
+/* and its body is statements setting c[i] to       */
+/* a[i] op b[i], to a[i], to a constant or scalar   */
+/* v, or to i + k, followed by the step i = i + 1.  */
+/* Every element read or written is element i of an */
+/* array, and two arrays are one or do not overlap, */
+/* so an iteration only depends on what earlier     */
+/* statements of it computed: running each          */
+/* statement for all iterations in turn gives the   */
+/* same result. The loop becomes                    */
+/*   if (i < n) { OP(c, a, b, i, n); ...; i = n; }  */
+/* where OP, a TM vector op, sets c[k] to           */
+/* a[k] op b[k] for i <= k < n; MCPY(c, a, i, n),   */
+/* MSET(c, v, i, n) and MIOTA(c, i + k, i, n) copy  */
+/* a, fill with v and count up from i + k. As they  */
+/* take any number of elements, no scalar loop is   */
+/* left over                                        */
+/* Compiler Construction: Principles and Practice   */
+/* Kenneth C. Louden                                */
+/****************************************************/
+
+#include "globals.h"
+#include <limits.h>
+#include "util.h"
+#include "vector.h"
+
+/* the vector ops: one computing an operator
+ * element by element, where a > or >= is a < or
+ * <= with its operands swapped, or one copying,
+ * filling or counting
+ */
+typedef enum { ElementOp, CopyOp, FillOp, IotaOp } OpKind;
+
+typedef struct
+{
+    OpKind kind;
+    TokenType op;
+    char * name;
+    int swap;
+} VectorOp;
+
+static VectorOp vectorOps[] =
+{
+    { ElementOp, PLUS, "VADD", FALSE },
+    { ElementOp, MINUS, "VSUB", FALSE },
+    { ElementOp, TIMES, "VMUL", FALSE },
+    { ElementOp, LT, "VLT", FALSE },
+    { ElementOp, LE, "VLE", FALSE },
+    { ElementOp, GT, "VLT", TRUE },
+    { ElementOp, GE, "VLE", TRUE },
+    { ElementOp, EQ, "VEQ", FALSE },
+    { ElementOp, NE, "VNE", FALSE },
+    { CopyOp, ERROR, "MCPY", FALSE },
+    { FillOp, ERROR, "MSET", FALSE },
+    { IotaOp, ERROR, "MIOTA", FALSE }
+};
+#define NOPS ((int)(sizeof(vectorOps) / sizeof(vectorOps[0])))
+
+/* the declarations of the vector ops, made when
+ * first called; they live as long as the compiler.
+ * Their parameters are the arrays and values they
+ * work on, then the first and the end of the range
+ * of elements
+ */
+static TreeNode * decls[NOPS];
+static int nDecls = 0;
+
+static TreeNode * newParam(ExpKind kind, char * name)
+{
+    TreeNode * t = newExpNode(kind);
+    t->attr.name = copyString(name);
+    t->type = (kind == ArrayDeclK) ? IntegerArray : Integer;
+    t->isParam = TRUE;
+    return t;
+}
+
+static TreeNode * vectorDecl(VectorOp * v)
+{
+    static char * names[] = { "c", "a", "b" };
+    TreeNode * t, ** p;
+    int operands = (v->kind == ElementOp) ? 3 : 2;
+    int value = (v->kind == FillOp || v->kind == IotaOp);
+    for (int i = 0; i < nDecls; i++)
+        if (strcmp(decls[i]->attr.name, v->name) == 0)
+            return decls[i];
+    t = newExpNode(FuncDeclK);
+    t->attr.name = copyString(v->name);
+    t->type = Void;
+    t->lineno = 0;
+    t->bind.storage = VectorK;
+    p = &t->child[0];
+    for (int i = 0; i < operands; i++){
+        *p = newParam((i == 1 && value) ? VarDeclK : ArrayDeclK, names[i]);
+        p = &(*p)->sibling;
+    }
+    *p = newParam(VarDeclK, "first");
+    (*p)->sibling = newParam(VarDeclK, "end");
+    decls[nDecls++] = t;
+    return t;
+}
+
+/* Function isElement tells whether t is element
+ * i of an array, for variable decl
+ */
+static int isElement(TreeNode * t, TreeNode * decl)
+{
+    return t != NULL && t->nodekind == ExpK && t->kind.exp == IdK &&
+        t->bind.isArray && isScalar(t->child[0], decl) && t->child[0]->child[0] == NULL;
+}
+
+/* Function isStep tells whether statement t is
+ * i = i + 1 or i = 1 + i for variable decl
+ */
+static int isStep(TreeNode * t, TreeNode * decl)
+{
+    TreeNode * rhs, * l, * r;
+    if (!isAssign(t) || !isScalar(t->child[0], decl))
+        return FALSE;
+    rhs = t->child[1];
+    if (rhs->nodekind != StmtK || rhs->kind.stmt != AdditiveStmtK ||
+        rhs->child[1]->attr.op != PLUS)
+        return FALSE;
+    l = rhs->child[0];
+    r = rhs->child[2];
+    return (isScalar(l, decl) && isConst(r) && r->attr.val == 1) ||
+        (isConst(l) && l->attr.val == 1 && isScalar(r, decl));
+}
+
+/* Function isIota tells whether t is i, i + k,
+ * k + i or i - k for a constant k and variable
+ * decl
+ */
+static int isIota(TreeNode * t, TreeNode * decl)
+{
+    TreeNode * l, * r;
+    if (isScalar(t, decl))
+        return TRUE;
+    if (t->nodekind != StmtK || t->kind.stmt != AdditiveStmtK)
+        return FALSE;
+    l = t->child[0];
+    r = t->child[2];
+    if (t->child[1]->attr.op == PLUS)
+        return (isScalar(l, decl) && isConst(r)) || (isConst(l) && isScalar(r, decl));
+    return isScalar(l, decl) && isConst(r);
+}
+
+static VectorOp * findOp(OpKind kind, TokenType op)
+{
+    for (int i = 0; i < NOPS; i++)
+        if (vectorOps[i].kind == kind && (kind != ElementOp || vectorOps[i].op == op))
+            return &vectorOps[i];
+    return NULL;
+}
+
+/* Function vectorOp returns the vector op doing
+ * statement t for all iterations of the loop over
+ * variable decl, or NULL if there is none
+ */
+static VectorOp * vectorOp(TreeNode * t, TreeNode * decl)
+{
+    TreeNode * rhs;
+    if (!isAssign(t) || !isElement(t->child[0], decl))
+        return NULL;
+    rhs = t->child[1];
+    if (isElement(rhs, decl))
+        return findOp(CopyOp, ERROR);
+    /* the body assigns no scalar but i */
+    if (isConst(rhs) || (rhs->nodekind == ExpK && rhs->kind.exp == IdK &&
+                         !rhs->bind.isArray && rhs->decl != decl))
+        return findOp(FillOp, ERROR);
+    if (isIota(rhs, decl))
+        return findOp(IotaOp, ERROR);
+    if (rhs->nodekind != StmtK ||
+        (rhs->kind.stmt != SimpleStmtK && rhs->kind.stmt != AdditiveStmtK &&
+         rhs->kind.stmt != TermK) ||
+        !isElement(rhs->child[0], decl) || !isElement(rhs->child[2], decl))
+        return NULL;
+    return findOp(ElementOp, rhs->child[1]->attr.op);
+}
+
+/* Function newVectorCall creates the call of
+ * vector op v doing statement t for i from id up
+ * to (not including) end. A value filled with or
+ * counted up from is read as it is before the
+ * first iteration
+ */
+static TreeNode * newVectorCall(VectorOp * v, TreeNode * t, TreeNode * id, TreeNode * end)
+{
+    TreeNode * rhs = t->child[1];
+    TreeNode * call = newStmtNode(CallK), * arg;
+    call->attr.name = copyString(v->name);
+    call->lineno = t->lineno;
+    call->type = Void;
+    call->decl = vectorDecl(v);
+    arg = call->child[0] = newName(t->child[0], t->lineno);
+    switch (v->kind){
+        case ElementOp:
+            arg = arg->sibling = newName(rhs->child[v->swap ? 2 : 0], t->lineno);
+            arg = arg->sibling = newName(rhs->child[v->swap ? 0 : 2], t->lineno);
+            break;
+        case CopyOp:
+            arg = arg->sibling = newName(rhs, t->lineno);
+            break;
+        default:
+            arg = arg->sibling = copyTree(rhs);
+            break;
+    }
+    arg = arg->sibling = newName(id, t->lineno);
+    arg->sibling = end;
+    return call;
+}
+
+/* Function vectorizeLoop returns the statement
+ * replacing loop, or NULL if it is no vector loop
+ */
+static TreeNode * vectorizeLoop(TreeNode * loop)
+{
+    TreeNode * test = loop->child[0], * body = loop->child[1];
+    TreeNode * id, * bound, * decl, * t, * s, * stmts = NULL, * last = NULL;
+    TokenType op;
+    if (test->nodekind != StmtK || test->kind.stmt != SimpleStmtK ||
+        body->nodekind != StmtK || body->kind.stmt != CompoundStmtK ||
+        body->child[0] != NULL || body->child[1] == NULL)
+        return NULL;
+    op = test->child[1]->attr.op;
+    if (op == LT || op == LE){
+        id = test->child[0];
+        bound = test->child[2];
+    }
+    else if (op == GT || op == GE){
+        id = test->child[2];
+        bound = test->child[0];
+        op = (op == GT) ? LT : LE;
+    }
+    else
+        return NULL;
+    if (id->nodekind != ExpK || id->kind.exp != IdK || id->bind.isArray ||
+        (id->bind.storage != LocalK && id->bind.storage != ParamK))
+        return NULL;
+    decl = id->decl;
+    /* the body assigns no scalar but i, so n stays */
+    if (isConst(bound)){
+        if (op == LE && bound->attr.val == INT_MAX)
+            return NULL;
+    }
+    else if (op == LE || bound->nodekind != ExpK || bound->kind.exp != IdK ||
+             bound->bind.isArray || bound->decl == decl)
+        return NULL;
+    for (t = body->child[1]; t->sibling != NULL; t = t->sibling)
+        if (vectorOp(t, decl) == NULL)
+            return NULL;
+    if (t == body->child[1] || !isStep(t, decl))
+        return NULL;
+    for (t = body->child[1]; t->sibling != NULL; t = t->sibling){
+        TreeNode * end = isConst(bound) ? newConst(bound->attr.val + (op == LE), t->lineno)
+            : copyTree(bound);
+        s = newVectorCall(vectorOp(t, decl), t, id, end);
+        if (stmts == NULL)
+            stmts = s;
+        else
+            last->sibling = s;
+        last = s;
+    }
+    last->sibling = newAssign(newName(id, t->lineno), isConst(bound) ?
+        newConst(bound->attr.val + (op == LE), t->lineno) : copyTree(bound));
+    s = newStmtNode(CompoundStmtK);
+    s->lineno = body->lineno;
+    s->child[1] = stmts;
+    t = newStmtNode(SelectionStmtK);
+    t->lineno = loop->lineno;
+    t->child[0] = test;
+    t->child[1] = s;
+    loop->child[0] = NULL;
+    return t;
+}
+
+/* Procedure vectorizeStmts vectorizes the loops
+ * of a list of statements, inner loops first
+ */
+static void vectorizeStmts(TreeNode ** head)
+{
+    for (TreeNode ** loc = head; *loc != NULL; loc = &(*loc)->sibling){
+        TreeNode * t = *loc, * v;
+        if (t->nodekind != StmtK)
+            continue;
+        switch (t->kind.stmt){
+            case CompoundStmtK:
+                vectorizeStmts(&t->child[1]);
+                break;
+            case SelectionStmtK:
+                vectorizeStmts(&t->child[1]);
+                vectorizeStmts(&t->child[2]);
+                break;
+            case IterationStmtK:
+                vectorizeStmts(&t->child[1]);
+                if ((v = vectorizeLoop(t)) != NULL){
+                    v->sibling = t->sibling;
+                    t->sibling = NULL;
+                    freeTree(t);
+                    *loc = v;
+                }
+                break;
+            default:
+                break;
+        }
+    }
+}
+
+/* Procedure vectorizeLoops replaces each while
+ * loop of an analyzed program that steps a local
+ * i by one up to a bound it does not change, and
+ * whose body only sets elements c[i] to a[i] op
+ * b[i] for an arithmetic or relational op other
+ * than division, to a[i], to a value the loop
+ * does not change or to i + k, by the TM vector
+ * and block memory ops doing the same for all of
+ * its iterations at once
+ */
+void vectorizeLoops(TreeNode * syntaxTree)
+{
+    for (TreeNode * t = syntaxTree; t != NULL; t = t->sibling)
+        if (t->kind.exp == FuncDeclK && t->child[1] != NULL)
+            vectorizeStmts(&t->child[1]->child[1]);
+}
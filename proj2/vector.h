@@ -0,0 +1,23 @@
+/****************************************************/
+/* File: vector.h                                   */
+/* Loop vectorization for the C-MINUS compiler      */
+/* Compiler Construction: Principles and Practice   */
+/* Kenneth C. Louden                                */
+/****************************************************/
+
+#ifndef _VECTOR_H_
+#define _VECTOR_H_
+
+/* Procedure vectorizeLoops replaces each while
+ * loop of an analyzed program that steps a local
+ * i by one up to a bound it does not change, and
+ * whose body only sets elements c[i] to a[i] op
+ * b[i] for an arithmetic or relational op other
+ * than division, to a[i], to a value the loop
+ * does not change or to i + k, by the TM vector
+ * and block memory ops doing the same for all of
+ * its iterations at once
+ */
+void vectorizeLoops(TreeNode * syntaxTree);
+
+#endif